@@ -1,4 +1,10 @@
 #pragma once
+
+#ifdef CYD_HOST
+// Native build: render into memory instead of the ILI9341
+#include "host/host_panel.h"
+#else
+
 #include <LovyanGFX.hpp>
 
 class LGFX : public lgfx::LGFX_Device {
@@ -65,3 +71,5 @@ public:
     setPanel(&_panel_instance);
   }
 };
+
+#endif  // CYD_HOST
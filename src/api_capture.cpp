@@ -0,0 +1,264 @@
+#include "api_capture.h"
+#include <esp_rom_crc.h>
+#include <freertos/task.h>
+
+#define CAPTURE_MAGIC    0x31435041u   // "APC1"
+#define CAPTURE_VERSION  1             // Bump on any layout change
+#define CAPTURE_REPEAT   0x01          // Body identical to the endpoint's previous one
+
+struct CaptureHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t endpoints;   // API_ENDPOINT_COUNT when recorded: indices must match
+    uint8_t reserved;
+};
+
+// Followed by `length` body bytes. Only 200 answers carry a body.
+struct __attribute__((packed)) CaptureRecord {
+    uint32_t atMs;       // Request start, from the start of the capture
+    uint16_t tookMs;
+    int16_t code;        // HTTP status or HTTPC_ERROR_*
+    uint8_t endpoint;
+    uint8_t flags;
+    uint32_t length;
+};
+
+// ── Recording ──────────────────────────────────────────────────────────
+
+void ApiCapture::begin(APIClient& api) {
+    _lock = xSemaphoreCreateMutex();
+    api.setCapture(this);
+
+    if (SPIFFS.exists(REPLAY_FILE) && _replay.begin(SPIFFS, REPLAY_FILE)) {
+        api.setTransport(&_replay);
+        _replaying = true;
+        Serial.printf("Replaying %u recorded API answers\n",
+                      (unsigned)_replay.getRecords());
+    }
+}
+
+bool ApiCapture::start() {
+    if (!_lock || _replaying) return false;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    closeFile();
+    _file = SPIFFS.open(CAPTURE_FILE, "w");
+    CaptureHeader hdr = { CAPTURE_MAGIC, CAPTURE_VERSION, API_ENDPOINT_COUNT, 0 };
+    bool ok = _file && _file.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+    if (ok) {
+        _file.flush();
+        _active = true;
+        _full = false;
+        _records = 0;
+        _bytes = sizeof(hdr);
+        _startMs = millis();
+        memset(_hasLast, 0, sizeof(_hasLast));
+    } else {
+        closeFile();
+    }
+    xSemaphoreGive(_lock);
+
+    Serial.println(ok ? "API capture started" : "API capture: cannot write " CAPTURE_FILE);
+    return ok;
+}
+
+void ApiCapture::stop() {
+    if (!_lock) return;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    bool was = _active;
+    closeFile();
+    xSemaphoreGive(_lock);
+    if (was) Serial.printf("API capture stopped: %u answers, %u bytes\n", _records, _bytes);
+}
+
+// Caller holds _lock
+void ApiCapture::closeFile() {
+    if (_file) _file.close();
+    _active = false;
+}
+
+CaptureStatus ApiCapture::getStatus() const {
+    CaptureStatus st = {};
+    if (!_lock) return st;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    st.active = _active;
+    st.full = _full;
+    st.records = _records;
+    st.bytes = _bytes;
+    xSemaphoreGive(_lock);
+    st.replaying = _replaying;
+    st.replayDone = _replay.isDone();
+    return st;
+}
+
+bool ApiCapture::armReplay() {
+    if (!_lock) return false;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    closeFile();
+    bool ok = SPIFFS.exists(CAPTURE_FILE);
+    if (ok) {
+        SPIFFS.remove(REPLAY_FILE);
+        ok = SPIFFS.rename(CAPTURE_FILE, REPLAY_FILE);
+    }
+    xSemaphoreGive(_lock);
+    return ok;
+}
+
+void ApiCapture::disarmReplay() {
+    if (!_lock) return;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    SPIFFS.remove(REPLAY_FILE);
+    xSemaphoreGive(_lock);
+}
+
+void ApiCapture::record(ApiEndpoint endpoint, unsigned long startMs, uint32_t tookMs,
+                        int code, const String& body) {
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (!_active) {
+        xSemaphoreGive(_lock);
+        return;
+    }
+
+    CaptureRecord rec;
+    rec.atMs = startMs - _startMs;
+    rec.tookMs = (uint16_t)min(tookMs, (uint32_t)UINT16_MAX);
+    rec.code = (int16_t)code;
+    rec.endpoint = endpoint;
+    rec.flags = 0;
+    rec.length = body.length();
+
+    // Most polls return what the last one did: keep the body once
+    uint32_t crc = 0;
+    if (code == HTTP_CODE_OK) {
+        crc = esp_rom_crc32_le(0, (const uint8_t*)body.c_str(), rec.length);
+        if (sameAsLast(endpoint, body, crc)) {
+            rec.flags = CAPTURE_REPEAT;
+            rec.length = 0;
+        }
+    }
+    uint32_t bodyAt = _bytes + sizeof(rec);
+
+    bool ok = _bytes + sizeof(rec) + rec.length <= CAPTURE_MAX_BYTES &&
+              _file.write((const uint8_t*)&rec, sizeof(rec)) == sizeof(rec) &&
+              _file.write((const uint8_t*)body.c_str(), rec.length) == rec.length;
+    if (ok) {
+        // Flushed per record, so a download or a power cut loses nothing
+        _file.flush();
+        _records++;
+        _bytes += sizeof(rec) + rec.length;
+        if (code == HTTP_CODE_OK && !(rec.flags & CAPTURE_REPEAT)) {
+            _lastCrc[endpoint] = crc;
+            _lastAt[endpoint] = bodyAt;
+            _lastLength[endpoint] = rec.length;
+            _hasLast[endpoint] = true;
+        }
+    } else {
+        // A record cut short is dropped by the replay
+        _full = true;
+        closeFile();
+    }
+    xSemaphoreGive(_lock);
+
+    if (!ok) Serial.printf("API capture full: %u answers, %u bytes\n", _records, _bytes);
+}
+
+// Caller holds _lock. The CRC only rules bodies out; a candidate is
+// compared with the stored one so a replay gets exactly the bytes sent.
+bool ApiCapture::sameAsLast(ApiEndpoint endpoint, const String& body, uint32_t crc) {
+    if (!_hasLast[endpoint] || _lastCrc[endpoint] != crc ||
+        _lastLength[endpoint] != body.length()) {
+        return false;
+    }
+
+    File f = SPIFFS.open(CAPTURE_FILE, "r");
+    if (!f || !f.seek(_lastAt[endpoint])) return false;
+    const char* p = body.c_str();
+    uint32_t left = body.length();
+    uint8_t buf[256];
+    while (left > 0) {
+        size_t n = f.read(buf, min((size_t)left, sizeof(buf)));
+        if (n == 0 || memcmp(buf, p, n) != 0) return false;
+        p += n;
+        left -= n;
+    }
+    return true;
+}
+
+// ── Replay ─────────────────────────────────────────────────────────────
+
+bool ReplayTransport::begin(fs::FS& fs, const char* path) {
+    _file = fs.open(path, "r");
+    if (!_file) return false;
+
+    CaptureHeader hdr;
+    if (_file.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr) ||
+        hdr.magic != CAPTURE_MAGIC || hdr.version != CAPTURE_VERSION ||
+        hdr.endpoints != API_ENDPOINT_COUNT) {
+        Serial.printf("Replay: %s is not a capture from this firmware\n", path);
+        _file.close();
+        return false;
+    }
+
+    // Index the records; bodies stay in the file
+    uint32_t size = _file.size();
+    uint32_t pos = sizeof(hdr);
+    uint32_t lastAt[API_ENDPOINT_COUNT] = {};
+    uint32_t lastLength[API_ENDPOINT_COUNT] = {};
+    CaptureRecord rec;
+    while (pos + sizeof(rec) <= size) {
+        _file.seek(pos);
+        if (_file.read((uint8_t*)&rec, sizeof(rec)) != sizeof(rec)) break;
+        uint32_t bodyAt = pos + sizeof(rec);
+        if (rec.endpoint >= API_ENDPOINT_COUNT || bodyAt + rec.length > size) break;
+
+        Entry e = { rec.atMs, rec.tookMs, rec.code, rec.endpoint, bodyAt, rec.length };
+        if (rec.flags & CAPTURE_REPEAT) {
+            e.bodyAt = lastAt[rec.endpoint];
+            e.length = lastLength[rec.endpoint];
+        } else if (rec.code == HTTP_CODE_OK) {
+            lastAt[rec.endpoint] = bodyAt;
+            lastLength[rec.endpoint] = rec.length;
+        }
+        _entries.push_back(e);
+        pos = bodyAt + rec.length;
+    }
+
+    if (_entries.empty()) _file.close();
+    return !_entries.empty();
+}
+
+int ReplayTransport::get(ApiEndpoint endpoint, const String&, const String&,
+                         uint16_t, String& body) {
+    size_t& i = _next[endpoint];
+    while (i < _entries.size() && _entries[i].endpoint != endpoint) i++;
+    if (i >= _entries.size()) {
+        if (!_done) Serial.println("Replay: capture used up, requests now fail");
+        _done = true;
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    const Entry& e = _entries[i++];
+
+    // The recording's clock starts at this replay's first request; an
+    // answer is never early, and takes as long as it took then
+    if (!_started) {
+        _startMs = millis() - e.atMs;
+        _started = true;
+    }
+    long wait = (long)(_startMs + e.atMs - millis());
+    if (wait > 0) vTaskDelay(pdMS_TO_TICKS(wait));
+    if (e.tookMs) vTaskDelay(pdMS_TO_TICKS(e.tookMs));
+
+    if (e.code == HTTP_CODE_OK && e.length > 0) {
+        body.reserve(e.length);
+        _file.seek(e.bodyAt);
+        char buf[256];
+        uint32_t left = e.length;
+        while (left > 0) {
+            size_t n = _file.read((uint8_t*)buf, min((size_t)left, sizeof(buf)));
+            if (n == 0) break;
+            body.concat(buf, n);
+            left -= n;
+        }
+    }
+    return e.code;
+}
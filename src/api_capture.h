@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <vector>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "api_client.h"
+
+#define CAPTURE_FILE       "/capture.bin"   // Being recorded, downloadable
+#define REPLAY_FILE        "/replay.bin"    // Replayed instead of HTTP at boot
+#define CAPTURE_MAX_BYTES  65536            // Leaves room for the web UI files
+
+// Replays a capture in place of the server. Each request gets the next
+// recorded answer for its endpoint — status, body and time taken — no
+// sooner than it came in the original run, counted from the first
+// request. Once the capture is used up every request is refused.
+class ReplayTransport : public ApiTransport {
+public:
+    bool begin(fs::FS& fs, const char* path);
+
+    int get(ApiEndpoint endpoint, const String& url, const String& apiKey,
+            uint16_t timeoutMs, String& body) override;
+
+    bool isDone() const { return _done; }
+    size_t getRecords() const { return _entries.size(); }
+
+private:
+    struct Entry {
+        uint32_t atMs;
+        uint16_t tookMs;
+        int16_t code;
+        uint8_t endpoint;
+        uint32_t bodyAt;     // File offset of the body (an earlier one for repeats)
+        uint32_t length;
+    };
+
+    File _file;
+    std::vector<Entry> _entries;
+    size_t _next[API_ENDPOINT_COUNT] = {};
+    unsigned long _startMs = 0;
+    bool _started = false;
+    volatile bool _done = false;
+};
+
+struct CaptureStatus {
+    bool active;
+    bool full;           // Stopped at CAPTURE_MAX_BYTES or a full partition
+    uint32_t records;
+    uint32_t bytes;
+    bool replaying;      // This boot answers from REPLAY_FILE
+    bool replayDone;
+};
+
+// Records every API answer the poll task gets to CAPTURE_FILE in SPIFFS:
+// compact binary records, appended and flushed one at a time, with the
+// request time so a replay keeps the original timing. A body identical to
+// the endpoint's previous one, byte for byte, is stored as a repeat.
+//
+// At boot, a REPLAY_FILE left by armReplay() switches the API client to
+// replaying it; the web UI starts and stops both.
+class ApiCapture {
+public:
+    // Call after SPIFFS is mounted (the web server mounts it)
+    void begin(APIClient& api);
+
+    // Any task. start() begins a new capture, replacing the last one.
+    bool start();
+    void stop();
+    CaptureStatus getStatus() const;
+
+    // Make the current capture the one replayed from the next boot, or
+    // go back to the server. The caller reboots.
+    bool armReplay();
+    void disarmReplay();
+
+    // Poll task, after every attempt
+    void record(ApiEndpoint endpoint, unsigned long startMs, uint32_t tookMs,
+                int code, const String& body);
+
+private:
+    SemaphoreHandle_t _lock = nullptr;
+    File _file;
+    bool _active = false;
+    bool _full = false;
+    uint32_t _records = 0;
+    uint32_t _bytes = 0;
+    unsigned long _startMs = 0;
+    uint32_t _lastCrc[API_ENDPOINT_COUNT] = {};
+    uint32_t _lastAt[API_ENDPOINT_COUNT] = {};       // File offset of the body
+    uint32_t _lastLength[API_ENDPOINT_COUNT] = {};
+    bool _hasLast[API_ENDPOINT_COUNT] = {};
+
+    ReplayTransport _replay;
+    bool _replaying = false;
+
+    void closeFile();
+    bool sameAsLast(ApiEndpoint endpoint, const String& body, uint32_t crc);
+};
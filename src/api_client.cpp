@@ -1,45 +1,188 @@
 #include "api_client.h"
+#include "api_capture.h"
 #include <WiFi.h>
+#include <algorithm>
+
+#define RTT_MIN_SAMPLES   8       // Keep the default timeout until this many
+#define TIMEOUT_MIN_MS    800     // Floor: a good link still gets some slack
+#define TIMEOUT_MAX_MS    10000
+#define RETRY_BUDGET      3       // Extra attempts shared by one poll round
+
+struct EndpointInfo {
+    const char* name;
+    const char* path;
+};
+
+static const EndpointInfo ENDPOINTS[API_ENDPOINT_COUNT] = {
+    { "health",      "/api/v1/health" },
+    { "dashboard",   "/api/v1/dashboard" },
+    { "jobs",        "/api/v1/jobs/active" },
+    { "drives",      "/api/v1/drives" },
+    { "events",      "/api/v1/events" },
+    { "ltfs_format", "/api/v1/ltfs/format/status" },
+};
+
+void APIClient::begin() {
+    _lock = xSemaphoreCreateMutex();
+}
 
-void APIClient::begin(SettingsManager& settings) {
-    _settings = &settings;
+const char* APIClient::endpointName(int endpoint) {
+    return (endpoint >= 0 && endpoint < API_ENDPOINT_COUNT)
+           ? ENDPOINTS[endpoint].name : "";
 }
 
 String APIClient::buildURL(const String& path) {
-    String protocol = _settings->get().useHTTPS ? "https" : "http";
-    return protocol + "://" + _settings->get().serverHost + ":" +
-           String(_settings->get().serverPort) + path;
+    String protocol = _server.useHTTPS ? "https" : "http";
+    String host = _serverIP ? IPAddress(_serverIP).toString() : _server.host;
+    return protocol + "://" + host + ":" + String(_server.port) + path;
 }
 
-String APIClient::httpGet(const String& url) {
-    HTTPClient http;
-    http.begin(url);
-    http.addHeader("X-API-Key", _settings->get().apiKey);
-    http.addHeader("Accept", "application/json");
-    http.setTimeout(3000);
+void APIClient::beginPoll(const ServerConfig& server) {
+    _server = server;
+    _retryBudget = RETRY_BUDGET;
+}
 
-    int httpCode = http.GET();
+String APIClient::getLastError() const {
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    String error = _lastError;
+    xSemaphoreGive(_lock);
+    return error;
+}
+
+EndpointStats APIClient::getStats(int endpoint) const {
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    EndpointStats stats = _stats[endpoint];
+    xSemaphoreGive(_lock);
+    return stats;
+}
+
+void APIClient::setResult(bool connected, const String& error) {
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _connected = connected;
+    _lastError = error;
+    xSemaphoreGive(_lock);
+}
+
+String APIClient::httpGet(ApiEndpoint endpoint) {
+    EndpointStats& stats = _stats[endpoint];
+    unsigned long start = millis();
+    String url = buildURL(ENDPOINTS[endpoint].path);
+
+    int rssi = WiFi.RSSI();
+    if (rssi < 0) _rssi = _rssi ? (_rssi * 3 + rssi) / 4 : rssi;
+    updateTimeout();
+
+    int httpCode;
     String payload;
+    for (;;) {
+        unsigned long attemptStart = millis();
+        payload = "";
+        httpCode = _transport->get(endpoint, url, _server.apiKey, _timeoutMs, payload);
+        if (_capture) _capture->record(endpoint, attemptStart, millis() - attemptStart,
+                                       httpCode, payload);
+
+        if (httpCode == HTTP_CODE_OK) {
+            addRtt(millis() - attemptStart);
+            break;
+        }
+        // A timeout says the link is slower than we thought: count it as
+        // a sample so the next timeout is longer
+        if (httpCode == HTTPC_ERROR_READ_TIMEOUT) {
+            addRtt(_timeoutMs);
+            updateTimeout();
+        }
+        // Only transport errors (lost packets, resets) are worth a retry;
+        // the server answered anything else
+        if (httpCode > 0 || _retryBudget == 0) break;
+        _retryBudget--;
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        stats.retries++;
+        xSemaphoreGive(_lock);
+    }
 
+    _unanswered = httpCode < 0 ? _unanswered + 1 : 0;
     if (httpCode == HTTP_CODE_OK) {
-        payload = http.getString();
-        _connected = true;
-        _lastError = "";
+        setResult(true, "");
     } else if (httpCode > 0) {
-        _lastError = "HTTP " + String(httpCode);
-        _connected = false;
+        setResult(false, "HTTP " + String(httpCode));
     } else {
-        _lastError = http.errorToString(httpCode);
-        _connected = false;
+        setResult(false, HTTPClient::errorToString(httpCode));
     }
 
-    http.end();
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    stats.requests++;
+    stats.lastMs = millis() - start;
+    stats.totalMs += stats.lastMs;
+    if (httpCode != HTTP_CODE_OK) stats.errors++;
+    xSemaphoreGive(_lock);
     return payload;
 }
 
+int HttpTransport::get(ApiEndpoint, const String& url, const String& apiKey,
+                       uint16_t timeoutMs, String& body) {
+    HTTPClient http;
+    http.begin(url);
+    http.addHeader("X-API-Key", apiKey);
+    http.addHeader("Accept", "application/json");
+    http.setConnectTimeout(timeoutMs);
+    http.setTimeout(timeoutMs);
+
+    int httpCode = http.GET();
+    if (httpCode == HTTP_CODE_OK) body = http.getString();
+    http.end();
+    return httpCode;
+}
+
+void APIClient::addRtt(unsigned long ms) {
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _rtt[_rttNext] = (uint16_t)min(ms, 65535UL);
+    _rttNext = (_rttNext + 1) % API_RTT_SAMPLES;
+    if (_rttCount < API_RTT_SAMPLES) _rttCount++;
+    xSemaphoreGive(_lock);
+}
+
+uint16_t APIClient::getRttP99Ms() const {
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    uint16_t p99 = rttP99();
+    xSemaphoreGive(_lock);
+    return p99;
+}
+
+// Caller holds _lock, or is the poll task (the only writer)
+uint16_t APIClient::rttP99() const {
+    if (_rttCount == 0) return 0;
+    uint16_t sorted[API_RTT_SAMPLES];
+    memcpy(sorted, _rtt, _rttCount * sizeof(uint16_t));
+    std::sort(sorted, sorted + _rttCount);
+    return sorted[(_rttCount - 1) * 99 / 100];
+}
+
+// p99 of recent request times with a margin that grows as the signal
+// weakens (more retransmissions), within fixed bounds
+void APIClient::updateTimeout() {
+    if (_rttCount < RTT_MIN_SAMPLES) {
+        _timeoutMs = API_TIMEOUT_DEFAULT_MS;
+        return;
+    }
+
+    uint32_t margin = 2;
+    if (_rssi < -80)      margin = 4;
+    else if (_rssi < -70) margin = 3;
+
+    uint32_t timeout = (uint32_t)rttP99() * margin;
+    _timeoutMs = constrain(timeout, (uint32_t)TIMEOUT_MIN_MS, (uint32_t)TIMEOUT_MAX_MS);
+}
+
+void APIClient::jsonError(ApiEndpoint endpoint, const DeserializationError& err) {
+    String error = "JSON: " + String(err.c_str());
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _lastError = error;
+    _stats[endpoint].errors++;
+    xSemaphoreGive(_lock);
+}
+
 bool APIClient::testConnection() {
-    String url = buildURL("/api/v1/health");
-    String resp = httpGet(url);
+    String resp = httpGet(API_HEALTH);
     return _connected;
 }
 
@@ -47,138 +190,49 @@ DashboardData APIClient::fetchDashboard() {
     DashboardData data = {};
     data.valid = false;
 
-    String url = buildURL("/api/v1/dashboard");
-    String resp = httpGet(url);
+    String resp = httpGet(API_DASHBOARD);
     if (resp.isEmpty()) return data;
 
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, resp);
-    if (err) {
-        _lastError = "JSON: " + String(err.c_str());
-        return data;
-    }
-
-    data.totalTapes        = doc["total_tapes"] | 0;
-    data.activeTapes       = doc["active_tapes"] | 0;
-    data.fullTapes         = 0;  // Not provided by API
-    data.totalJobs         = doc["total_jobs"] | 0;
-    data.activeJobs        = doc["running_jobs"] | 0;
-    data.totalDrives       = doc["drive_status"].is<const char*>() ? 1 : 0;
-
-    // Sum capacity across all pools
-    data.totalCapacityBytes = 0;
-    data.usedCapacityBytes  = 0;
-    JsonArray pools = doc["pool_storage"].as<JsonArray>();
-    for (JsonObject pool : pools) {
-        data.totalCapacityBytes += pool["total_capacity_bytes"] | (int64_t)0;
-        data.usedCapacityBytes  += pool["total_used_bytes"] | (int64_t)0;
-    }
-    data.valid = true;
-
+    DeserializationError err = parseDashboard(resp.c_str(), resp.length(), data);
+    if (err) jsonError(API_DASHBOARD, err);
     return data;
 }
 
 std::vector<ActiveJobData> APIClient::fetchActiveJobs() {
     std::vector<ActiveJobData> jobs;
 
-    String url = buildURL("/api/v1/jobs/active");
-    String resp = httpGet(url);
+    String resp = httpGet(API_JOBS);
     if (resp.isEmpty()) return jobs;
 
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, resp);
-    if (err) {
-        _lastError = "JSON: " + String(err.c_str());
-        return jobs;
-    }
-
-    JsonArray arr = doc.as<JsonArray>();
-    for (JsonObject obj : arr) {
-        ActiveJobData job;
-        job.id             = obj["job_id"] | 0;
-        job.name           = obj["job_name"] | "Unknown";
-        job.phase          = obj["phase"] | "";
-        job.status         = obj["status"] | "unknown";
-        job.fileCount      = obj["file_count"] | (int64_t)0;
-        job.totalFiles     = obj["total_files"] | (int64_t)0;
-        job.totalBytes     = obj["total_bytes"] | (int64_t)0;
-        job.bytesWritten   = obj["bytes_written"] | (int64_t)0;
-        job.writeSpeed     = obj["write_speed"] | 0.0;
-        job.tapeLabel      = obj["tape_label"] | "";
-        job.tapeCapacityBytes = obj["tape_capacity_bytes"] | (int64_t)0;
-        job.tapeUsedBytes  = obj["tape_used_bytes"] | (int64_t)0;
-        job.estimatedSecondsRemaining = obj["estimated_seconds_remaining"] | 0.0;
-        job.tapeEstimatedSecondsRemaining = obj["tape_estimated_seconds_remaining"] | 0.0;
-        job.startTime      = obj["start_time"] | "";
-        job.scanFilesFound = obj["scan_files_found"] | (int64_t)0;
-        job.scanDirsScanned = obj["scan_dirs_scanned"] | (int64_t)0;
-        job.scanBytesFound = obj["scan_bytes_found"] | (int64_t)0;
-        job.valid = true;
-        jobs.push_back(job);
-    }
-
+    DeserializationError err = parseActiveJobs(resp.c_str(), resp.length(), jobs);
+    if (err) jsonError(API_JOBS, err);
     return jobs;
 }
 
 std::vector<DriveData> APIClient::fetchDrives() {
     std::vector<DriveData> drives;
 
-    String url = buildURL("/api/v1/drives");
-    String resp = httpGet(url);
+    String resp = httpGet(API_DRIVES);
     if (resp.isEmpty()) return drives;
 
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, resp);
-    if (err) {
-        _lastError = "JSON: " + String(err.c_str());
-        return drives;
-    }
-
-    JsonArray arr = doc.as<JsonArray>();
-    for (JsonObject obj : arr) {
-        DriveData drive;
-        drive.id          = obj["id"] | 0;
-        drive.displayName = obj["display_name"] | "Unknown";
-        drive.vendor      = obj["vendor"] | "";
-        drive.model       = obj["model"] | "";
-        drive.status      = obj["status"] | "unknown";
-        drive.currentTape = obj["current_tape"] | "None";
-        drive.formatType  = obj["format_type"] | "";
-        drive.devicePath  = obj["device_path"] | "";
-        drive.enabled     = obj["enabled"] | false;
-        drive.valid = true;
-        drives.push_back(drive);
-    }
-
+    DeserializationError err = parseDrives(resp.c_str(), resp.length(), drives);
+    if (err) jsonError(API_DRIVES, err);
     return drives;
 }
 
 std::vector<TapeChangeData> APIClient::fetchTapeChanges() {
     std::vector<TapeChangeData> changes;
 
-    // Fetch active jobs and check for tape change needs via events
-    String url = buildURL("/api/v1/events");
-    String resp = httpGet(url);
+    // Tape change needs come from the event log
+    String resp = httpGet(API_EVENTS);
     if (resp.isEmpty()) return changes;
 
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, resp);
-    if (err) return changes;
-
-    JsonArray arr = doc.as<JsonArray>();
-    for (JsonObject obj : arr) {
-        String type = obj["type"] | "";
-        if (type == "tape_change_required" || type == "tape_full") {
-            TapeChangeData change;
-            change.id            = obj["id"] | 0;
-            change.reason        = obj["type"] | "";
-            change.status        = obj["status"] | "pending";
-            change.currentTapeId = obj["tape_id"] | 0;
-            change.valid = true;
-            changes.push_back(change);
-        }
+    DeserializationError err = parseTapeChanges(resp.c_str(), resp.length(), changes);
+    if (err) {
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        _stats[API_EVENTS].errors++;
+        xSemaphoreGive(_lock);
     }
-
     return changes;
 }
 
@@ -186,24 +240,10 @@ LTFSFormatStatus APIClient::fetchLTFSFormatStatus() {
     LTFSFormatStatus status = {};
     status.valid = false;
 
-    String url = buildURL("/api/v1/ltfs/format/status");
-    String resp = httpGet(url);
+    String resp = httpGet(API_LTFS_FORMAT);
     if (resp.isEmpty()) return status;
 
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, resp);
-    if (err) {
-        _lastError = "JSON: " + String(err.c_str());
-        return status;
-    }
-
-    status.active     = doc["active"] | false;
-    status.phase      = doc["phase"] | "";
-    status.devicePath = doc["device_path"] | "";
-    status.progressPct = doc["progress_pct"] | 0;
-    status.elapsedSec  = doc["elapsed_seconds"] | (unsigned long)0;
-    status.error       = doc["error"] | "";
-    status.valid = true;
-
+    DeserializationError err = parseLTFSFormatStatus(resp.c_str(), resp.length(), status);
+    if (err) jsonError(API_LTFS_FORMAT, err);
     return status;
 }
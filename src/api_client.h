@@ -2,83 +2,68 @@
 
 #include <Arduino.h>
 #include <HTTPClient.h>
-#include <ArduinoJson.h>
-#include "settings.h"
-
-// Dashboard stats from /api/v1/dashboard
-struct DashboardData {
-    int totalTapes;
-    int activeTapes;
-    int fullTapes;
-    int totalJobs;
-    int activeJobs;
-    int totalDrives;
-    int64_t totalCapacityBytes;
-    int64_t usedCapacityBytes;
-    bool valid;
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "api_parser.h"
+
+#define API_RTT_SAMPLES         64
+#define API_TIMEOUT_DEFAULT_MS  3000   // Until enough requests have been timed
+
+enum ApiEndpoint {
+    API_HEALTH,
+    API_DASHBOARD,
+    API_JOBS,
+    API_DRIVES,
+    API_EVENTS,
+    API_LTFS_FORMAT,
+    API_ENDPOINT_COUNT
 };
 
-// Active job info from /api/v1/jobs/active
-struct ActiveJobData {
-    int id;
-    String name;
-    String phase;          // initializing, scanning, streaming, cataloging, completed, failed, cancelled
-    String status;         // running, paused, cancelled
-    int64_t fileCount;
-    int64_t totalFiles;
-    int64_t totalBytes;
-    int64_t bytesWritten;
-    double writeSpeed;     // bytes per second
-    String tapeLabel;
-    int64_t tapeCapacityBytes;
-    int64_t tapeUsedBytes;
-    double estimatedSecondsRemaining;
-    double tapeEstimatedSecondsRemaining;
-    String startTime;
-    // Scan progress fields
-    int64_t scanFilesFound;
-    int64_t scanDirsScanned;
-    int64_t scanBytesFound;
-    bool valid;
+// Request count and latency per endpoint, for /metrics
+struct EndpointStats {
+    uint32_t requests;
+    uint32_t errors;       // Transport, HTTP status and JSON errors
+    uint32_t retries;      // Extra attempts after a transport error
+    uint32_t lastMs;
+    uint64_t totalMs;
 };
 
-// Drive info from /api/v1/drives
-struct DriveData {
-    int id;
-    String displayName;
-    String vendor;
-    String model;
-    String status;        // ready, busy, offline, error
-    String currentTape;
-    String formatType;    // raw, ltfs
-    String devicePath;
-    bool enabled;
-    bool valid;
+// Server settings for one poll round. Copied in, so the poll task never
+// reads AppSettings while loop() applies a save.
+struct ServerConfig {
+    String host;
+    uint16_t port;
+    String apiKey;
+    bool useHTTPS;
 };
 
-// Tape change request
-struct TapeChangeData {
-    int id;
-    String reason;       // tape_full, tape_error
-    String status;       // pending, acknowledged, completed
-    int currentTapeId;
-    bool valid;
+// Where requests go: the server over HTTP, or a recorded capture being
+// replayed. get() returns the HTTP status, or an HTTPC_ERROR_* code for a
+// transport failure; the body is only read for a 200.
+class ApiTransport {
+public:
+    virtual ~ApiTransport() {}
+    virtual int get(ApiEndpoint endpoint, const String& url, const String& apiKey,
+                    uint16_t timeoutMs, String& body) = 0;
 };
 
-// LTFS format progress from /api/v1/ltfs/format/status
-struct LTFSFormatStatus {
-    bool active;
-    String phase;        // formatting, verifying, mounting, labeling, finalizing
-    String devicePath;
-    int progressPct;
-    unsigned long elapsedSec;
-    String error;
-    bool valid;
+class HttpTransport : public ApiTransport {
+public:
+    int get(ApiEndpoint endpoint, const String& url, const String& apiKey,
+            uint16_t timeoutMs, String& body) override;
 };
 
+class ApiCapture;
+
+// Fetches run in the network task. The getters below may be called from
+// any task; the connection state, error and statistics are under _lock.
 class APIClient {
 public:
-    void begin(SettingsManager& settings);
+    void begin();
+
+    // Call before each round of fetches: sets the server and refills the
+    // retry budget the round's requests share
+    void beginPoll(const ServerConfig& server);
 
     bool testConnection();
     DashboardData fetchDashboard();
@@ -88,13 +73,55 @@ public:
     LTFSFormatStatus fetchLTFSFormatStatus();
 
     bool isConnected() const { return _connected; }
-    String getLastError() const { return _lastError; }
+    String getLastError() const;
+
+    static const char* endpointName(int endpoint);
+    EndpointStats getStats(int endpoint) const;
+
+    // Address to connect to instead of looking up serverHost (0 = look it
+    // up), set by ServerDiscovery for ".local" hosts
+    void setServerAddress(uint32_t ip) { _serverIP = ip; }
+    uint32_t getServerAddress() const { return _serverIP; }
+
+    // Requests in a row that got no answer at all (timeouts, refused)
+    uint32_t getUnanswered() const { return _unanswered; }
+
+    // Link quality the request timeout is derived from
+    uint16_t getTimeoutMs() const { return _timeoutMs; }
+    uint16_t getRttP99Ms() const;
+    int getAverageRssi() const { return _rssi; }
+
+    // Set before the network task starts polling. nullptr = HTTP.
+    void setTransport(ApiTransport* transport) { _transport = transport ? transport : &_http; }
+    // Every attempt's answer is passed to the capture, if any
+    void setCapture(ApiCapture* capture) { _capture = capture; }
 
 private:
-    SettingsManager* _settings = nullptr;
-    bool _connected = false;
+    SemaphoreHandle_t _lock = nullptr;
+    ServerConfig _server;
+    volatile bool _connected = false;
     String _lastError;
+    EndpointStats _stats[API_ENDPOINT_COUNT] = {};
+    volatile uint32_t _serverIP = 0;     // Written by loop(), read by the poll task
+    volatile uint32_t _unanswered = 0;
+
+    // Recent successful request times, oldest overwritten first
+    uint16_t _rtt[API_RTT_SAMPLES] = {};
+    size_t _rttCount = 0;
+    size_t _rttNext = 0;
+    int _rssi = 0;                 // Smoothed, 0 = no reading yet
+    uint16_t _timeoutMs = API_TIMEOUT_DEFAULT_MS;
+    uint8_t _retryBudget = 0;
+
+    HttpTransport _http;
+    ApiTransport* _transport = &_http;
+    ApiCapture* _capture = nullptr;
 
     String buildURL(const String& path);
-    String httpGet(const String& url);
+    String httpGet(ApiEndpoint endpoint);
+    void addRtt(unsigned long ms);
+    uint16_t rttP99() const;
+    void updateTimeout();
+    void setResult(bool connected, const String& error);
+    void jsonError(ApiEndpoint endpoint, const DeserializationError& err);
 };
@@ -0,0 +1,135 @@
+#include "api_parser.h"
+
+DeserializationError parseDashboard(const char* json, size_t len, DashboardData& out) {
+    out = {};
+    out.valid = false;
+
+    JsonDocument doc;
+    DeserializationError err = deserializeJson(doc, json, len);
+    if (err) return err;
+
+    out.totalTapes        = doc["total_tapes"] | 0;
+    out.activeTapes       = doc["active_tapes"] | 0;
+    out.fullTapes         = 0;  // Not provided by API
+    out.totalJobs         = doc["total_jobs"] | 0;
+    out.activeJobs        = doc["running_jobs"] | 0;
+    out.totalDrives       = doc["drive_status"].is<const char*>() ? 1 : 0;
+
+    // Sum capacity across all pools
+    out.totalCapacityBytes = 0;
+    out.usedCapacityBytes  = 0;
+    JsonArray pools = doc["pool_storage"].as<JsonArray>();
+    for (JsonObject pool : pools) {
+        out.totalCapacityBytes += pool["total_capacity_bytes"] | (int64_t)0;
+        out.usedCapacityBytes  += pool["total_used_bytes"] | (int64_t)0;
+    }
+    out.valid = true;
+    return err;
+}
+
+DeserializationError parseActiveJobs(const char* json, size_t len,
+                                     std::vector<ActiveJobData>& out) {
+    out.clear();
+
+    JsonDocument doc;
+    DeserializationError err = deserializeJson(doc, json, len);
+    if (err) return err;
+
+    JsonArray arr = doc.as<JsonArray>();
+    out.reserve(arr.size());
+    for (JsonObject obj : arr) {
+        ActiveJobData job;
+        job.id             = obj["job_id"] | 0;
+        job.name           = obj["job_name"] | "Unknown";
+        job.phase          = obj["phase"] | "";
+        job.status         = obj["status"] | "unknown";
+        job.fileCount      = obj["file_count"] | (int64_t)0;
+        job.totalFiles     = obj["total_files"] | (int64_t)0;
+        job.totalBytes     = obj["total_bytes"] | (int64_t)0;
+        job.bytesWritten   = obj["bytes_written"] | (int64_t)0;
+        job.writeSpeed     = obj["write_speed"] | 0.0;
+        job.tapeLabel      = obj["tape_label"] | "";
+        job.tapeCapacityBytes = obj["tape_capacity_bytes"] | (int64_t)0;
+        job.tapeUsedBytes  = obj["tape_used_bytes"] | (int64_t)0;
+        job.estimatedSecondsRemaining = obj["estimated_seconds_remaining"] | 0.0;
+        job.tapeEstimatedSecondsRemaining = obj["tape_estimated_seconds_remaining"] | 0.0;
+        job.startTime      = obj["start_time"] | "";
+        job.scanFilesFound = obj["scan_files_found"] | (int64_t)0;
+        job.scanDirsScanned = obj["scan_dirs_scanned"] | (int64_t)0;
+        job.scanBytesFound = obj["scan_bytes_found"] | (int64_t)0;
+        job.valid = true;
+        out.push_back(job);
+    }
+    return err;
+}
+
+DeserializationError parseDrives(const char* json, size_t len,
+                                 std::vector<DriveData>& out) {
+    out.clear();
+
+    JsonDocument doc;
+    DeserializationError err = deserializeJson(doc, json, len);
+    if (err) return err;
+
+    JsonArray arr = doc.as<JsonArray>();
+    out.reserve(arr.size());
+    for (JsonObject obj : arr) {
+        DriveData drive;
+        drive.id          = obj["id"] | 0;
+        drive.displayName = obj["display_name"] | "Unknown";
+        drive.vendor      = obj["vendor"] | "";
+        drive.model       = obj["model"] | "";
+        drive.status      = obj["status"] | "unknown";
+        drive.currentTape = obj["current_tape"] | "None";
+        drive.formatType  = obj["format_type"] | "";
+        drive.devicePath  = obj["device_path"] | "";
+        drive.enabled     = obj["enabled"] | false;
+        drive.valid = true;
+        out.push_back(drive);
+    }
+    return err;
+}
+
+DeserializationError parseTapeChanges(const char* json, size_t len,
+                                      std::vector<TapeChangeData>& out) {
+    out.clear();
+
+    JsonDocument doc;
+    DeserializationError err = deserializeJson(doc, json, len);
+    if (err) return err;
+
+    // Only tape change requests; the rest of the event log is ignored
+    JsonArray arr = doc.as<JsonArray>();
+    for (JsonObject obj : arr) {
+        const char* type = obj["type"] | "";
+        if (!strcmp(type, "tape_change_required") || !strcmp(type, "tape_full")) {
+            TapeChangeData change;
+            change.id            = obj["id"] | 0;
+            change.reason        = type;
+            change.status        = obj["status"] | "pending";
+            change.currentTapeId = obj["tape_id"] | 0;
+            change.valid = true;
+            out.push_back(change);
+        }
+    }
+    return err;
+}
+
+DeserializationError parseLTFSFormatStatus(const char* json, size_t len,
+                                           LTFSFormatStatus& out) {
+    out = {};
+    out.valid = false;
+
+    JsonDocument doc;
+    DeserializationError err = deserializeJson(doc, json, len);
+    if (err) return err;
+
+    out.active      = doc["active"] | false;
+    out.phase       = doc["phase"] | "";
+    out.devicePath  = doc["device_path"] | "";
+    out.progressPct = doc["progress_pct"] | 0;
+    out.elapsedSec  = doc["elapsed_seconds"] | (unsigned long)0;
+    out.error       = doc["error"] | "";
+    out.valid = true;
+    return err;
+}
@@ -0,0 +1,13 @@
+#include "boot_profile.h"
+
+void BootProfile::mark(const char* phase) {
+    if (_count == BOOT_PHASE_MAX) return;
+
+    BootPhase& p = _phases[_count];
+    p.name = phase;
+    p.atMs = millis();
+    p.tookMs = p.atMs - (_count ? _phases[_count - 1].atMs : 0);
+    _count++;
+    Serial.printf("Boot: %-12s %5u ms (+%u)\n", phase,
+                  (unsigned)p.atMs, (unsigned)p.tookMs);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define BOOT_PHASE_MAX  12
+
+struct BootPhase {
+    const char* name;    // String literal
+    uint32_t atMs;       // millis() when the phase finished
+    uint32_t tookMs;     // Since the previous phase
+};
+
+// When each boot step finished, from reset to the first poll. Printed to
+// serial as it happens and served in /status.
+class BootProfile {
+public:
+    // Call from setup() / loop() only
+    void mark(const char* phase);
+
+    size_t count() const { return _count; }
+    const BootPhase& get(size_t i) const { return _phases[i]; }
+
+private:
+    BootPhase _phases[BOOT_PHASE_MAX];
+    size_t _count = 0;
+};
@@ -0,0 +1,180 @@
+#include "discovery.h"
+#include <ESPmDNS.h>
+
+#define RESOLVE_RETRY_MS  10000   // Between lookups while the server is unreachable
+
+// Browse steps: dedicated service type first, then generic web servers
+struct BrowseType {
+    const char* service;
+    const char* proto;
+    bool nameMustMatch;    // Only instances that mention TapeBackarr
+};
+
+static const BrowseType BROWSE_TYPES[] = {
+    { "_tapebackarr", "_tcp", false },
+    { "_http",        "_tcp", true },
+};
+#define BROWSE_STEPS  (sizeof(BROWSE_TYPES) / sizeof(BROWSE_TYPES[0]))
+
+static uint32_t firstIPv4(const mdns_result_t* r) {
+    for (const mdns_ip_addr_t* a = r->addr; a; a = a->next) {
+        if (a->addr.type == ESP_IPADDR_TYPE_V4) return a->addr.u_addr.ip4.addr;
+    }
+    return 0;
+}
+
+static bool mentionsTapeBackarr(const char* str) {
+    if (!str) return false;
+    String s(str);
+    s.toLowerCase();
+    return s.indexOf("tapebackarr") >= 0;
+}
+
+void ServerDiscovery::begin(SettingsManager& settings, APIClient& api) {
+    _settings = &settings;
+    _api = &api;
+}
+
+void ServerDiscovery::update(bool wifiConnected) {
+    if (!wifiConnected) return;
+
+    if (!_started) {
+        String name = _settings->get().deviceName;
+        if (name.isEmpty()) name = DEFAULT_DEVICE_NAME;
+        if (!MDNS.begin(name.c_str())) return;
+        MDNS.addService("http", "tcp", 80);
+        _started = true;
+        Serial.printf("mDNS: http://%s.local/\n", name.c_str());
+    }
+
+    updateBrowse();
+    updateResolve();
+}
+
+void ServerDiscovery::updateBrowse() {
+    if (_browse) {
+        mdns_result_t* results = nullptr;
+        if (!mdns_query_async_get_results(_browse, 0, &results)) return;
+        collectBrowse(results);
+        mdns_query_results_free(results);
+        mdns_query_async_delete(_browse);
+        _browse = nullptr;
+
+        if (++_browseStep < (int)BROWSE_STEPS) {
+            startBrowseStep();
+        } else {
+            portENTER_CRITICAL(&_mux);
+            memcpy(_servers, _found, _foundCount * sizeof(DiscoveredServer));
+            _serverCount = _foundCount;
+            _browseAt = millis();
+            _browsing = false;
+            portEXIT_CRITICAL(&_mux);
+            Serial.printf("mDNS: %d TapeBackarr server(s)\n", (int)_foundCount);
+        }
+    } else if (_browseRequested) {
+        _browseRequested = false;
+        _foundCount = 0;
+        _browseStep = 0;
+        startBrowseStep();
+    }
+}
+
+void ServerDiscovery::requestBrowse() {
+    if (_browsing || _browseRequested) return;
+    if (_browseAt && millis() - _browseAt < DISCOVERY_FRESH_MS) return;
+    _browseRequested = true;
+}
+
+size_t ServerDiscovery::getServers(DiscoveredServer* out, size_t max,
+                                   long& ageMs, bool& browsing) {
+    portENTER_CRITICAL(&_mux);
+    size_t n = min(max, _serverCount);
+    memcpy(out, _servers, n * sizeof(DiscoveredServer));
+    ageMs = _browseAt ? (long)(millis() - _browseAt) : -1;
+    browsing = _browsing || _browseRequested;
+    portEXIT_CRITICAL(&_mux);
+    return n;
+}
+
+void ServerDiscovery::startBrowseStep() {
+    const BrowseType& t = BROWSE_TYPES[_browseStep];
+    _browse = mdns_query_async_new(nullptr, t.service, t.proto, MDNS_TYPE_PTR,
+                                   DISCOVERY_QUERY_MS, DISCOVERY_MAX_SERVERS * 2);
+    _browsing = _browse != nullptr;
+    if (!_browse) Serial.println("mDNS browse failed to start");
+}
+
+void ServerDiscovery::collectBrowse(mdns_result_t* results) {
+    bool mustMatch = BROWSE_TYPES[_browseStep].nameMustMatch;
+
+    for (const mdns_result_t* r = results; r; r = r->next) {
+        uint32_t ip = firstIPv4(r);
+        if (!ip || !r->port) continue;
+        if (mustMatch && !mentionsTapeBackarr(r->instance_name) &&
+            !mentionsTapeBackarr(r->hostname)) continue;
+
+        // Same server advertised under both types
+        bool seen = false;
+        for (size_t i = 0; i < _foundCount && !seen; i++) {
+            seen = _found[i].ip == ip && _found[i].port == r->port;
+        }
+        if (seen) continue;
+        if (_foundCount == DISCOVERY_MAX_SERVERS) break;
+
+        DiscoveredServer& d = _found[_foundCount++];
+        strlcpy(d.name, r->instance_name ? r->instance_name : "", sizeof(d.name));
+        if (r->hostname) {
+            snprintf(d.host, sizeof(d.host), "%s.local", r->hostname);
+        } else {
+            d.host[0] = '\0';
+        }
+        d.ip = ip;
+        d.port = r->port;
+    }
+}
+
+// Keep the API pointed at the current address of a ".local" server host
+void ServerDiscovery::updateResolve() {
+    const String& host = _settings->get().serverHost;
+    if (!host.endsWith(".local")) {
+        _api->setServerAddress(0);
+        _resolveHost = "";
+        return;
+    }
+
+    if (_resolve) {
+        mdns_result_t* results = nullptr;
+        if (!mdns_query_async_get_results(_resolve, 0, &results)) return;
+        uint32_t ip = results ? firstIPv4(results) : 0;
+        mdns_query_results_free(results);
+        mdns_query_async_delete(_resolve);
+        _resolve = nullptr;
+
+        if (ip && host == _resolveHost) {
+            if (ip != _api->getServerAddress()) {
+                Serial.printf("mDNS: %s is %s\n", host.c_str(),
+                              IPAddress(ip).toString().c_str());
+            }
+            _api->setServerAddress(ip);
+        } else if (!ip) {
+            Serial.printf("mDNS: %s not found\n", host.c_str());
+        }
+        return;
+    }
+
+    // Host setting changed: the old address is no use any more
+    if (host != _resolveHost) {
+        _api->setServerAddress(0);
+        _resolveHost = host;
+        _resolvedAt = 0;
+    } else if (_api->getServerAddress() &&
+               _api->getUnanswered() < RESOLVE_AFTER_FAILURES) {
+        return;   // Cached address still answers
+    }
+    if (_resolvedAt && millis() - _resolvedAt < RESOLVE_RETRY_MS) return;
+
+    String name = host.substring(0, host.length() - strlen(".local"));
+    _resolve = mdns_query_async_new(name.c_str(), nullptr, nullptr, MDNS_TYPE_A,
+                                    DISCOVERY_QUERY_MS, 1);
+    _resolvedAt = millis();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Arduino.h>
+#include <mdns.h>
+#include "settings.h"
+#include "api_client.h"
+
+#define DISCOVERY_MAX_SERVERS  8
+#define DISCOVERY_FRESH_MS     30000   // Reuse a browse this recent
+#define DISCOVERY_QUERY_MS     3000    // How long each mDNS query listens
+#define RESOLVE_AFTER_FAILURES 2       // Unanswered requests before re-resolving
+
+// TapeBackarr server found on the LAN
+struct DiscoveredServer {
+    char name[64];       // Service instance name
+    char host[64];       // mDNS hostname, with ".local"
+    uint32_t ip;
+    uint16_t port;
+};
+
+// mDNS for the CYD: advertises its own web UI, browses for TapeBackarr
+// servers (_tapebackarr._tcp, and _http._tcp instances with "tapebackarr"
+// in their name) and resolves a ".local" server host once, so API
+// requests use a cached address. The address is looked up again when the
+// server stops answering, e.g. after its DHCP lease changed.
+//
+// Queries run asynchronously and are collected by update(), like the WiFi
+// scan.
+class ServerDiscovery {
+public:
+    void begin(SettingsManager& settings, APIClient& api);
+
+    // Call from loop()
+    void update(bool wifiConnected);
+
+    // Safe from other tasks (web handlers). Requests while a browse is
+    // running or its results are fresh are folded into it.
+    void requestBrowse();
+    size_t getServers(DiscoveredServer* out, size_t max,
+                      long& ageMs, bool& browsing);
+
+private:
+    SettingsManager* _settings = nullptr;
+    APIClient* _api = nullptr;
+    bool _started = false;
+
+    // Browse: one service type after the other
+    mdns_search_once_t* _browse = nullptr;
+    int _browseStep = 0;
+    DiscoveredServer _found[DISCOVERY_MAX_SERVERS];
+    size_t _foundCount = 0;
+
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    DiscoveredServer _servers[DISCOVERY_MAX_SERVERS];
+    size_t _serverCount = 0;
+    volatile unsigned long _browseAt = 0;   // millis() of the last results, 0 = none
+    volatile bool _browseRequested = false;
+    volatile bool _browsing = false;
+
+    // Resolve of a ".local" server host
+    mdns_search_once_t* _resolve = nullptr;
+    String _resolveHost;                    // Host the cached address belongs to
+    unsigned long _resolvedAt = 0;          // millis() of the last lookup
+
+    void updateBrowse();
+    void startBrowseStep();
+    void collectBrowse(mdns_result_t* results);
+    void updateResolve();
+};
@@ -1,8 +1,5 @@
 #include "display.h"
 
-// Backlight pin
-#define TFT_BL 21
-
 // Screen dimensions
 #define SCREEN_W 320
 #define SCREEN_H 240
@@ -15,91 +12,91 @@
 #define TAB_BAR_Y     (SCREEN_H - TAB_BAR_H)
 #define TAB_COUNT     3
 
+// Everything the tab screens draw with; the screen cache stores indices
+// into this table
+static const uint16_t TAB_PALETTE[] = {
+    COLOR_BG, COLOR_CARD_BG, COLOR_TEXT, COLOR_TEXT_DIM, COLOR_ACCENT,
+    COLOR_SUCCESS, COLOR_WARNING, COLOR_ERROR, COLOR_HEADER_BG,
+    COLOR_PROGRESS_BG
+};
+
+static const DisplayScreen TAB_SCREENS[TAB_COUNT] = {
+    SCREEN_DASHBOARD, SCREEN_JOBS, SCREEN_DRIVES
+};
+
 void Display::begin() {
     _tft.init();
     _tft.setRotation(1);  // Landscape
     _tft.fillScreen(COLOR_BG);
 
-    // Backlight
-    pinMode(TFT_BL, OUTPUT);
-    setBrightness(100);
+    // Allocate while the heap is still unfragmented
+    _cache.begin(SCREEN_W, SCREEN_H, TAB_PALETTE,
+                 sizeof(TAB_PALETTE) / sizeof(TAB_PALETTE[0]));
 
-    // RGB LED
-    pinMode(LED_RED, OUTPUT);
-    pinMode(LED_GREEN, OUTPUT);
-    pinMode(LED_BLUE, OUTPUT);
-    setLED(false, false, false);
-}
-
-void Display::update() {
-    // Blink LED during alerts
-    if (_currentScreen == SCREEN_ALERT) {
-        if (millis() - _lastAlertBlink > 500) {
-            _alertState = !_alertState;
-            alertLED(_alertState);
-            _lastAlertBlink = millis();
-        }
-    }
+    // Backlight and RGB LED
+    _leds.begin();
+    setBrightness(100);
 }
 
 void Display::showBoot(const String& version) {
     _currentScreen = SCREEN_BOOT;
-    _tft.fillScreen(COLOR_BG);
+    _gfx->fillScreen(ink(COLOR_BG));
 
-    _tft.setTextColor(COLOR_ACCENT, COLOR_BG);
-    _tft.setTextDatum(MC_DATUM);
+    _gfx->setTextColor(ink(COLOR_ACCENT), ink(COLOR_BG));
+    _gfx->setTextDatum(MC_DATUM);
 
-    _tft.setTextSize(1);
-    _tft.drawString("TAPEBACKARR", SCREEN_W / 2, 80, 4);
+    _gfx->setTextSize(1);
+    drawText("TAPEBACKARR", SCREEN_W / 2, 80, 4);
 
-    _tft.setTextColor(COLOR_TEXT_DIM, COLOR_BG);
-    _tft.drawString("CYD Monitor", SCREEN_W / 2, 120, 2);
+    _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_BG));
+    drawText("CYD Monitor", SCREEN_W / 2, 120, 2);
 
-    _tft.setTextColor(COLOR_TEXT_DIM, COLOR_BG);
-    _tft.drawString(version, SCREEN_W / 2, 150, 2);
+    _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_BG));
+    drawText(version, SCREEN_W / 2, 150, 2);
 
-    _tft.drawString("Initializing...", SCREEN_W / 2, 190, 2);
-    _tft.setTextDatum(TL_DATUM);
+    drawText("Initializing...", SCREEN_W / 2, 190, 2);
+    _gfx->setTextDatum(TL_DATUM);
 }
 
 void Display::showAPMode(const String& apName, const String& ip) {
     _currentScreen = SCREEN_AP_MODE;
-    _tft.fillScreen(COLOR_BG);
+    _gfx->fillScreen(ink(COLOR_BG));
 
-    _tft.setTextColor(COLOR_WARNING, COLOR_BG);
-    _tft.setTextDatum(MC_DATUM);
-    _tft.drawString("SETUP MODE", SCREEN_W / 2, 30, 4);
+    _gfx->setTextColor(ink(COLOR_WARNING), ink(COLOR_BG));
+    _gfx->setTextDatum(MC_DATUM);
+    drawText("SETUP MODE", SCREEN_W / 2, 30, 4);
 
-    _tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    _tft.drawString("Connect to WiFi:", SCREEN_W / 2, 75, 2);
+    _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_BG));
+    drawText("Connect to WiFi:", SCREEN_W / 2, 75, 2);
 
-    _tft.setTextColor(COLOR_ACCENT, COLOR_BG);
-    _tft.drawString(apName, SCREEN_W / 2, 100, 4);
+    _gfx->setTextColor(ink(COLOR_ACCENT), ink(COLOR_BG));
+    drawText(apName, SCREEN_W / 2, 100, 4);
 
-    _tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    _tft.drawString("Then open browser:", SCREEN_W / 2, 140, 2);
+    _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_BG));
+    drawText("Then open browser:", SCREEN_W / 2, 140, 2);
 
-    _tft.setTextColor(COLOR_ACCENT, COLOR_BG);
-    _tft.drawString("http://" + ip, SCREEN_W / 2, 165, 4);
+    _gfx->setTextColor(ink(COLOR_ACCENT), ink(COLOR_BG));
+    drawText("http://" + ip, SCREEN_W / 2, 165, 4);
 
-    _tft.setTextColor(COLOR_TEXT_DIM, COLOR_BG);
-    _tft.drawString("Configure WiFi & API settings", SCREEN_W / 2, 210, 2);
+    _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_BG));
+    drawText("Configure WiFi & API settings", SCREEN_W / 2, 210, 2);
 
-    _tft.setTextDatum(TL_DATUM);
-    setLED(false, false, true);  // Blue LED in AP mode
+    _gfx->setTextDatum(TL_DATUM);
+    setLEDPattern(LED_PATTERN_AP_MODE);
 }
 
 void Display::showConnecting(const String& ssid) {
     _currentScreen = SCREEN_CONNECTING;
-    _tft.fillScreen(COLOR_BG);
+    _gfx->fillScreen(ink(COLOR_BG));
 
-    _tft.setTextColor(COLOR_ACCENT, COLOR_BG);
-    _tft.setTextDatum(MC_DATUM);
-    _tft.drawString("Connecting...", SCREEN_W / 2, 100, 4);
+    _gfx->setTextColor(ink(COLOR_ACCENT), ink(COLOR_BG));
+    _gfx->setTextDatum(MC_DATUM);
+    drawText("Connecting...", SCREEN_W / 2, 100, 4);
 
-    _tft.setTextColor(COLOR_TEXT_DIM, COLOR_BG);
-    _tft.drawString(ssid, SCREEN_W / 2, 140, 2);
-    _tft.setTextDatum(TL_DATUM);
+    _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_BG));
+    drawText(ssid, SCREEN_W / 2, 140, 2);
+    drawText("Hold screen to start setup AP", SCREEN_W / 2, 200, 1);
+    _gfx->setTextDatum(TL_DATUM);
 }
 
 void Display::showDashboard(const DashboardData& data) {
@@ -107,18 +104,30 @@ void Display::showDashboard(const DashboardData& data) {
     _currentScreen = SCREEN_DASHBOARD;
 
     if (screenChanged) {
-        _tft.fillScreen(COLOR_BG);
+        _gfx->fillScreen(ink(COLOR_BG));
         drawTabBar(0);
     }
+    _shownSerial = 0;
 
+    drawDashboard(data);
+    setLEDPattern(LED_PATTERN_OK);
+}
+
+bool Display::renderDashboard(const DashboardData& data) {
+    if (!beginCanvas(0)) return false;
+    drawDashboard(data);
+    return endCanvas(0);
+}
+
+void Display::drawDashboard(const DashboardData& data) {
     drawStatusBar(true, data.valid, "");
     clearContent();
 
     int y = CONTENT_Y + 5;
 
     // Title
-    _tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    _tft.drawString("Dashboard", 10, y, 4);
+    _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_BG));
+    drawText("Dashboard", 10, y, 4);
     y += 30;
 
     // Cards row 1
@@ -139,56 +148,73 @@ void Display::showDashboard(const DashboardData& data) {
     if (data.totalCapacityBytes > 0) {
         usedPct = (float)data.usedCapacityBytes / (float)data.totalCapacityBytes;
     }
-    _tft.setTextColor(COLOR_TEXT_DIM, COLOR_BG);
-    _tft.drawString("Storage: " + formatBytes(data.usedCapacityBytes) +
+    _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_BG));
+    drawText("Storage: " + formatBytes(data.usedCapacityBytes) +
                      " / " + formatBytes(data.totalCapacityBytes), 10, y, 2);
     y += 18;
     drawProgressBar(10, y, SCREEN_W - 20, 12, usedPct,
                     usedPct > 0.9f ? COLOR_ERROR : COLOR_PROGRESS_FG);
-
-    setLED(false, true, false);  // Green LED when connected
 }
 
-void Display::showActiveJobs(const std::vector<ActiveJobData>& jobs) {
+void Display::showActiveJobs(const std::vector<ActiveJobData>& jobs,
+                             size_t first) {
     bool screenChanged = (_currentScreen != SCREEN_JOBS);
     _currentScreen = SCREEN_JOBS;
 
     if (screenChanged) {
-        _tft.fillScreen(COLOR_BG);
+        _gfx->fillScreen(ink(COLOR_BG));
         drawTabBar(1);
     }
+    _shownSerial = 0;
+
+    drawActiveJobs(jobs, first);
+    setLEDPattern(LED_PATTERN_OK);
+}
 
+bool Display::renderActiveJobs(const std::vector<ActiveJobData>& jobs,
+                               size_t first) {
+    if (!beginCanvas(1)) return false;
+    drawActiveJobs(jobs, first);
+    return endCanvas(1);
+}
+
+void Display::drawActiveJobs(const std::vector<ActiveJobData>& jobs,
+                             size_t first) {
     drawStatusBar(true, true, "");
     clearContent();
 
     int y = CONTENT_Y + 5;
-    _tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    _tft.drawString("Active Jobs", 10, y, 4);
+    _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_BG));
+    drawText("Active Jobs", 10, y, 4);
     y += 30;
 
     if (jobs.empty()) {
-        _tft.setTextColor(COLOR_TEXT_DIM, COLOR_BG);
-        _tft.setTextDatum(MC_DATUM);
-        _tft.drawString("No active jobs", SCREEN_W / 2, y + 50, 4);
-        _tft.setTextDatum(TL_DATUM);
+        _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_BG));
+        _gfx->setTextDatum(MC_DATUM);
+        drawText("No active jobs", SCREEN_W / 2, y + 50, 4);
+        _gfx->setTextDatum(TL_DATUM);
         return;
     }
 
-    for (size_t i = 0; i < jobs.size() && i < 2; i++) {
+    if (first >= jobs.size()) first = 0;
+    size_t last = min(jobs.size(), first + JOBS_PER_PAGE);
+    drawListPosition(first, last - first, jobs.size());
+
+    for (size_t i = first; i < last; i++) {
         const auto& job = jobs[i];
 
         // Job card — taller to fit tape stats
-        _tft.fillRoundRect(5, y, SCREEN_W - 10, 80, 4, COLOR_CARD_BG);
+        _gfx->fillRoundRect(5, y, SCREEN_W - 10, 80, 4, ink(COLOR_CARD_BG));
 
         // Status indicator color
         uint16_t statusColor = COLOR_TEXT_DIM;
         if (job.status == "running") statusColor = COLOR_SUCCESS;
         else if (job.status == "paused") statusColor = COLOR_WARNING;
-        _tft.fillCircle(15, y + 11, 5, statusColor);
+        _gfx->fillCircle(15, y + 11, 5, ink(statusColor));
 
         // Job name
-        _tft.setTextColor(COLOR_TEXT, COLOR_CARD_BG);
-        _tft.drawString(job.name.substring(0, 22), 28, y + 4, 2);
+        _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_CARD_BG));
+        drawText(job.name.substring(0, 22), 28, y + 4, 2);
 
         // Phase badge (top-right)
         String phase = job.phase;
@@ -200,11 +226,11 @@ void Display::showActiveJobs(const std::vector<ActiveJobData>& jobs) {
         else if (phase == "initializing") phaseColor = COLOR_TEXT_DIM;
         else if (phase == "completed") phaseColor = COLOR_SUCCESS;
         else if (phase == "failed") phaseColor = COLOR_ERROR;
-        _tft.setTextColor(phaseColor, COLOR_CARD_BG);
-        _tft.drawString(phase, SCREEN_W - 80, y + 4, 2);
+        _gfx->setTextColor(ink(phaseColor), ink(COLOR_CARD_BG));
+        drawText(phase, SCREEN_W - 80, y + 4, 2);
 
         // Phase-specific stats (second row)
-        _tft.setTextColor(COLOR_TEXT_DIM, COLOR_CARD_BG);
+        _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_CARD_BG));
         String stats;
         if (phase == "scanning") {
             stats = String((long)job.scanFilesFound) + " files " +
@@ -225,7 +251,7 @@ void Display::showActiveJobs(const std::vector<ActiveJobData>& jobs) {
             stats = String((long)job.fileCount) + " files | " +
                     formatBytes(job.bytesWritten);
         }
-        _tft.drawString(stats.substring(0, 50), 28, y + 22, 1);
+        drawText(stats.substring(0, 50), 28, y + 22, 1);
 
         // Job progress bar
         float pct = 0;
@@ -237,14 +263,14 @@ void Display::showActiveJobs(const std::vector<ActiveJobData>& jobs) {
         drawProgressBar(28, y + 34, SCREEN_W - 70, 6, pct,
                          phase == "streaming" ? COLOR_SUCCESS : COLOR_ACCENT);
         {
-            _tft.setTextColor(COLOR_TEXT_DIM, COLOR_CARD_BG);
+            _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_CARD_BG));
             String pctStr = (pct >= 0.1f) ? String((int)(pct * 100)) + "%"
                                           : String(pct * 100, 1) + "%";
-            _tft.drawString(pctStr, SCREEN_W - 40, y + 32, 1);
+            drawText(pctStr, SCREEN_W - 40, y + 32, 1);
         }
 
         // Tape stats row
-        _tft.setTextColor(COLOR_TEXT_DIM, COLOR_CARD_BG);
+        _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_CARD_BG));
         // Use bytes_written as tape used if tape_used_bytes is 0
         int64_t tapeUsed = (job.tapeUsedBytes > 0) ? job.tapeUsedBytes : job.bytesWritten;
         String tapeInfo;
@@ -255,7 +281,7 @@ void Display::showActiveJobs(const std::vector<ActiveJobData>& jobs) {
         } else {
             tapeInfo = "No tape loaded";
         }
-        _tft.drawString(tapeInfo.substring(0, 50), 28, y + 46, 1);
+        drawText(tapeInfo.substring(0, 50), 28, y + 46, 1);
 
         // Tape usage progress bar
         float tapePct = 0;
@@ -266,14 +292,14 @@ void Display::showActiveJobs(const std::vector<ActiveJobData>& jobs) {
                          tapePct > 0.9f ? COLOR_ERROR :
                          tapePct > 0.75f ? COLOR_WARNING : COLOR_ACCENT);
         {
-            _tft.setTextColor(COLOR_TEXT_DIM, COLOR_CARD_BG);
+            _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_CARD_BG));
             String tpPctStr = (tapePct >= 0.1f) ? String((int)(tapePct * 100)) + "%"
                                                 : String(tapePct * 100, 1) + "%";
-            _tft.drawString(tpPctStr, SCREEN_W - 40, y + 56, 1);
+            drawText(tpPctStr, SCREEN_W - 40, y + 56, 1);
         }
 
         // ETAs — job overall + tape
-        _tft.setTextColor(COLOR_TEXT_DIM, COLOR_CARD_BG);
+        _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_CARD_BG));
         String etaLine = "Job: ";
         etaLine += (job.estimatedSecondsRemaining > 0)
                    ? formatDuration((unsigned long)job.estimatedSecondsRemaining)
@@ -282,55 +308,71 @@ void Display::showActiveJobs(const std::vector<ActiveJobData>& jobs) {
         etaLine += (job.tapeEstimatedSecondsRemaining > 0)
                    ? formatDuration((unsigned long)job.tapeEstimatedSecondsRemaining)
                    : "calc...";
-        _tft.drawString(etaLine, 28, y + 68, 1);
+        drawText(etaLine, 28, y + 68, 1);
 
         y += 85;
     }
 }
 
-void Display::showDrives(const std::vector<DriveData>& drives) {
+void Display::showDrives(const std::vector<DriveData>& drives, size_t first) {
     bool screenChanged = (_currentScreen != SCREEN_DRIVES);
     _currentScreen = SCREEN_DRIVES;
 
     if (screenChanged) {
-        _tft.fillScreen(COLOR_BG);
+        _gfx->fillScreen(ink(COLOR_BG));
         drawTabBar(2);
     }
+    _shownSerial = 0;
+
+    drawDrives(drives, first);
+    setLEDPattern(LED_PATTERN_OK);
+}
+
+bool Display::renderDrives(const std::vector<DriveData>& drives, size_t first) {
+    if (!beginCanvas(2)) return false;
+    drawDrives(drives, first);
+    return endCanvas(2);
+}
 
+void Display::drawDrives(const std::vector<DriveData>& drives, size_t first) {
     drawStatusBar(true, true, "");
     clearContent();
 
     int y = CONTENT_Y + 5;
-    _tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    _tft.drawString("Drives", 10, y, 4);
+    _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_BG));
+    drawText("Drives", 10, y, 4);
     y += 30;
 
     if (drives.empty()) {
-        _tft.setTextColor(COLOR_TEXT_DIM, COLOR_BG);
-        _tft.setTextDatum(MC_DATUM);
-        _tft.drawString("No drives found", SCREEN_W / 2, y + 50, 4);
-        _tft.setTextDatum(TL_DATUM);
+        _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_BG));
+        _gfx->setTextDatum(MC_DATUM);
+        drawText("No drives found", SCREEN_W / 2, y + 50, 4);
+        _gfx->setTextDatum(TL_DATUM);
         return;
     }
 
-    for (size_t i = 0; i < drives.size() && i < 3; i++) {
+    if (first >= drives.size()) first = 0;
+    size_t last = min(drives.size(), first + DRIVES_PER_PAGE);
+    drawListPosition(first, last - first, drives.size());
+
+    for (size_t i = first; i < last; i++) {
         const auto& drive = drives[i];
 
-        _tft.fillRoundRect(5, y, SCREEN_W - 10, 48, 4, COLOR_CARD_BG);
+        _gfx->fillRoundRect(5, y, SCREEN_W - 10, 48, 4, ink(COLOR_CARD_BG));
 
         // Status indicator
         uint16_t statusColor = COLOR_TEXT_DIM;
         if (drive.status == "ready") statusColor = COLOR_SUCCESS;
         else if (drive.status == "busy") statusColor = COLOR_WARNING;
         else if (drive.status == "error") statusColor = COLOR_ERROR;
-        _tft.fillCircle(15, y + 15, 5, statusColor);
+        _gfx->fillCircle(15, y + 15, 5, ink(statusColor));
 
         // Drive name
-        _tft.setTextColor(COLOR_TEXT, COLOR_CARD_BG);
-        _tft.drawString(drive.displayName.substring(0, 22), 28, y + 5, 2);
+        _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_CARD_BG));
+        drawText(drive.displayName.substring(0, 22), 28, y + 5, 2);
 
         // Tape info and format type
-        _tft.setTextColor(COLOR_TEXT_DIM, COLOR_CARD_BG);
+        _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_CARD_BG));
         String tape = "Tape: " + drive.currentTape;
         String suffix = "";
         if (drive.formatType.length() > 0) {
@@ -340,40 +382,60 @@ void Display::showDrives(const std::vector<DriveData>& drives) {
         if (maxTapeLen > 0 && tape.length() > (size_t)maxTapeLen) {
             tape = tape.substring(0, maxTapeLen);
         }
-        _tft.drawString(tape + suffix, 28, y + 27, 1);
+        drawText(tape + suffix, 28, y + 27, 1);
 
         // Status badge
-        _tft.setTextColor(statusColor, COLOR_CARD_BG);
-        _tft.drawString(drive.status, SCREEN_W - 60, y + 5, 2);
+        _gfx->setTextColor(ink(statusColor), ink(COLOR_CARD_BG));
+        drawText(drive.status, SCREEN_W - 60, y + 5, 2);
 
         y += 55;
     }
 }
 
+bool Display::showTab(int tab) {
+    if (tab < 0 || tab >= TAB_COUNT || !_cache.has(tab)) return false;
+
+    // Nothing to send if this exact frame is already on the panel
+    if (_currentScreen != TAB_SCREENS[tab] ||
+        _shownSerial != _cache.serial(tab)) {
+        unsigned long start = micros();
+        _cache.blit(tab, &_tft);
+        RenderTiming& t = _timing[tab];
+        t.blitLastUs = micros() - start;
+        t.blitTotalUs += t.blitLastUs;
+        t.blits++;
+        _currentScreen = TAB_SCREENS[tab];
+        _shownSerial = _cache.serial(tab);
+    }
+
+    setLEDPattern(LED_PATTERN_OK);
+    return true;
+}
+
 void Display::showTapeAlert(const String& message) {
     if (_currentScreen == SCREEN_ALERT) return;  // Avoid redraw flicker
     _currentScreen = SCREEN_ALERT;
-    _tft.fillScreen(COLOR_BG);
+    _gfx->fillScreen(ink(COLOR_BG));
 
     // Alert header
-    _tft.fillRect(0, 0, SCREEN_W, 50, COLOR_ERROR);
-    _tft.setTextColor(COLOR_TEXT, COLOR_ERROR);
-    _tft.setTextDatum(MC_DATUM);
-    _tft.drawString("! TAPE CHANGE REQUIRED !", SCREEN_W / 2, 25, 4);
+    _gfx->fillRect(0, 0, SCREEN_W, 50, ink(COLOR_ERROR));
+    _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_ERROR));
+    _gfx->setTextDatum(MC_DATUM);
+    drawText("! TAPE CHANGE REQUIRED !", SCREEN_W / 2, 25, 4);
 
     // Message
-    _tft.setTextColor(COLOR_WARNING, COLOR_BG);
-    _tft.drawString(message, SCREEN_W / 2, 100, 2);
+    _gfx->setTextColor(ink(COLOR_WARNING), ink(COLOR_BG));
+    drawText(message, SCREEN_W / 2, 100, 2);
 
-    _tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    _tft.drawString("Please insert a new tape", SCREEN_W / 2, 140, 2);
-    _tft.drawString("into the drive", SCREEN_W / 2, 165, 2);
+    _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_BG));
+    drawText("Please insert a new tape", SCREEN_W / 2, 140, 2);
+    drawText("into the drive", SCREEN_W / 2, 165, 2);
 
-    _tft.setTextColor(COLOR_TEXT_DIM, COLOR_BG);
-    _tft.drawString("Touch screen to dismiss", SCREEN_W / 2, 210, 2);
+    _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_BG));
+    drawText("Touch screen to dismiss", SCREEN_W / 2, 210, 2);
 
-    _tft.setTextDatum(TL_DATUM);
-    _lastAlertBlink = millis();
+    _gfx->setTextDatum(TL_DATUM);
+    setLEDPattern(LED_PATTERN_ALERT);
 }
 
 void Display::showLTFSFormat(const LTFSFormatStatus& status) {
@@ -381,7 +443,7 @@ void Display::showLTFSFormat(const LTFSFormatStatus& status) {
     _currentScreen = SCREEN_LTFS_FORMAT;
 
     if (screenChanged) {
-        _tft.fillScreen(COLOR_BG);
+        _gfx->fillScreen(ink(COLOR_BG));
     }
 
     drawStatusBar(true, true, "");
@@ -389,18 +451,18 @@ void Display::showLTFSFormat(const LTFSFormatStatus& status) {
 
     int y = CONTENT_Y + 5;
 
-    _tft.setTextColor(COLOR_ACCENT, COLOR_BG);
-    _tft.setTextDatum(MC_DATUM);
-    _tft.drawString("LTFS Formatting", SCREEN_W / 2, y + 10, 4);
+    _gfx->setTextColor(ink(COLOR_ACCENT), ink(COLOR_BG));
+    _gfx->setTextDatum(MC_DATUM);
+    drawText("LTFS Formatting", SCREEN_W / 2, y + 10, 4);
     y += 40;
 
     // Phase
-    _tft.setTextColor(COLOR_TEXT, COLOR_BG);
+    _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_BG));
     String phase = status.phase;
     if (phase.length() > 0) {
         phase[0] = toupper(phase[0]);
     }
-    _tft.drawString(phase.length() > 0 ? phase : "Starting...",
+    drawText(phase.length() > 0 ? phase : "Starting...",
                      SCREEN_W / 2, y + 10, 2);
     y += 30;
 
@@ -410,73 +472,80 @@ void Display::showLTFSFormat(const LTFSFormatStatus& status) {
     y += 24;
 
     // Percentage
-    _tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    _tft.drawString(String(status.progressPct) + "%", SCREEN_W / 2, y + 5, 4);
+    _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_BG));
+    drawText(String(status.progressPct) + "%", SCREEN_W / 2, y + 5, 4);
     y += 35;
 
     // Elapsed time
-    _tft.setTextColor(COLOR_TEXT_DIM, COLOR_BG);
-    _tft.drawString("Elapsed: " + formatDuration(status.elapsedSec),
+    _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_BG));
+    drawText("Elapsed: " + formatDuration(status.elapsedSec),
                      SCREEN_W / 2, y + 5, 2);
     y += 20;
 
     // Device
     if (status.devicePath.length() > 0) {
-        _tft.drawString(status.devicePath, SCREEN_W / 2, y + 5, 1);
+        drawText(status.devicePath, SCREEN_W / 2, y + 5, 1);
     }
 
     // Error display
     if (status.error.length() > 0) {
         y += 20;
-        _tft.setTextColor(COLOR_ERROR, COLOR_BG);
-        _tft.drawString(status.error.substring(0, 35), SCREEN_W / 2, y + 5, 1);
+        _gfx->setTextColor(ink(COLOR_ERROR), ink(COLOR_BG));
+        drawText(status.error.substring(0, 35), SCREEN_W / 2, y + 5, 1);
     }
 
-    _tft.setTextDatum(TL_DATUM);
-    setLED(false, false, true);  // Blue LED during format
+    _gfx->setTextDatum(TL_DATUM);
+    setLEDPattern(LED_PATTERN_FORMAT);
 }
 
 void Display::showError(const String& error, const String& deviceIP) {
-    _tft.fillRect(0, CONTENT_Y, SCREEN_W, CONTENT_H, COLOR_BG);
+    _shownSerial = 0;  // Drawn over a tab screen
+    _gfx->fillRect(0, CONTENT_Y, SCREEN_W, CONTENT_H, ink(COLOR_BG));
 
-    _tft.setTextColor(COLOR_ERROR, COLOR_BG);
-    _tft.setTextDatum(MC_DATUM);
-    _tft.drawString("Connection Error", SCREEN_W / 2,
+    _gfx->setTextColor(ink(COLOR_ERROR), ink(COLOR_BG));
+    _gfx->setTextDatum(MC_DATUM);
+    drawText("Connection Error", SCREEN_W / 2,
                      CONTENT_Y + CONTENT_H / 2 - 30, 4);
 
-    _tft.setTextColor(COLOR_TEXT_DIM, COLOR_BG);
-    _tft.drawString(error.substring(0, 35), SCREEN_W / 2,
+    _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_BG));
+    drawText(error.substring(0, 35), SCREEN_W / 2,
                      CONTENT_Y + CONTENT_H / 2 + 5, 2);
 
     if (deviceIP.length() > 0) {
-        _tft.setTextColor(COLOR_ACCENT, COLOR_BG);
-        _tft.drawString("IP: " + deviceIP, SCREEN_W / 2,
+        _gfx->setTextColor(ink(COLOR_ACCENT), ink(COLOR_BG));
+        drawText("IP: " + deviceIP, SCREEN_W / 2,
                          CONTENT_Y + CONTENT_H / 2 + 30, 2);
     }
-    _tft.setTextDatum(TL_DATUM);
+    _gfx->setTextDatum(TL_DATUM);
 
-    setLED(true, false, false);  // Red LED on error
+    setLEDPattern(LED_PATTERN_ERROR);
 }
 
 void Display::drawStatusBar(bool wifiConnected, bool apiConnected,
                              const String& ip) {
-    _tft.fillRect(0, 0, SCREEN_W, STATUS_BAR_H, COLOR_HEADER_BG);
+    _gfx->fillRect(0, 0, SCREEN_W, STATUS_BAR_H, ink(COLOR_HEADER_BG));
 
-    _tft.setTextColor(COLOR_TEXT, COLOR_HEADER_BG);
-    _tft.drawString("TapeBackarr", 5, 3, 2);
+    _gfx->setTextColor(ink(COLOR_TEXT), ink(COLOR_HEADER_BG));
+    drawText("TapeBackarr", 5, 3, 2);
 
     // WiFi indicator
     uint16_t wifiColor = wifiConnected ? COLOR_SUCCESS : COLOR_ERROR;
-    _tft.fillCircle(SCREEN_W - 50, STATUS_BAR_H / 2, 4, wifiColor);
+    _gfx->fillCircle(SCREEN_W - 50, STATUS_BAR_H / 2, 4, ink(wifiColor));
+
+    if (_stale) {
+        _gfx->setTextColor(ink(COLOR_WARNING), ink(COLOR_HEADER_BG));
+        drawText("STALE", 110, 3, 2);
+    }
 
     // API indicator
-    uint16_t apiColor = apiConnected ? COLOR_SUCCESS : COLOR_ERROR;
-    _tft.fillCircle(SCREEN_W - 30, STATUS_BAR_H / 2, 4, apiColor);
+    uint16_t apiColor = _stale ? COLOR_WARNING
+                      : apiConnected ? COLOR_SUCCESS : COLOR_ERROR;
+    _gfx->fillCircle(SCREEN_W - 30, STATUS_BAR_H / 2, 4, ink(apiColor));
 
     // Connection label
-    _tft.setTextColor(COLOR_TEXT_DIM, COLOR_HEADER_BG);
-    _tft.drawString("W", SCREEN_W - 57, 4, 1);
-    _tft.drawString("A", SCREEN_W - 37, 4, 1);
+    _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_HEADER_BG));
+    drawText("W", SCREEN_W - 57, 4, 1);
+    drawText("A", SCREEN_W - 37, 4, 1);
 }
 
 void Display::drawTabBar(int activeTab) {
@@ -488,52 +557,93 @@ void Display::drawTabBar(int activeTab) {
         uint16_t bg = (i == activeTab) ? COLOR_TAB_ACTIVE : COLOR_TAB_INACTIVE;
         uint16_t fg = (i == activeTab) ? COLOR_BG : COLOR_TEXT_DIM;
 
-        _tft.fillRect(i * tabW, TAB_BAR_Y, tabW, TAB_BAR_H, bg);
-        _tft.setTextColor(fg, bg);
-        _tft.setTextDatum(MC_DATUM);
-        _tft.drawString(labels[i], i * tabW + tabW / 2,
+        _gfx->fillRect(i * tabW, TAB_BAR_Y, tabW, TAB_BAR_H, ink(bg));
+        _gfx->setTextColor(ink(fg), ink(bg));
+        _gfx->setTextDatum(MC_DATUM);
+        drawText(labels[i], i * tabW + tabW / 2,
                          TAB_BAR_Y + TAB_BAR_H / 2, 2);
     }
-    _tft.setTextDatum(TL_DATUM);
+    _gfx->setTextDatum(TL_DATUM);
 
     // Separator lines
     for (int i = 1; i < TAB_COUNT; i++) {
-        _tft.drawFastVLine(i * tabW, TAB_BAR_Y, TAB_BAR_H, COLOR_BG);
+        _gfx->drawFastVLine(i * tabW, TAB_BAR_Y, TAB_BAR_H, ink(COLOR_BG));
     }
 }
 
+bool Display::beginCanvas(int tab) {
+    lgfx::LGFX_Sprite* canvas = _cache.canvas();
+    if (!canvas) return false;
+    _renderStart = micros();
+    _gfx = canvas;
+    _gfx->fillScreen(ink(COLOR_BG));
+    drawTabBar(tab);
+    return true;
+}
+
+bool Display::endCanvas(int tab) {
+    _gfx = &_tft;
+    _cache.store(tab);
+
+    RenderTiming& t = _timing[tab];
+    t.renderLastUs = micros() - _renderStart;
+    t.renderTotalUs += t.renderLastUs;
+    t.renders++;
+    return _cache.has(tab);
+}
+
+uint16_t Display::ink(uint16_t color) const {
+    // Palette canvases take colour indices, the panel takes RGB565
+    return _gfx == &_tft ? color : _cache.paletteIndex(color);
+}
+
+void Display::drawText(const char* text, int x, int y, uint8_t font) {
+    _gfx->drawString(text, x, y, font);
+}
+
 void Display::clearContent() {
-    _tft.fillRect(0, CONTENT_Y, SCREEN_W, CONTENT_H, COLOR_BG);
+    _gfx->fillRect(0, CONTENT_Y, SCREEN_W, CONTENT_H, ink(COLOR_BG));
 }
 
 void Display::drawCard(int x, int y, int w, int h, const String& label,
                         const String& value, uint16_t valueColor) {
-    _tft.fillRoundRect(x, y, w, h, 4, COLOR_CARD_BG);
+    _gfx->fillRoundRect(x, y, w, h, 4, ink(COLOR_CARD_BG));
 
-    _tft.setTextColor(COLOR_TEXT_DIM, COLOR_CARD_BG);
-    _tft.setTextDatum(MC_DATUM);
-    _tft.drawString(label, x + w / 2, y + 14, 1);
+    _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_CARD_BG));
+    _gfx->setTextDatum(MC_DATUM);
+    drawText(label, x + w / 2, y + 14, 1);
 
-    _tft.setTextColor(valueColor, COLOR_CARD_BG);
-    _tft.drawString(value, x + w / 2, y + 34, 4);
+    _gfx->setTextColor(ink(valueColor), ink(COLOR_CARD_BG));
+    drawText(value, x + w / 2, y + 34, 4);
 
-    _tft.setTextDatum(TL_DATUM);
+    _gfx->setTextDatum(TL_DATUM);
 }
 
 void Display::drawProgressBar(int x, int y, int w, int h,
                                float pct, uint16_t color) {
     pct = constrain(pct, 0.0f, 1.0f);
-    _tft.fillRoundRect(x, y, w, h, h / 2, COLOR_PROGRESS_BG);
+    _gfx->fillRoundRect(x, y, w, h, h / 2, ink(COLOR_PROGRESS_BG));
     if (pct > 0.001f) {
         int filled = (int)(w * pct);
         if (filled < h) filled = h;  // Minimum visible width for round rect
-        _tft.fillRoundRect(x, y, filled, h, h / 2, color);
+        _gfx->fillRoundRect(x, y, filled, h, h / 2, ink(color));
     }
 }
 
+void Display::drawListPosition(size_t first, size_t shown, size_t total) {
+    if (shown >= total) return;  // Everything fits, nothing to scroll
+
+    // "1-2 of 5" right-aligned on the title line
+    String pos = String((int)first + 1) + "-" +
+                 String((int)(first + shown)) + " of " + String((int)total);
+    _gfx->setTextColor(ink(COLOR_TEXT_DIM), ink(COLOR_BG));
+    _gfx->setTextDatum(TR_DATUM);
+    drawText(pos, SCREEN_W - 10, CONTENT_Y + 10, 2);
+    _gfx->setTextDatum(TL_DATUM);
+}
+
 void Display::setBrightness(uint8_t pct) {
-    int duty = map(constrain(pct, 0, 100), 0, 100, 0, 255);
-    analogWrite(TFT_BL, duty);
+    _leds.setBacklight(pct);
 }
 
 bool Display::readTouch(uint16_t& x, uint16_t& y) {
@@ -554,17 +664,6 @@ int Display::getTabFromTouch(uint16_t x, uint16_t y) {
     return -1;
 }
 
-void Display::setLED(bool r, bool g, bool b) {
-    // Active LOW
-    digitalWrite(LED_RED, r ? LOW : HIGH);
-    digitalWrite(LED_GREEN, g ? LOW : HIGH);
-    digitalWrite(LED_BLUE, b ? LOW : HIGH);
-}
-
-void Display::alertLED(bool on) {
-    setLED(on, false, false);
-}
-
 String Display::formatBytes(int64_t bytes) {
     if (bytes < 1024) return String((int)bytes) + " B";
     if (bytes < 1048576) return String((float)bytes / 1024.0f, 1) + " KB";
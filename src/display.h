@@ -3,13 +3,10 @@
 #include <Arduino.h>
 #include "LGFX_Config.h"
 #include "api_client.h"
+#include "screen_cache.h"
+#include "led_controller.h"
 #include "wifi_manager.h"
 
-// CYD2USB RGB LED pins (active LOW)
-#define LED_RED   4
-#define LED_GREEN 16
-#define LED_BLUE  17
-
 // Display colors (RGB565)
 #define COLOR_BG          0x1082  // Dark background
 #define COLOR_CARD_BG     0x2104  // Card background
@@ -25,6 +22,16 @@
 #define COLOR_PROGRESS_BG 0x3186  // Progress bar background (lighter than card)
 #define COLOR_PROGRESS_FG 0x04FF  // Progress bar foreground
 
+// Time spent drawing a tab off-screen and pushing it to the panel
+struct RenderTiming {
+    uint32_t renders;
+    uint32_t renderLastUs;
+    uint64_t renderTotalUs;
+    uint32_t blits;
+    uint32_t blitLastUs;
+    uint64_t blitTotalUs;
+};
+
 enum DisplayScreen {
     SCREEN_BOOT,
     SCREEN_AP_MODE,
@@ -39,46 +46,89 @@ enum DisplayScreen {
 class Display {
 public:
     void begin();
-    void update();
 
     void showBoot(const String& version);
     void showAPMode(const String& apName, const String& ip);
     void showConnecting(const String& ssid);
     void showDashboard(const DashboardData& data);
-    void showActiveJobs(const std::vector<ActiveJobData>& jobs);
-    void showDrives(const std::vector<DriveData>& drives);
+    void showActiveJobs(const std::vector<ActiveJobData>& jobs,
+                        size_t first = 0);
+    void showDrives(const std::vector<DriveData>& drives, size_t first = 0);
     void showTapeAlert(const String& message);
     void showLTFSFormat(const LTFSFormatStatus& status);
     void showError(const String& error, const String& deviceIP = "");
 
+    // Tab screens rendered off-screen (no panel traffic) into the screen
+    // cache. Return false if the cache is unavailable.
+    bool renderDashboard(const DashboardData& data);
+    bool renderActiveJobs(const std::vector<ActiveJobData>& jobs,
+                          size_t first = 0);
+    bool renderDrives(const std::vector<DriveData>& drives, size_t first = 0);
+
+    // Put a pre-rendered tab on the panel with a single blit. Skipped if
+    // that frame is already shown. Returns false if the tab isn't cached.
+    bool showTab(int tab);
+
     void drawStatusBar(bool wifiConnected, bool apiConnected,
                        const String& ip);
+
+    // Tabs show data restored at boot rather than polled: flagged in the
+    // status bar of screens rendered from now on
+    void setStale(bool stale) { _stale = stale; }
+    bool isStale() const { return _stale; }
     void drawTabBar(int activeTab);
     void clearContent();
 
     void setBrightness(uint8_t pct);
+    void fadeBrightness(uint8_t pct, uint16_t ms) { _leds.setBacklight(pct, ms); }
 
     // Touch handling
     bool readTouch(uint16_t& x, uint16_t& y);
     int getTabFromTouch(uint16_t x, uint16_t y);
 
+    // Number of list rows that fit on the Jobs / Drives screens
+    static const size_t JOBS_PER_PAGE = 2;
+    static const size_t DRIVES_PER_PAGE = 3;
+
     DisplayScreen getCurrentScreen() const { return _currentScreen; }
+    const RenderTiming& getRenderTiming(int tab) const { return _timing[tab]; }
+
+#ifdef CYD_HOST
+    LGFX& getPanel() { return _tft; }
+#endif
 
     // LED control
-    void setLED(bool r, bool g, bool b);
-    void alertLED(bool on);
+    void setLEDPattern(LedPattern pattern) { _leds.setPattern(pattern); }
 
 private:
     LGFX _tft;
+    lgfx::LovyanGFX* _gfx = &_tft;   // Current draw target
+    ScreenCache _cache;
+    uint32_t _shownSerial = 0;       // Cache serial of the frame on the panel
     DisplayScreen _currentScreen = SCREEN_BOOT;
-    unsigned long _lastAlertBlink = 0;
-    bool _alertState = false;
+    bool _stale = false;
+    LedController _leds;
+    RenderTiming _timing[SCREEN_CACHE_SLOTS] = {};
+    unsigned long _renderStart = 0;
+
+    void drawDashboard(const DashboardData& data);
+    void drawActiveJobs(const std::vector<ActiveJobData>& jobs, size_t first);
+    void drawDrives(const std::vector<DriveData>& drives, size_t first);
+
+    bool beginCanvas(int tab);
+    bool endCanvas(int tab);
+    uint16_t ink(uint16_t color) const;
+    void drawText(const char* text, int x, int y, uint8_t font);
+    void drawText(const String& text, int x, int y, uint8_t font) {
+        drawText(text.c_str(), x, y, font);
+    }
 
     void drawHeader(const String& title);
     void drawCard(int x, int y, int w, int h, const String& label,
                   const String& value, uint16_t valueColor = COLOR_TEXT);
     void drawProgressBar(int x, int y, int w, int h,
                          float pct, uint16_t color = COLOR_PROGRESS_FG);
+    void drawListPosition(size_t first, size_t shown, size_t total);
     String formatBytes(int64_t bytes);
     String formatDuration(unsigned long seconds);
 };
@@ -0,0 +1,153 @@
+#include "heap_monitor.h"
+
+static const char* const TAG_NAMES[HEAP_TAG_COUNT] = {
+    "other", "api", "render", "web", "wifi"
+};
+
+struct WatchedTask {
+    TaskHandle_t task;
+    const char* name;
+    uint8_t tag;         // Changed by Scope
+};
+
+// Written by setup() only; _taskCount goes up after the slot is filled, so
+// the allocation hooks never see a half-written entry
+static WatchedTask _tasks[HEAP_MAX_TASKS];
+static volatile size_t _taskCount = 0;
+
+static portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+static HeapTagStats _tags[HEAP_TAG_COUNT];
+
+static HeapSample _history[HEAP_HISTORY];
+static size_t _head = 0;             // Next slot to write
+static size_t _samples = 0;
+static uint64_t _sampledBytes[HEAP_TAG_COUNT];   // Totals at the last sample
+static unsigned long _lastSample = 0;
+static bool _sampled = false;
+
+static int findTask(TaskHandle_t task) {
+    for (size_t i = 0; i < _taskCount; i++) {
+        if (_tasks[i].task == task) return i;
+    }
+    return -1;
+}
+
+// Runs inside every malloc: no allocation, no logging
+static void account(size_t size, bool failed) {
+    // Null before the scheduler starts (static constructors)
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    int slot = task ? findTask(task) : -1;
+    uint8_t tag = slot >= 0 ? _tasks[slot].tag : HEAP_OTHER;
+
+    portENTER_CRITICAL(&_mux);
+    HeapTagStats& t = _tags[tag];
+    t.allocs++;
+    t.bytes += size;
+    if (failed) t.failures++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+extern "C" {
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    void* p = __real_malloc(size);
+    account(size, !p && size);
+    return p;
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+    void* p = __real_calloc(n, size);
+    account(n * size, !p && n && size);
+    return p;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    void* p = __real_realloc(ptr, size);
+    account(size, !p && size);
+    return p;
+}
+
+}
+
+void HeapMonitor::watchTask(const char* name, HeapTag tag) {
+    TaskHandle_t task = name ? xTaskGetHandle(name) : xTaskGetCurrentTaskHandle();
+    if (!task || findTask(task) >= 0 || _taskCount >= HEAP_MAX_TASKS) return;
+
+    WatchedTask& w = _tasks[_taskCount];
+    w.task = task;
+    w.name = pcTaskGetName(task);
+    w.tag = tag;
+    _taskCount++;
+}
+
+void HeapMonitor::update() {
+    if (_sampled && millis() - _lastSample < HEAP_SAMPLE_MS) return;
+    _lastSample = millis();
+    _sampled = true;
+
+    HeapSample s;
+    s.uptimeS      = millis() / 1000;
+    s.freeBytes    = ESP.getFreeHeap();
+    s.largestBlock = ESP.getMaxAllocHeap();
+    s.minFree      = ESP.getMinFreeHeap();
+    for (int i = 0; i < HEAP_TAG_COUNT; i++) {
+        uint64_t bytes = getTagStats(i).bytes;
+        s.allocBytes[i] = bytes - _sampledBytes[i];
+        _sampledBytes[i] = bytes;
+    }
+
+    portENTER_CRITICAL(&_mux);
+    _history[_head] = s;
+    _head = (_head + 1) % HEAP_HISTORY;
+    if (_samples < HEAP_HISTORY) _samples++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+HeapTagStats HeapMonitor::getTagStats(uint8_t tag) {
+    portENTER_CRITICAL(&_mux);
+    HeapTagStats t = _tags[tag];
+    portEXIT_CRITICAL(&_mux);
+    return t;
+}
+
+size_t HeapMonitor::getHistory(HeapSample* out, size_t max) {
+    portENTER_CRITICAL(&_mux);
+    size_t n = min(_samples, max);
+    size_t first = (_head + HEAP_HISTORY - _samples) % HEAP_HISTORY;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = _history[(first + _samples - n + i) % HEAP_HISTORY];
+    }
+    portEXIT_CRITICAL(&_mux);
+    return n;
+}
+
+size_t HeapMonitor::getStacks(HeapTaskStack* out, size_t max) {
+    size_t n = min((size_t)_taskCount, max);
+    for (size_t i = 0; i < n; i++) {
+        out[i].name = _tasks[i].name;
+        // Bytes on ESP-IDF, where the stack type is one byte wide
+        out[i].freeBytes = uxTaskGetStackHighWaterMark(_tasks[i].task);
+    }
+    return n;
+}
+
+const char* HeapMonitor::tagName(uint8_t tag) {
+    return tag < HEAP_TAG_COUNT ? TAG_NAMES[tag] : "?";
+}
+
+HeapMonitor::Scope::Scope(HeapTag tag) {
+    _slot = findTask(xTaskGetCurrentTaskHandle());
+    _prev = HEAP_OTHER;
+    if (_slot >= 0) {
+        _prev = _tasks[_slot].tag;
+        _tasks[_slot].tag = tag;
+    }
+}
+
+HeapMonitor::Scope::~Scope() {
+    if (_slot >= 0) _tasks[_slot].tag = _prev;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define HEAP_SAMPLE_MS   600000  // One history sample per 10 min
+#define HEAP_HISTORY     144     // 24 h of samples
+#define HEAP_MAX_TASKS   8
+
+// Subsystem an allocation is charged to
+enum HeapTag : uint8_t {
+    HEAP_OTHER,
+    HEAP_API,        // HTTP client and JSON parsing (net task)
+    HEAP_RENDER,     // Drawing in loop()
+    HEAP_WEB,        // Request handlers (async_tcp) and snapshots
+    HEAP_WIFI,       // WiFi driver, lwIP and event tasks
+    HEAP_TAG_COUNT
+};
+
+// Since boot
+struct HeapTagStats {
+    uint32_t allocs;
+    uint64_t bytes;      // Requested, not live: frees are not tracked
+    uint32_t failures;   // Returned NULL
+};
+
+struct HeapSample {
+    uint32_t uptimeS;
+    uint32_t freeBytes;
+    uint32_t largestBlock;   // Fragmentation shows as this falling below free
+    uint32_t minFree;        // Lowest free heap since boot
+    uint32_t allocBytes[HEAP_TAG_COUNT];   // Requested since the previous sample
+};
+
+struct HeapTaskStack {
+    const char* name;
+    uint32_t freeBytes;      // Least free stack seen (high-water mark)
+};
+
+// Heap and stack telemetry, so a leak or fragmentation shows up in the
+// history within hours instead of as a crash weeks later.
+//
+// malloc, calloc and realloc are wrapped at link time (see build_flags)
+// and each call is charged to the subsystem of the calling task; loop()
+// switches its tag with Scope. Memory taken with heap_caps_malloc() or
+// newlib's internal allocator is not counted.
+class HeapMonitor {
+public:
+    // Charge allocations made by a task to tag and report its stack. By
+    // FreeRTOS task name; the calling task if name is nullptr. Call from
+    // setup() once the task is running.
+    static void watchTask(const char* name, HeapTag tag);
+
+    // Call from loop(): takes a sample every HEAP_SAMPLE_MS
+    static void update();
+
+    static HeapTagStats getTagStats(uint8_t tag);
+    static size_t getHistory(HeapSample* out, size_t max);   // Oldest first
+    static size_t getStacks(HeapTaskStack* out, size_t max);
+    static const char* tagName(uint8_t tag);
+
+    // Charges the calling task's allocations to tag while in scope. The
+    // task must be watched.
+    class Scope {
+    public:
+        explicit Scope(HeapTag tag);
+        ~Scope();
+
+    private:
+        int _slot;
+        uint8_t _prev;
+    };
+};
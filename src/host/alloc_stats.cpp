@@ -0,0 +1,80 @@
+#include "alloc_stats.h"
+
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+static AllocStats _stats;
+
+static void added(void* p) {
+    if (!p) return;
+    _stats.allocs++;
+    _stats.liveBytes += malloc_usable_size(p);
+    if (_stats.liveBytes > _stats.peakBytes) _stats.peakBytes = _stats.liveBytes;
+}
+
+static void removed(void* p) {
+    if (!p) return;
+    _stats.frees++;
+    _stats.liveBytes -= malloc_usable_size(p);
+}
+
+extern "C" {
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    void* p = __real_malloc(size);
+    added(p);
+    return p;
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+    void* p = __real_calloc(n, size);
+    added(p);
+    return p;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    size_t old = ptr ? malloc_usable_size(ptr) : 0;
+    void* p = __real_realloc(ptr, size);
+    if (!p && size) return p;    // Failed: ptr is still allocated
+    if (ptr) {
+        _stats.frees++;
+        _stats.liveBytes -= old;
+    }
+    added(p);
+    return p;
+}
+
+void __wrap_free(void* ptr) {
+    removed(ptr);
+    __real_free(ptr);
+}
+
+}
+
+// libstdc++'s operator new calls malloc from inside the shared library,
+// where the wrap does not reach
+void* operator new(size_t size) {
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+AllocStats allocStats() {
+    return _stats;
+}
+
+void resetAllocPeak() {
+    _stats.peakBytes = _stats.liveBytes;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+// Host build: heap use of the whole program, counted by wrapping malloc,
+// calloc, realloc and free at link time (-Wl,--wrap=..., see the native
+// environments in platformio.ini). Single-threaded use only.
+
+#include <cstddef>
+#include <cstdint>
+
+struct AllocStats {
+    uint64_t allocs;     // malloc / calloc / realloc calls that returned memory
+    uint64_t frees;
+    size_t liveBytes;    // Usable size of the blocks still allocated
+    size_t peakBytes;    // Highest liveBytes since the last resetAllocPeak()
+};
+
+AllocStats allocStats();
+
+// Start a new peak from the current live bytes
+void resetAllocPeak();
@@ -0,0 +1,259 @@
+/*
+ * Host API parse benchmark
+ *
+ * Runs the firmware's response parser over recorded TapeBackarr responses
+ * and over synthetic large ones, and reports per case the body size, parse
+ * time, peak heap and allocation count of one parse.
+ *
+ * Usage: program [--fixtures DIR] [--iterations N] [--csv FILE]
+ *   --fixtures DIR   Recorded responses, one file per endpoint (default
+ *                    fixtures/api)
+ *   --iterations N   Timed parses per case (default 50)
+ *   --csv FILE       Also write the results as CSV
+ *
+ * Exit status is non-zero if a response fails to parse or gives a
+ * different number of items than expected.
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include "api_parser.h"
+#include "host/alloc_stats.h"
+
+// Parses a body, sets the number of items it yielded
+typedef std::function<DeserializationError(const std::string& body, size_t& items)> ParseFn;
+
+struct BenchCase {
+    std::string name;
+    std::string body;
+    ParseFn parse;
+    size_t expectItems;
+};
+
+struct BenchResult {
+    bool ok;
+    String error;
+    size_t items;
+    double avgUs;
+    double minUs;
+    size_t peakBytes;    // Above what was live before the parse
+    uint64_t allocs;
+};
+
+static const ParseFn PARSE_DASHBOARD = [](const std::string& b, size_t& items) {
+    DashboardData d;
+    DeserializationError err = parseDashboard(b.data(), b.size(), d);
+    items = d.valid ? 1 : 0;
+    return err;
+};
+
+static const ParseFn PARSE_JOBS = [](const std::string& b, size_t& items) {
+    std::vector<ActiveJobData> jobs;
+    DeserializationError err = parseActiveJobs(b.data(), b.size(), jobs);
+    items = jobs.size();
+    return err;
+};
+
+static const ParseFn PARSE_DRIVES = [](const std::string& b, size_t& items) {
+    std::vector<DriveData> drives;
+    DeserializationError err = parseDrives(b.data(), b.size(), drives);
+    items = drives.size();
+    return err;
+};
+
+static const ParseFn PARSE_EVENTS = [](const std::string& b, size_t& items) {
+    std::vector<TapeChangeData> changes;
+    DeserializationError err = parseTapeChanges(b.data(), b.size(), changes);
+    items = changes.size();
+    return err;
+};
+
+static const ParseFn PARSE_LTFS = [](const std::string& b, size_t& items) {
+    LTFSFormatStatus status;
+    DeserializationError err = parseLTFSFormatStatus(b.data(), b.size(), status);
+    items = status.valid ? 1 : 0;
+    return err;
+};
+
+static bool readFile(const std::string& path, std::string& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    char buf[4096];
+    size_t n;
+    out.clear();
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+static void appendf(std::string& out, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void appendf(std::string& out, const char* fmt, ...) {
+    char buf[1024];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    out += buf;
+}
+
+// Synthetic responses in the server's layout, sized like a large library
+
+static std::string syntheticJobs(int count) {
+    static const char* const PHASES[] = { "scanning", "streaming", "cataloging" };
+    std::string s = "[";
+    for (int i = 0; i < count; i++) {
+        appendf(s, "%s{\"job_id\":%d,\"job_name\":\"backup-set-%04d\",\"phase\":\"%s\","
+                   "\"status\":\"running\",\"message\":\"Writing to tape\","
+                   "\"file_count\":%d,\"total_files\":%d,\"total_bytes\":%lld,"
+                   "\"bytes_written\":%lld,\"write_speed\":%d.5,"
+                   "\"tape_label\":\"LTO9-%06d\",\"tape_capacity_bytes\":18000000000000,"
+                   "\"tape_used_bytes\":%lld,\"estimated_seconds_remaining\":%d.0,"
+                   "\"tape_estimated_seconds_remaining\":%d.0,"
+                   "\"start_time\":\"2025-06-02T01:00:04Z\",\"updated_at\":\"2025-06-02T03:02:41Z\","
+                   "\"scan_files_found\":%d,\"scan_dirs_scanned\":%d,\"scan_bytes_found\":%lld}",
+                i ? "," : "", i + 1, i, PHASES[i % 3], i * 371, i * 811 + 1000,
+                (long long)i * 10995116277LL + 1099511627776LL,
+                (long long)i * 4398046511LL, 250000000 + i * 1000, 100000 + i,
+                (long long)i * 17000000000LL, 3600 + i * 7, 7200 + i * 3,
+                i * 811, i * 37, (long long)i * 10995116277LL);
+    }
+    return s + "]";
+}
+
+static std::string syntheticDrives(int count) {
+    static const char* const STATUS[] = { "ready", "busy", "offline", "error" };
+    std::string s = "[";
+    for (int i = 0; i < count; i++) {
+        appendf(s, "%s{\"id\":%d,\"display_name\":\"Library A Drive %d\",\"vendor\":\"IBM\","
+                   "\"model\":\"ULT3580-HH9\",\"serial_number\":\"10WT%06d\","
+                   "\"device_path\":\"/dev/nst%d\",\"status\":\"%s\","
+                   "\"current_tape\":\"LTO9-%06d\",\"format_type\":\"%s\",\"enabled\":%s,"
+                   "\"last_cleaned\":null,\"created_at\":\"2024-11-02T10:12:00Z\"}",
+                i ? "," : "", i + 1, i + 1, i, i, STATUS[i % 4], 200 + i,
+                i % 2 ? "raw" : "ltfs", i % 8 ? "true" : "false");
+    }
+    return s + "]";
+}
+
+// Every 50th event is a tape change request
+static std::string syntheticEvents(int count) {
+    std::string s = "[";
+    for (int i = 0; i < count; i++) {
+        const char* type = i % 50 == 49 ? (i % 100 == 99 ? "tape_full" : "tape_change_required")
+                         : i % 2 ? "tape_loaded" : "job_progress";
+        appendf(s, "%s{\"id\":%d,\"type\":\"%s\",\"status\":\"%s\",\"job_id\":%d,"
+                   "\"tape_id\":%d,\"message\":\"Event %d for job %d\","
+                   "\"created_at\":\"2025-06-02T%02d:%02d:%02dZ\"}",
+                i ? "," : "", 100000 + i, type, i % 50 == 49 ? "pending" : "info",
+                i % 500, 100 + i % 64, i, i % 500, (i / 3600) % 24, (i / 60) % 60, i % 60);
+    }
+    return s + "]";
+}
+
+static BenchResult run(const BenchCase& c, int iterations) {
+    BenchResult r = {};
+
+    // One parse alone for memory, so timing noise never mixes in
+    AllocStats before = allocStats();
+    resetAllocPeak();
+    DeserializationError err = c.parse(c.body, r.items);
+    AllocStats after = allocStats();
+    r.peakBytes = after.peakBytes - before.liveBytes;
+    r.allocs = after.allocs - before.allocs;
+
+    r.ok = !err && r.items == c.expectItems;
+    if (err) r.error = err.c_str();
+    else if (!r.ok) r.error = String("expected ") + String((unsigned long)c.expectItems) +
+                              " items, got " + String((unsigned long)r.items);
+    if (err) return r;
+
+    double total = 0;
+    r.minUs = 1e12;
+    for (int i = 0; i < iterations; i++) {
+        size_t items;
+        auto start = std::chrono::steady_clock::now();
+        c.parse(c.body, items);
+        double us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count();
+        total += us;
+        r.minUs = min(r.minUs, us);
+    }
+    r.avgUs = total / iterations;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    std::string fixtures = "fixtures/api";
+    std::string csvPath;
+    int iterations = 50;
+
+    for (int i = 1; i < argc; i++) {
+        String arg = argv[i];
+        if (arg == "--fixtures" && i + 1 < argc) fixtures = argv[++i];
+        else if (arg == "--iterations" && i + 1 < argc) iterations = max(1, atoi(argv[++i]));
+        else if (arg == "--csv" && i + 1 < argc) csvPath = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--fixtures DIR] [--iterations N] [--csv FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Recorded responses and the items each must give
+    struct Recorded {
+        const char* file;
+        ParseFn parse;
+        size_t expectItems;
+    };
+    static const Recorded RECORDED[] = {
+        { "dashboard.json",          PARSE_DASHBOARD, 1 },
+        { "jobs_active.json",        PARSE_JOBS,      2 },
+        { "drives.json",             PARSE_DRIVES,    2 },
+        { "events.json",             PARSE_EVENTS,    1 },
+        { "ltfs_format_status.json", PARSE_LTFS,      1 },
+    };
+
+    std::vector<BenchCase> cases;
+    int failures = 0;
+    for (const Recorded& rec : RECORDED) {
+        BenchCase c;
+        c.name = rec.file;
+        c.name = c.name.substr(0, c.name.find('.'));
+        if (!readFile(fixtures + "/" + rec.file, c.body)) {
+            fprintf(stderr, "%s: cannot read %s/%s\n", c.name.c_str(), fixtures.c_str(), rec.file);
+            failures++;
+            continue;
+        }
+        c.parse = rec.parse;
+        c.expectItems = rec.expectItems;
+        cases.push_back(c);
+    }
+    cases.push_back({ "jobs_500",    syntheticJobs(500),     PARSE_JOBS,   500 });
+    cases.push_back({ "drives_64",   syntheticDrives(64),    PARSE_DRIVES, 64 });
+    cases.push_back({ "events_10k",  syntheticEvents(10000), PARSE_EVENTS, 200 });
+
+    FILE* csv = csvPath.empty() ? nullptr : fopen(csvPath.c_str(), "w");
+    if (csv) fprintf(csv, "case,body_bytes,items,avg_us,min_us,peak_bytes,allocs,ok\n");
+
+    printf("%-20s %10s %6s %10s %10s %10s %8s  %s\n", "case", "body", "items",
+           "avg_us", "min_us", "peak", "allocs", "result");
+
+    for (const BenchCase& c : cases) {
+        BenchResult r = run(c, iterations);
+        if (!r.ok) failures++;
+
+        printf("%-20s %10zu %6zu %10.1f %10.1f %10zu %8llu  %s\n", c.name.c_str(),
+               c.body.size(), r.items, r.avgUs, r.minUs, r.peakBytes,
+               (unsigned long long)r.allocs, r.ok ? "ok" : r.error.c_str());
+        if (csv) {
+            fprintf(csv, "%s,%zu,%zu,%.1f,%.1f,%zu,%llu,%d\n", c.name.c_str(),
+                    c.body.size(), r.items, r.avgUs, r.minUs, r.peakBytes,
+                    (unsigned long long)r.allocs, r.ok ? 1 : 0);
+        }
+    }
+    if (csv) fclose(csv);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+// Host build: in-memory stand-in for the CYD's ILI9341.
+//
+// Panel_Host keeps the frame in an RGB565 sprite buffer and counts what
+// each drawing primitive would have pushed over SPI, so renders can be
+// snapshotted and costed without hardware.
+
+#include <Arduino.h>
+#include <LovyanGFX.hpp>
+#include <atomic>
+
+// ILI9341 address-window overhead: CASET + 4, PASET + 4, RAMWR
+#define PANEL_WINDOW_BYTES 11
+#define PANEL_SPI_HZ       55000000UL   // freq_write in LGFX_Config.h
+
+struct PanelCost {
+    uint32_t pixels = 0;    // Pixels written to panel GRAM
+    uint32_t windows = 0;   // Address windows opened
+    uint32_t calls = 0;     // Drawing primitives that reached the panel
+
+    uint64_t bytes() const {
+        return (uint64_t)pixels * 2 + (uint64_t)windows * PANEL_WINDOW_BYTES;
+    }
+    // Wire time at the configured SPI clock, ignoring CS/DC gaps
+    uint32_t wireMicros() const {
+        return (uint32_t)(bytes() * 8 * 1000000ULL / PANEL_SPI_HZ);
+    }
+};
+
+class Panel_Host : public lgfx::Panel_Sprite {
+public:
+    const PanelCost& cost() const { return _cost; }
+    void resetCost() { _cost = PanelCost(); }
+
+    void drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y,
+                             uint32_t rawcolor) override {
+        count(1, 1);
+        lgfx::Panel_Sprite::drawPixelPreclipped(x, y, rawcolor);
+    }
+
+    void writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y,
+                                 uint_fast16_t w, uint_fast16_t h,
+                                 uint32_t rawcolor) override {
+        count((uint32_t)w * h, 1);
+        lgfx::Panel_Sprite::writeFillRectPreclipped(x, y, w, h, rawcolor);
+    }
+
+    void setWindow(uint_fast16_t xs, uint_fast16_t ys,
+                   uint_fast16_t xe, uint_fast16_t ye) override {
+        _cost.windows++;
+        lgfx::Panel_Sprite::setWindow(xs, ys, xe, ye);
+    }
+
+    void writeBlock(uint32_t rawcolor, uint32_t len) override {
+        count(len, 0);
+        lgfx::Panel_Sprite::writeBlock(rawcolor, len);
+    }
+
+    void writePixels(lgfx::pixelcopy_t* param, uint32_t len,
+                     bool use_dma) override {
+        count(len, 0);
+        lgfx::Panel_Sprite::writePixels(param, len, use_dma);
+    }
+
+    void writeImage(uint_fast16_t x, uint_fast16_t y,
+                    uint_fast16_t w, uint_fast16_t h,
+                    lgfx::pixelcopy_t* param, bool use_dma) override {
+        count((uint32_t)w * h, 1);
+        lgfx::Panel_Sprite::writeImage(x, y, w, h, param, use_dma);
+    }
+
+    void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y,
+                  uint_fast16_t w, uint_fast16_t h,
+                  uint_fast16_t src_x, uint_fast16_t src_y) override {
+        // Read back and write again over the bus
+        count((uint32_t)w * h * 2, 2);
+        lgfx::Panel_Sprite::copyRect(dst_x, dst_y, w, h, src_x, src_y);
+    }
+
+private:
+    PanelCost _cost;
+
+    void count(uint32_t pixels, uint32_t windows) {
+        _cost.pixels += pixels;
+        _cost.windows += windows;
+        _cost.calls++;
+    }
+};
+
+class LGFX : public lgfx::LGFX_Device {
+    Panel_Host _panel_instance;
+public:
+    LGFX() {
+        setPanel(&_panel_instance);
+    }
+
+    bool init() {
+        // Native orientation is portrait, as on the real panel
+        _panel_instance.createSprite(240, 320, &_write_conv, false);
+        return lgfx::LGFX_Device::init();
+    }
+
+    Panel_Host& panel() { return _panel_instance; }
+
+    // A pen on the digitizer, in screen coordinates; the simulator's
+    // driver thread moves it while the touch task samples
+    void setPen(bool down, uint16_t x = 0, uint16_t y = 0) {
+        _pen = down ? 0x80000000u | (uint32_t)x << 16 | y : 0;
+    }
+
+    uint_fast8_t getTouch(lgfx::touch_point_t* tp, uint_fast8_t count = 1) {
+        uint32_t pen = _pen;
+        if (!(pen & 0x80000000u) || !count) return 0;
+        // Mirrored like the real digitizer; Display::readTouch flips it back
+        tp->x = width() - 1 - ((pen >> 16) & 0x7fff);
+        tp->y = pen & 0xffff;
+        tp->size = 1;
+        tp->id = 0;
+        return 1;
+    }
+
+private:
+    std::atomic<uint32_t> _pen{0};
+};
@@ -0,0 +1,163 @@
+#include "png_image.h"
+
+#include <cstdio>
+#include <cstring>
+
+static const uint8_t PNG_SIG[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+static const size_t STORED_BLOCK_MAX = 65535;
+
+static uint32_t crcTable[256];
+
+static void initCRC() {
+    if (crcTable[1]) return;
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crcTable[n] = c;
+    }
+}
+
+static uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0) {
+    crc ^= 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static void put32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(v >> 24);
+    out.push_back(v >> 16);
+    out.push_back(v >> 8);
+    out.push_back(v);
+}
+
+static uint32_t get32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void putChunk(std::vector<uint8_t>& out, const char* type,
+                     const std::vector<uint8_t>& data) {
+    put32(out, (uint32_t)data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    put32(out, crc32(&out[start], out.size() - start));
+}
+
+bool writePNG(const std::string& path, const RGB565Image& img) {
+    initCRC();
+
+    // Filter byte 0 + RGB888 per row
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)img.height * (img.width * 3 + 1));
+    for (int y = 0; y < img.height; y++) {
+        raw.push_back(0);
+        for (int x = 0; x < img.width; x++) {
+            uint16_t c = img.pixels[(size_t)y * img.width + x];
+            uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+            raw.push_back((r << 3) | (r >> 2));
+            raw.push_back((g << 2) | (g >> 4));
+            raw.push_back((b << 3) | (b >> 2));
+        }
+    }
+
+    // zlib stream of stored deflate blocks
+    std::vector<uint8_t> z = {0x78, 0x01};
+    uint32_t a = 1, b = 0;
+    for (size_t pos = 0; pos < raw.size() || pos == 0; ) {
+        size_t n = raw.size() - pos;
+        if (n > STORED_BLOCK_MAX) n = STORED_BLOCK_MAX;
+        bool last = pos + n >= raw.size();
+        z.push_back(last ? 1 : 0);
+        z.push_back(n & 0xFF);
+        z.push_back(n >> 8);
+        z.push_back(~n & 0xFF);
+        z.push_back((~n >> 8) & 0xFF);
+        z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + n);
+        for (size_t i = pos; i < pos + n; i++) {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        pos += n;
+        if (last) break;
+    }
+    put32(z, (b << 16) | a);
+
+    std::vector<uint8_t> ihdr;
+    put32(ihdr, img.width);
+    put32(ihdr, img.height);
+    ihdr.push_back(8);   // Bit depth
+    ihdr.push_back(2);   // Colour type: RGB
+    ihdr.push_back(0);   // Deflate
+    ihdr.push_back(0);   // Adaptive filtering
+    ihdr.push_back(0);   // No interlace
+
+    std::vector<uint8_t> out(PNG_SIG, PNG_SIG + sizeof(PNG_SIG));
+    putChunk(out, "IHDR", ihdr);
+    putChunk(out, "IDAT", z);
+    putChunk(out, "IEND", {});
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    fclose(f);
+    return ok;
+}
+
+bool readPNG(const std::string& path, RGB565Image& img) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::vector<uint8_t> buf;
+    uint8_t tmp[4096];
+    size_t n;
+    while ((n = fread(tmp, 1, sizeof(tmp), f)) > 0) buf.insert(buf.end(), tmp, tmp + n);
+    fclose(f);
+
+    if (buf.size() < 8 || memcmp(buf.data(), PNG_SIG, 8) != 0) return false;
+
+    std::vector<uint8_t> z;
+    size_t pos = 8;
+    while (pos + 12 <= buf.size()) {
+        uint32_t len = get32(&buf[pos]);
+        const char* type = (const char*)&buf[pos + 4];
+        const uint8_t* data = &buf[pos + 8];
+        if (pos + 12 + len > buf.size()) return false;
+        if (memcmp(type, "IHDR", 4) == 0) {
+            img.width = get32(data);
+            img.height = get32(data + 4);
+            if (data[8] != 8 || data[9] != 2 || data[12] != 0) return false;
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            z.insert(z.end(), data, data + len);
+        }
+        pos += 12 + len;
+    }
+
+    // Unpack stored deflate blocks
+    std::vector<uint8_t> raw;
+    size_t zp = 2;
+    for (;;) {
+        if (zp + 5 > z.size()) return false;
+        uint8_t hdr = z[zp];
+        if ((hdr & 0x06) != 0) return false;  // Compressed block
+        size_t len = z[zp + 1] | (z[zp + 2] << 8);
+        zp += 5;
+        if (zp + len > z.size()) return false;
+        raw.insert(raw.end(), z.begin() + zp, z.begin() + zp + len);
+        zp += len;
+        if (hdr & 1) break;
+    }
+
+    size_t stride = (size_t)img.width * 3 + 1;
+    if (raw.size() != stride * img.height) return false;
+    img.pixels.assign((size_t)img.width * img.height, 0);
+    for (int y = 0; y < img.height; y++) {
+        const uint8_t* row = &raw[y * stride];
+        if (row[0] != 0) return false;   // Only unfiltered rows
+        for (int x = 0; x < img.width; x++) {
+            const uint8_t* p = row + 1 + x * 3;
+            img.pixels[(size_t)y * img.width + x] =
+                ((p[0] >> 3) << 11) | ((p[1] >> 2) << 5) | (p[2] >> 3);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// Host build: minimal PNG I/O for render snapshots.
+//
+// Images are written as 8-bit RGB with uncompressed (stored) deflate
+// blocks, so no zlib is needed. readPNG only understands files written by
+// writePNG; regenerate goldens with the render tool if they were edited
+// elsewhere.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct RGB565Image {
+    int width = 0;
+    int height = 0;
+    std::vector<uint16_t> pixels;   // Row-major, width * height
+};
+
+bool writePNG(const std::string& path, const RGB565Image& img);
+bool readPNG(const std::string& path, RGB565Image& img);
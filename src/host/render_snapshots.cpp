@@ -0,0 +1,270 @@
+/*
+ * Host render tool
+ *
+ * Draws every Display screen from fixture data into the in-memory panel,
+ * writes PNG snapshots, compares them with golden images and reports the
+ * pixels / bytes each render would push to the ILI9341.
+ *
+ * Usage: program [--out DIR] [--golden DIR] [--update]
+ *   --out DIR     Where snapshots and report.csv are written (default
+ *                 snapshots/out)
+ *   --golden DIR  Golden images to compare against (default
+ *                 snapshots/golden)
+ *   --update      Overwrite the golden images with this run's output
+ *
+ * Exit status is non-zero if any snapshot differs from its golden image or
+ * has none (unless --update is given).
+ */
+
+#include <Arduino.h>
+#include <functional>
+#include <sys/stat.h>
+#include "display.h"
+#include "host/png_image.h"
+
+struct Fixture {
+    const char* name;
+    std::function<void(Display&)> draw;
+};
+
+struct RenderResult {
+    PanelCost first;    // Drawn coming from another screen
+    PanelCost repeat;   // Same screen redrawn with the same data
+    long diffPixels;    // -1 = no golden image
+};
+
+static DashboardData dashboardFixture(int64_t used, int64_t total) {
+    DashboardData d = {};
+    d.totalTapes = 48;
+    d.activeTapes = 12;
+    d.fullTapes = 30;
+    d.totalJobs = 17;
+    d.activeJobs = 2;
+    d.totalDrives = 2;
+    d.totalCapacityBytes = total;
+    d.usedCapacityBytes = used;
+    d.valid = true;
+    return d;
+}
+
+static ActiveJobData jobFixture(int id, const char* name, const char* phase) {
+    ActiveJobData j = {};
+    j.id = id;
+    j.name = name;
+    j.phase = phase;
+    j.status = "running";
+    j.fileCount = 182344;
+    j.totalFiles = 402113;
+    j.totalBytes = 5497558138880LL;
+    j.bytesWritten = 2199023255552LL;
+    j.writeSpeed = 301989888.0;
+    j.tapeLabel = "LTO9-000123";
+    j.tapeCapacityBytes = 18000000000000LL;
+    j.tapeUsedBytes = 14200000000000LL;
+    j.estimatedSecondsRemaining = 10931;
+    j.tapeEstimatedSecondsRemaining = 12560;
+    j.scanFilesFound = 99120;
+    j.scanDirsScanned = 4410;
+    j.scanBytesFound = 1319413953331LL;
+    j.valid = true;
+    return j;
+}
+
+static DriveData driveFixture(int id, const char* name, const char* status,
+                              const char* tape, const char* format) {
+    DriveData d = {};
+    d.id = id;
+    d.displayName = name;
+    d.vendor = "IBM";
+    d.model = "ULT3580-HH9";
+    d.status = status;
+    d.currentTape = tape;
+    d.formatType = format;
+    d.devicePath = "/dev/nst0";
+    d.enabled = true;
+    d.valid = true;
+    return d;
+}
+
+static std::vector<Fixture> buildFixtures() {
+    std::vector<ActiveJobData> twoJobs = {
+        jobFixture(1, "Nightly NAS full", "streaming"),
+        jobFixture(2, "Photos incremental", "scanning"),
+    };
+    std::vector<ActiveJobData> fiveJobs = twoJobs;
+    fiveJobs.push_back(jobFixture(3, "Mail archive", "cataloging"));
+    fiveJobs.push_back(jobFixture(4, "VM images", "initializing"));
+    fiveJobs.push_back(jobFixture(5, "Scratch", "failed"));
+
+    std::vector<DriveData> drives = {
+        driveFixture(1, "LTO-9 Bay 1", "busy", "LTO9-000123", "ltfs"),
+        driveFixture(2, "LTO-9 Bay 2", "ready", "None", ""),
+        driveFixture(3, "LTO-7 Shelf", "error", "LTO7-000044", "raw"),
+    };
+
+    LTFSFormatStatus ltfs = {};
+    ltfs.active = true;
+    ltfs.phase = "verifying";
+    ltfs.devicePath = "/dev/sg3";
+    ltfs.progressPct = 64;
+    ltfs.elapsedSec = 754;
+    ltfs.valid = true;
+
+    return {
+        {"boot", [](Display& d) { d.showBoot("v0.0.0-host"); }},
+        {"ap_mode", [](Display& d) { d.showAPMode("TapeBackarr-CYD", "192.168.4.1"); }},
+        {"connecting", [](Display& d) { d.showConnecting("rack-iot"); }},
+        {"dashboard", [](Display& d) {
+            d.showDashboard(dashboardFixture(412316860416LL, 864691128455168LL));
+        }},
+        {"dashboard_full", [](Display& d) {
+            d.showDashboard(dashboardFixture(835628837404672LL, 864691128455168LL));
+        }},
+        {"dashboard_blit", [](Display& d) {
+            // Tab switch from the screen cache
+            d.renderDashboard(dashboardFixture(412316860416LL, 864691128455168LL));
+            d.showTab(0);
+        }},
+        {"jobs_empty", [](Display& d) { d.showActiveJobs({}); }},
+        {"jobs", [twoJobs](Display& d) { d.showActiveJobs(twoJobs); }},
+        {"jobs_scrolled", [fiveJobs](Display& d) { d.showActiveJobs(fiveJobs, 2); }},
+        {"drives", [drives](Display& d) { d.showDrives(drives); }},
+        {"drives_empty", [](Display& d) { d.showDrives({}); }},
+        {"tape_alert", [](Display& d) { d.showTapeAlert("tape_full"); }},
+        {"ltfs_format", [ltfs](Display& d) { d.showLTFSFormat(ltfs); }},
+        {"error", [](Display& d) {
+            d.showDashboard(dashboardFixture(0, 0));
+            d.showError("connection refused", "10.0.40.17");
+        }},
+    };
+}
+
+static RGB565Image capture(LGFX& tft) {
+    RGB565Image img;
+    img.width = tft.width();
+    img.height = tft.height();
+    img.pixels.resize((size_t)img.width * img.height);
+    for (int y = 0; y < img.height; y++) {
+        for (int x = 0; x < img.width; x++) {
+            img.pixels[(size_t)y * img.width + x] = tft.readPixel(x, y);
+        }
+    }
+    return img;
+}
+
+static long compareGolden(const RGB565Image& img, const std::string& goldenPath,
+                          const std::string& diffPath) {
+    RGB565Image golden;
+    if (!readPNG(goldenPath, golden)) return -1;
+    if (golden.width != img.width || golden.height != img.height) {
+        return (long)img.pixels.size();
+    }
+
+    long diff = 0;
+    RGB565Image marked = img;
+    for (size_t i = 0; i < img.pixels.size(); i++) {
+        if (img.pixels[i] != golden.pixels[i]) {
+            diff++;
+            marked.pixels[i] = COLOR_ERROR;
+        } else {
+            // Dim unchanged pixels so the differences stand out
+            marked.pixels[i] = (img.pixels[i] >> 2) & 0x39E7;
+        }
+    }
+    if (diff > 0) writePNG(diffPath, marked);
+    return diff;
+}
+
+int main(int argc, char** argv) {
+    std::string outDir = "snapshots/out";
+    std::string goldenDir = "snapshots/golden";
+    bool update = false;
+
+    for (int i = 1; i < argc; i++) {
+        String arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) outDir = argv[++i];
+        else if (arg == "--golden" && i + 1 < argc) goldenDir = argv[++i];
+        else if (arg == "--update") update = true;
+        else {
+            fprintf(stderr, "usage: %s [--out DIR] [--golden DIR] [--update]\n", argv[0]);
+            return 2;
+        }
+    }
+    mkdir(outDir.c_str(), 0755);
+    if (update) mkdir(goldenDir.c_str(), 0755);
+
+    Display display;
+    display.begin();
+    Panel_Host& panel = display.getPanel().panel();
+
+    FILE* csv = fopen((outDir + "/report.csv").c_str(), "w");
+    if (csv) {
+        fprintf(csv, "screen,first_pixels,first_windows,first_bytes,first_us,"
+                     "repeat_pixels,repeat_windows,repeat_bytes,repeat_us,diff_pixels\n");
+    }
+
+    printf("%-16s %10s %10s %8s | %10s %10s %8s | %s\n", "screen",
+           "pixels", "bytes", "spi_us", "pixels", "bytes", "spi_us", "golden");
+
+    int failures = 0, missing = 0;
+    for (const Fixture& f : buildFixtures()) {
+        RenderResult r;
+
+        // Arrive from a different screen so the first draw is a full one
+        if (String(f.name) == "boot") display.showConnecting("");
+        else display.showBoot("");
+
+        panel.resetCost();
+        f.draw(display);
+        r.first = panel.cost();
+        RGB565Image img = capture(display.getPanel());
+
+        panel.resetCost();
+        f.draw(display);
+        r.repeat = panel.cost();
+
+        std::string png = outDir + "/" + f.name + ".png";
+        std::string golden = goldenDir + "/" + f.name + ".png";
+        writePNG(png, img);
+        if (update) {
+            writePNG(golden, img);
+            r.diffPixels = 0;
+        } else {
+            r.diffPixels = compareGolden(img, golden, outDir + "/" + f.name + ".diff.png");
+        }
+
+        const char* verdict = r.diffPixels < 0 ? "missing"
+                            : r.diffPixels == 0 ? "ok" : "DIFF";
+        if (r.diffPixels > 0) failures++;
+        if (r.diffPixels < 0) missing++;
+
+        printf("%-16s %10u %10llu %8u | %10u %10llu %8u | %s",
+               f.name, r.first.pixels, (unsigned long long)r.first.bytes(),
+               r.first.wireMicros(), r.repeat.pixels,
+               (unsigned long long)r.repeat.bytes(), r.repeat.wireMicros(),
+               verdict);
+        if (r.diffPixels > 0) printf(" (%ld px)", r.diffPixels);
+        printf("\n");
+
+        if (csv) {
+            fprintf(csv, "%s,%u,%u,%llu,%u,%u,%u,%llu,%u,%ld\n", f.name,
+                    r.first.pixels, r.first.windows,
+                    (unsigned long long)r.first.bytes(), r.first.wireMicros(),
+                    r.repeat.pixels, r.repeat.windows,
+                    (unsigned long long)r.repeat.bytes(), r.repeat.wireMicros(),
+                    r.diffPixels);
+        }
+    }
+
+    if (csv) fclose(csv);
+    if (update) return 0;
+    if (missing) {
+        printf("%d snapshot(s) have no golden image in %s "
+               "(run with --update and commit them)\n", missing, goldenDir.c_str());
+    }
+    if (failures) {
+        printf("%d snapshot(s) differ from %s "
+               "(re-run with --update to accept)\n", failures, goldenDir.c_str());
+    }
+    return failures || missing ? 1 : 0;
+}
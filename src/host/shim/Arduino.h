@@ -0,0 +1,76 @@
+#pragma once
+
+// Host build: just enough of the Arduino core for the firmware sources
+// that are compiled natively (rendering, parsing, simulation).
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "WString.h"
+#include <freertos/FreeRTOS.h>
+
+#define HIGH   1
+#define LOW    0
+#define INPUT  0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define IRAM_ATTR
+#define PROGMEM
+#define PGM_P const char*
+#define FPSTR(p) (p)
+#define F(s) (s)
+
+using std::min;
+using std::max;
+
+#ifndef constrain
+#define constrain(amt, low, high) \
+    ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+class HostSerial {
+public:
+    void begin(unsigned long) {}
+    size_t print(const String& s) { return fputs(s.c_str(), stdout) >= 0 ? s.length() : 0; }
+    size_t print(const char* s) { return fputs(s, stdout) >= 0 ? strlen(s) : 0; }
+    size_t print(int v) { return print(String(v)); }
+    size_t print(unsigned long v) { return print(String(v)); }
+    // Anything with toString(), as Printable is printed (IPAddress)
+    template <typename T>
+    auto print(const T& v) -> decltype(v.toString(), size_t()) { return print(v.toString()); }
+    size_t println() { return print("\n"); }
+    template <typename T> size_t println(const T& v) { return print(v) + println(); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vprintf(fmt, ap);
+        va_end(ap);
+        return n > 0 ? (size_t)n : 0;
+    }
+};
+
+extern HostSerial Serial;
@@ -0,0 +1,10 @@
+#pragma once
+
+// Host build: api_client.h includes this header, but the render tool does
+// not link the HTTP transport.
+
+#include <Arduino.h>
+
+#define HTTP_CODE_OK 200
+
+class HTTPClient;
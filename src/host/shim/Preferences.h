@@ -0,0 +1,8 @@
+#pragma once
+
+// Host build: SettingsManager holds a Preferences member; the render tool
+// never loads settings.
+
+#include <Arduino.h>
+
+class Preferences {};
@@ -0,0 +1,107 @@
+#include "WString.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+static std::string toBase(unsigned long long v, unsigned char base, bool neg) {
+    if (base < 2 || base > 36) base = 10;
+    char buf[72];
+    int i = sizeof(buf) - 1;
+    buf[i] = '\0';
+    do {
+        int d = (int)(v % base);
+        buf[--i] = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+        v /= base;
+    } while (v);
+    if (neg) buf[--i] = '-';
+    return std::string(&buf[i]);
+}
+
+static std::string signedToBase(long long v, unsigned char base) {
+    // Arduino prints negative values in base 10 only; other bases show
+    // the two's-complement bit pattern.
+    if (v < 0 && base == 10) return toBase(0ULL - (unsigned long long)v, base, true);
+    return toBase((unsigned long long)v, base, false);
+}
+
+String::String(int v, unsigned char base) : _s(signedToBase(v, base)) {}
+String::String(unsigned int v, unsigned char base) : _s(toBase(v, base, false)) {}
+String::String(long v, unsigned char base) : _s(signedToBase(v, base)) {}
+String::String(unsigned long v, unsigned char base) : _s(toBase(v, base, false)) {}
+String::String(long long v, unsigned char base) : _s(signedToBase(v, base)) {}
+String::String(unsigned long long v, unsigned char base) : _s(toBase(v, base, false)) {}
+
+String::String(float v, unsigned int decimals) : String((double)v, decimals) {}
+
+String::String(double v, unsigned int decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    _s = buf;
+}
+
+bool String::endsWith(const String& suffix) const {
+    if (suffix._s.length() > _s.length()) return false;
+    return _s.compare(_s.length() - suffix._s.length(), std::string::npos,
+                      suffix._s) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t p = _s.find(c, from);
+    return p == std::string::npos ? -1 : (int)p;
+}
+
+int String::indexOf(const String& s, unsigned int from) const {
+    size_t p = _s.find(s._s, from);
+    return p == std::string::npos ? -1 : (int)p;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t p = _s.rfind(c);
+    return p == std::string::npos ? -1 : (int)p;
+}
+
+String String::substring(unsigned int from) const {
+    if (from >= _s.length()) return String();
+    return String(_s.substr(from));
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= _s.length()) return String();
+    if (to > _s.length()) to = _s.length();
+    return String(_s.substr(from, to - from));
+}
+
+void String::replace(const String& find, const String& with) {
+    if (find._s.empty()) return;
+    size_t pos = 0;
+    while ((pos = _s.find(find._s, pos)) != std::string::npos) {
+        _s.replace(pos, find._s.length(), with._s);
+        pos += with._s.length();
+    }
+}
+
+void String::trim() {
+    size_t b = 0, e = _s.length();
+    while (b < e && isspace((unsigned char)_s[b])) b++;
+    while (e > b && isspace((unsigned char)_s[e - 1])) e--;
+    _s = _s.substr(b, e - b);
+}
+
+void String::toLowerCase() {
+    for (auto& c : _s) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+    for (auto& c : _s) c = (char)toupper((unsigned char)c);
+}
+
+long String::toInt() const {
+    return strtol(_s.c_str(), nullptr, 10);
+}
+
+float String::toFloat() const {
+    return strtof(_s.c_str(), nullptr);
+}
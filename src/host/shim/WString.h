@@ -0,0 +1,82 @@
+#pragma once
+
+// Host build: the subset of Arduino's String used by the firmware,
+// backed by std::string.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+class String {
+public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    String(int v, unsigned char base = 10);
+    String(unsigned int v, unsigned char base = 10);
+    String(long v, unsigned char base = 10);
+    String(unsigned long v, unsigned char base = 10);
+    String(long long v, unsigned char base = 10);
+    String(unsigned long long v, unsigned char base = 10);
+    String(float v, unsigned int decimals = 2);
+    String(double v, unsigned int decimals = 2);
+
+    unsigned int length() const { return (unsigned int)_s.length(); }
+    bool isEmpty() const { return _s.empty(); }
+    const char* c_str() const { return _s.c_str(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+    char operator[](unsigned int i) const { return i < _s.length() ? _s[i] : 0; }
+    char& operator[](unsigned int i) { return _s[i]; }
+    char charAt(unsigned int i) const { return (*this)[i]; }
+
+    String& operator=(const char* s) { _s = s ? s : ""; return *this; }
+
+    String& operator+=(const String& rhs) { _s += rhs._s; return *this; }
+    String& operator+=(const char* rhs) { if (rhs) _s += rhs; return *this; }
+    String& operator+=(char c) { _s += c; return *this; }
+    String& operator+=(int v) { return *this += String(v); }
+    String& operator+=(unsigned int v) { return *this += String(v); }
+    String& operator+=(long v) { return *this += String(v); }
+    String& operator+=(unsigned long v) { return *this += String(v); }
+    bool concat(const String& s) { _s += s._s; return true; }
+    bool concat(const char* s, unsigned int len) { _s.append(s, len); return true; }
+
+    bool equals(const String& s) const { return _s == s._s; }
+    bool operator==(const String& rhs) const { return _s == rhs._s; }
+    bool operator==(const char* rhs) const { return _s == (rhs ? rhs : ""); }
+    bool operator!=(const String& rhs) const { return !(*this == rhs); }
+    bool operator!=(const char* rhs) const { return !(*this == rhs); }
+    bool operator<(const String& rhs) const { return _s < rhs._s; }
+    bool startsWith(const String& prefix) const { return _s.compare(0, prefix._s.length(), prefix._s) == 0; }
+    bool endsWith(const String& suffix) const;
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String& s, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+
+    void replace(const String& find, const String& with);
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+
+    long toInt() const;
+    float toFloat() const;
+
+    friend String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+    friend String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+    friend String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+    friend String operator+(const String& a, char c) { String r(a); r += c; return r; }
+    friend String operator+(const String& a, int v) { String r(a); r += v; return r; }
+    friend String operator+(const String& a, unsigned long v) { String r(a); r += v; return r; }
+
+    const std::string& str() const { return _s; }
+
+private:
+    std::string _s;
+};
+
+typedef String StringSumHelper;
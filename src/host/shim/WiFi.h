@@ -0,0 +1,9 @@
+#pragma once
+
+// Host build: wifi_manager.h includes this header; the render tool never
+// brings the radio up.
+
+#include <Arduino.h>
+
+typedef int arduino_event_id_t;
+typedef struct {} arduino_event_info_t;
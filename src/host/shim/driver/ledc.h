@@ -0,0 +1,50 @@
+#pragma once
+
+// Host build: LEDC register-level driver reduced to no-ops. Only the calls
+// made by led_controller.cpp are provided.
+
+#include <cstdint>
+
+#define ESP_OK 0
+typedef int esp_err_t;
+
+typedef enum { LEDC_LOW_SPEED_MODE } ledc_mode_t;
+typedef enum { LEDC_TIMER_0, LEDC_TIMER_1, LEDC_TIMER_2, LEDC_TIMER_3 } ledc_timer_t;
+typedef enum {
+    LEDC_CHANNEL_0, LEDC_CHANNEL_1, LEDC_CHANNEL_2, LEDC_CHANNEL_3,
+    LEDC_CHANNEL_4, LEDC_CHANNEL_5, LEDC_CHANNEL_6, LEDC_CHANNEL_7
+} ledc_channel_t;
+typedef enum { LEDC_TIMER_13_BIT = 13 } ledc_timer_bit_t;
+typedef enum { LEDC_AUTO_CLK, LEDC_USE_APB_CLK, LEDC_USE_REF_TICK } ledc_clk_cfg_t;
+typedef enum { LEDC_INTR_DISABLE } ledc_intr_type_t;
+typedef enum { LEDC_FADE_NO_WAIT, LEDC_FADE_WAIT_DONE } ledc_fade_mode_t;
+
+typedef struct {
+    ledc_mode_t speed_mode;
+    ledc_timer_bit_t duty_resolution;
+    ledc_timer_t timer_num;
+    uint32_t freq_hz;
+    ledc_clk_cfg_t clk_cfg;
+} ledc_timer_config_t;
+
+typedef struct {
+    int gpio_num;
+    ledc_mode_t speed_mode;
+    ledc_channel_t channel;
+    ledc_intr_type_t intr_type;
+    ledc_timer_t timer_sel;
+    uint32_t duty;
+    int hpoint;
+    struct { unsigned int output_invert : 1; } flags;
+} ledc_channel_config_t;
+
+inline esp_err_t ledc_timer_config(const ledc_timer_config_t*) { return ESP_OK; }
+inline esp_err_t ledc_channel_config(const ledc_channel_config_t*) { return ESP_OK; }
+inline esp_err_t ledc_fade_func_install(int) { return ESP_OK; }
+inline esp_err_t ledc_bind_channel_timer(ledc_mode_t, ledc_channel_t, ledc_timer_t) { return ESP_OK; }
+inline esp_err_t ledc_set_duty(ledc_mode_t, ledc_channel_t, uint32_t) { return ESP_OK; }
+inline esp_err_t ledc_update_duty(ledc_mode_t, ledc_channel_t) { return ESP_OK; }
+inline esp_err_t ledc_set_freq(ledc_mode_t, ledc_timer_t, uint32_t) { return ESP_OK; }
+inline esp_err_t ledc_timer_rst(ledc_mode_t, ledc_timer_t) { return ESP_OK; }
+inline esp_err_t ledc_set_duty_and_update(ledc_mode_t, ledc_channel_t, uint32_t, uint32_t) { return ESP_OK; }
+inline esp_err_t ledc_set_fade_time_and_start(ledc_mode_t, ledc_channel_t, uint32_t, uint32_t, ledc_fade_mode_t) { return ESP_OK; }
@@ -0,0 +1,50 @@
+#pragma once
+
+// Host simulator: the shim's Arduino core, plus what the rest of the
+// firmware needs from it (interrupts, the ESP object, IPAddress).
+
+#include_next <Arduino.h>
+#include "IPAddress.h"
+
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define digitalPinToInterrupt(pin) (pin)
+
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+bool setCpuFrequencyMhz(uint32_t mhz);
+uint32_t getCpuFrequencyMhz();
+
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+size_t strlcpy(char* dst, const char* src, size_t size);
+#endif
+
+// Device heap, reported as free space in the ESP32's ~320 KB. The host
+// process is charged only what it allocates after the simulator starts,
+// and the panel's frame buffer (GRAM on the device) is not counted.
+#define SIM_PANEL_BYTES (240 * 320 * 2)
+#define SIM_HEAP_BYTES  (320 * 1024 + SIM_PANEL_BYTES)
+
+class EspClass {
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap() { return _minFree; }
+    uint32_t getMaxAllocHeap() { return getFreeHeap(); }   // No fragmentation model
+    void restart();
+
+    // Simulator: live bytes on the host heap, and whether the firmware
+    // asked to reboot (the run stops at the end of that loop pass)
+    static size_t hostLiveBytes();
+    void setBaseline() { _baseline = hostLiveBytes(); _minFree = SIM_HEAP_BYTES; }
+    bool restartRequested() const { return _restart; }
+
+private:
+    size_t _baseline = 0;
+    uint32_t _minFree = SIM_HEAP_BYTES;
+    volatile bool _restart = false;
+};
+
+extern EspClass ESP;
+
+// Simulator: drive an input pin; attached interrupts fire on its edges
+void hostSetPin(uint8_t pin, int level);
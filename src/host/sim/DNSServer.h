@@ -0,0 +1,12 @@
+#pragma once
+
+// Host simulator: the captive-portal DNS never sees a client.
+
+#include <Arduino.h>
+
+class DNSServer {
+public:
+    bool start(uint16_t, const String&, const IPAddress&) { return true; }
+    void stop() {}
+    void processNextRequest() {}
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+// Host simulator: ESPAsyncWebServer without a listening socket. Routes
+// are registered as on the device; the driver hands requests to
+// handle() the way AsyncTCP would and reads the whole response back,
+// pulling chunked bodies through their filler like the TCP stack does.
+
+#include <Arduino.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "SPIFFS.h"
+
+typedef enum {
+    HTTP_GET  = 0b0001,
+    HTTP_POST = 0b0010,
+    HTTP_ANY  = 0b1111
+} WebRequestMethod;
+
+#define SIM_TCP_CHUNK  1436   // Bytes a chunked filler is asked for at a time
+
+typedef std::function<size_t(uint8_t* buf, size_t maxLen, size_t index)> AwsResponseFiller;
+
+class AsyncWebHeader {
+public:
+    AsyncWebHeader(const String& name, const String& value) : _name(name), _value(value) {}
+    const String& name() const { return _name; }
+    const String& value() const { return _value; }
+
+private:
+    String _name;
+    String _value;
+};
+
+class AsyncWebServerResponse {
+public:
+    AsyncWebServerResponse(int code, const String& contentType)
+        : _code(code), _contentType(contentType) {}
+    virtual ~AsyncWebServerResponse() {}
+
+    void addHeader(const String& name, const String& value) { _headers.emplace_back(name, value); }
+
+    int code() const { return _code; }
+    const String& contentType() const { return _contentType; }
+    const std::vector<AsyncWebHeader>& headers() const { return _headers; }
+
+    // The complete body, as it would go out on the wire
+    virtual String body() { return _body; }
+
+protected:
+    int _code;
+    String _contentType;
+    String _body;
+    std::vector<AsyncWebHeader> _headers;
+
+    friend class AsyncWebServerRequest;
+};
+
+class AsyncWebServerRequest {
+public:
+    AsyncWebServerRequest(WebRequestMethod method, const String& url)
+        : _method(method), _url(url) {}
+
+    WebRequestMethod method() const { return _method; }
+    const String& url() const { return _url; }
+
+    bool hasArg(const char* name) const;
+    const String& arg(const char* name) const;
+    const String& arg(const String& name) const { return arg(name.c_str()); }
+    bool hasHeader(const char* name) const { return getHeader(name) != nullptr; }
+    const AsyncWebHeader* getHeader(const char* name) const;
+
+    AsyncWebServerResponse* beginResponse(int code, const String& contentType = String(),
+                                          const String& content = String());
+    AsyncWebServerResponse* beginResponse(fs::FS& fs, const String& path,
+                                          const String& contentType = String(),
+                                          bool download = false);
+    AsyncWebServerResponse* beginChunkedResponse(const String& contentType,
+                                                 AwsResponseFiller filler);
+    void send(AsyncWebServerResponse* response) { _response.reset(response); }
+    void send(int code, const String& contentType = String(), const String& content = String()) {
+        send(beginResponse(code, contentType, content));
+    }
+    void redirect(const String& url);
+
+    // Simulator: build the request, read the answer
+    void addArg(const String& name, const String& value) { _args.emplace_back(name, value); }
+    void addHeader(const String& name, const String& value) { _headers.emplace_back(name, value); }
+    AsyncWebServerResponse* response() const { return _response.get(); }
+
+private:
+    WebRequestMethod _method;
+    String _url;
+    std::vector<AsyncWebHeader> _args;
+    std::vector<AsyncWebHeader> _headers;
+    std::unique_ptr<AsyncWebServerResponse> _response;
+};
+
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+
+class AsyncWebHandler {
+public:
+    virtual ~AsyncWebHandler() {}
+};
+
+class AsyncWebServer {
+public:
+    explicit AsyncWebServer(uint16_t port) : _port(port) {}
+
+    void begin() { _started = true; _instance = this; }
+    void end() { _started = false; }
+    AsyncWebHandler& on(const char* uri, WebRequestMethod method, ArRequestHandlerFunction fn);
+    void onNotFound(ArRequestHandlerFunction fn) { _notFound = fn; }
+    AsyncWebHandler& addHandler(AsyncWebHandler* handler) { return *handler; }
+
+    // Simulator: route a request like AsyncTCP would. False if the server
+    // was not started.
+    bool handle(AsyncWebServerRequest& request);
+
+    // The last server started, for the driver to reach
+    static AsyncWebServer* instance() { return _instance; }
+
+private:
+    struct Route {
+        String uri;
+        WebRequestMethod method;
+        ArRequestHandlerFunction fn;
+    };
+
+    uint16_t _port;
+    bool _started = false;
+    std::vector<Route> _routes;
+    ArRequestHandlerFunction _notFound;
+    AsyncWebHandler _handler;
+
+    static AsyncWebServer* _instance;
+};
+
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+
+class AsyncWebSocket;
+
+// A simulated viewer only counts what it is sent
+class AsyncWebSocketClient {
+public:
+    void text(const String& message);
+    uint32_t messages() const { return _messages; }
+    uint64_t bytes() const { return _bytes; }
+
+private:
+    uint32_t _messages = 0;
+    uint64_t _bytes = 0;
+};
+
+typedef std::function<void(AsyncWebSocket* server, AsyncWebSocketClient* client,
+                           AwsEventType type, void* arg, uint8_t* data, size_t len)> AwsEventHandler;
+
+class AsyncWebSocket : public AsyncWebHandler {
+public:
+    explicit AsyncWebSocket(const String& url) : _url(url) { _instance = this; }
+
+    void onEvent(AwsEventHandler handler) { _handler = handler; }
+    size_t count() const;
+    void textAll(const String& message);
+    void cleanupClients(uint16_t maxClients = 8) { (void)maxClients; }
+
+    // Simulator: viewers come and go from the driver thread
+    void connectClient();
+    void disconnectClient();
+    uint32_t messagesSent() const;
+    uint64_t bytesSent() const;
+
+    static AsyncWebSocket* instance() { return _instance; }
+
+private:
+    String _url;
+    AwsEventHandler _handler;
+    mutable std::mutex _mutex;
+    std::vector<std::unique_ptr<AsyncWebSocketClient>> _clients;
+    uint32_t _closedMessages = 0;   // Sent to viewers that have left
+    uint64_t _closedBytes = 0;
+
+    static AsyncWebSocket* _instance;
+};
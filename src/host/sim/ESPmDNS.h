@@ -0,0 +1,14 @@
+#pragma once
+
+#include <Arduino.h>
+#include "mdns.h"
+
+// Host simulator: advertising always succeeds and reaches no one
+class MDNSResponder {
+public:
+    bool begin(const char*) { return true; }
+    void end() {}
+    bool addService(const char*, const char*, uint16_t) { return true; }
+};
+
+extern MDNSResponder MDNS;
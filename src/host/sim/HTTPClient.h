@@ -0,0 +1,59 @@
+#pragma once
+
+// Host simulator: the ESP32 HTTPClient over plain POSIX sockets, so the
+// firmware polls a real server (tools/mock_server.py or TapeBackarr
+// itself). HTTP only; the connect and read timeouts are real time, as
+// the clock runs at wall-clock speed while a request is in flight.
+
+#include <Arduino.h>
+#include <vector>
+
+#define HTTP_CODE_OK 200
+
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED  (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED       (-4)
+#define HTTPC_ERROR_CONNECTION_LOST     (-5)
+#define HTTPC_ERROR_NO_STREAM           (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER      (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM        (-8)
+#define HTTPC_ERROR_ENCODING            (-9)
+#define HTTPC_ERROR_STREAM_WRITE        (-10)
+#define HTTPC_ERROR_READ_TIMEOUT        (-11)
+
+class HTTPClient {
+public:
+    ~HTTPClient() { end(); }
+
+    bool begin(const String& url);
+    void end();
+    void addHeader(const String& name, const String& value);
+    void setConnectTimeout(int32_t ms) { _connectTimeoutMs = ms; }
+    void setTimeout(uint16_t ms) { _timeoutMs = ms; }
+
+    int GET();
+    int getSize() const { return _contentLength; }
+    String getString();
+
+    static String errorToString(int error);
+
+private:
+    String _host;
+    uint16_t _port = 80;
+    String _path;
+    bool _https = false;
+    String _headers;
+    int32_t _connectTimeoutMs = 5000;
+    uint16_t _timeoutMs = 5000;
+
+    int _fd = -1;
+    std::vector<char> _buf;      // Read but not yet consumed
+    int _contentLength = -1;     // -1 = until the connection closes
+    bool _chunked = false;
+    int _readError = 0;          // Why the last read got nothing
+
+    int connect();
+    int readSome();              // > 0 bytes added, 0 closed, < 0 error
+    bool readLine(String& line);
+};
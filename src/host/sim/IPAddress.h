@@ -0,0 +1,43 @@
+#pragma once
+
+// Host simulator: IPv4 address as the ESP32 core stores it, first octet
+// in the low byte of the uint32_t (lwIP's network order in memory).
+
+#include <cstdint>
+#include <cstdio>
+#include "WString.h"
+
+class IPAddress {
+public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : _addr(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+    IPAddress(uint32_t addr) : _addr(addr) {}
+
+    operator uint32_t() const { return _addr; }
+    uint8_t operator[](int i) const { return (_addr >> (i * 8)) & 0xff; }
+    bool operator==(const IPAddress& rhs) const { return _addr == rhs._addr; }
+
+    bool fromString(const char* s) {
+        unsigned a, b, c, d;
+        char tail;
+        if (!s || sscanf(s, "%u.%u.%u.%u%c", &a, &b, &c, &d, &tail) != 4 ||
+            a > 255 || b > 255 || c > 255 || d > 255) {
+            return false;
+        }
+        *this = IPAddress(a, b, c, d);
+        return true;
+    }
+    bool fromString(const String& s) { return fromString(s.c_str()); }
+
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+        return buf;
+    }
+
+private:
+    uint32_t _addr = 0;
+};
+
+static const IPAddress INADDR_NONE(0, 0, 0, 0);
@@ -0,0 +1,50 @@
+#pragma once
+
+// Host simulator: NVS namespaces kept in one file on the host
+// (--nvs FILE), rewritten on every change, so settings, the link cache
+// and the warm-start blob survive from one run to the next like a power
+// cycle. Values are stored untyped.
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end() { _open = false; }
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBytes(const char* key, const void* value, size_t len);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+    size_t getBytesLength(const char* key);
+
+    size_t putString(const char* key, const String& value);
+    String getString(const char* key, const String& defaultValue = String());
+
+    size_t putBool(const char* key, bool value) { return putBytes(key, &value, sizeof(value)); }
+    bool getBool(const char* key, bool defaultValue = false) { return get(key, defaultValue); }
+    size_t putUChar(const char* key, uint8_t value) { return putBytes(key, &value, sizeof(value)); }
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return get(key, defaultValue); }
+    size_t putUShort(const char* key, uint16_t value) { return putBytes(key, &value, sizeof(value)); }
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0) { return get(key, defaultValue); }
+    size_t putInt(const char* key, int32_t value) { return putBytes(key, &value, sizeof(value)); }
+    int32_t getInt(const char* key, int32_t defaultValue = 0) { return get(key, defaultValue); }
+    size_t putUInt(const char* key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return get(key, defaultValue); }
+
+    // Simulator: file the namespaces live in; empty = memory only
+    static void setHostFile(const char* path);
+
+private:
+    String _ns;
+    bool _open = false;
+    bool _readOnly = false;
+
+    template <typename T>
+    T get(const char* key, T defaultValue) {
+        T value;
+        return getBytesLength(key) == sizeof(T) && getBytes(key, &value, sizeof(T))
+               ? value : defaultValue;
+    }
+};
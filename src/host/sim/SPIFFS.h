@@ -0,0 +1,75 @@
+#pragma once
+
+// Host simulator: SPIFFS backed by a directory on the host (--spiffs DIR).
+// Without one the partition is unformatted and begin() fails, as on a
+// board whose filesystem image was never uploaded.
+
+#include <Arduino.h>
+#include <memory>
+
+#define SIM_SPIFFS_BYTES  0x20000   // min_spiffs.csv
+
+namespace fs {
+
+struct FileImpl;
+
+class File {
+public:
+    File() {}
+    explicit File(std::shared_ptr<FileImpl> impl) : _impl(impl) {}
+
+    operator bool() const;
+    size_t read(uint8_t* buf, size_t len);
+    int read();
+    size_t write(const uint8_t* buf, size_t len);
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+    int available();
+    size_t size() const;
+    size_t position() const;
+    bool seek(uint32_t pos);
+    void flush();
+    void close();
+
+    const char* path() const;
+    const char* name() const;
+    bool isDirectory() const;
+    File openNextFile();
+
+private:
+    std::shared_ptr<FileImpl> _impl;
+};
+
+class FS {
+public:
+    File open(const char* path, const char* mode = "r", bool create = false);
+    File open(const String& path, const char* mode = "r", bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* from, const char* to);
+
+protected:
+    String _root;      // Host directory, empty = not mounted
+};
+
+}  // namespace fs
+
+using fs::File;
+
+class SPIFFSFS : public fs::FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/spiffs",
+               uint8_t maxOpenFiles = 10, const char* label = nullptr);
+    void end() { _root = ""; }
+    size_t totalBytes() { return SIM_SPIFFS_BYTES; }
+    size_t usedBytes();
+
+    // Simulator: host directory that holds the partition's files
+    static void setHostDir(const char* dir);
+};
+
+extern SPIFFSFS SPIFFS;
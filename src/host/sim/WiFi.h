@@ -0,0 +1,119 @@
+#pragma once
+
+// Host simulator: a station that associates with one simulated access
+// point. The driver takes the AP out of range and back to simulate
+// outages; connection results arrive as driver events after roughly the
+// delays a real association takes, delivered by process().
+
+#include <Arduino.h>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+typedef enum { WIFI_OFF, WIFI_STA, WIFI_AP, WIFI_AP_STA } wifi_mode_t;
+typedef enum { WIFI_PS_NONE, WIFI_PS_MIN_MODEM, WIFI_PS_MAX_MODEM } wifi_ps_type_t;
+typedef enum { WIFI_AUTH_OPEN, WIFI_AUTH_WEP, WIFI_AUTH_WPA_PSK, WIFI_AUTH_WPA2_PSK } wifi_auth_mode_t;
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+
+#define WIFI_SCAN_RUNNING  (-1)
+#define WIFI_SCAN_FAILED   (-2)
+
+// Disconnect reasons (wifi_err_reason_t)
+#define WIFI_REASON_ASSOC_LEAVE     8
+#define WIFI_REASON_BEACON_TIMEOUT  200
+#define WIFI_REASON_NO_AP_FOUND     201
+
+typedef enum {
+    ARDUINO_EVENT_WIFI_STA_CONNECTED,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP,
+    ARDUINO_EVENT_WIFI_STA_LOST_IP,
+    ARDUINO_EVENT_WIFI_SCAN_DONE,
+    ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+
+typedef union {
+    struct {
+        uint8_t reason;
+    } wifi_sta_disconnected;
+} arduino_event_info_t;
+
+typedef std::function<void(arduino_event_id_t, arduino_event_info_t)> WiFiEventFuncCb;
+
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t m);
+    wifi_mode_t getMode() const { return _mode; }
+    bool setHostname(const char*) { return true; }
+    bool persistent(bool) { return true; }
+    bool setAutoReconnect(bool) { return true; }
+    bool setSleep(wifi_ps_type_t ps) { _ps = ps; return true; }
+    int onEvent(WiFiEventFuncCb cb, arduino_event_id_t = ARDUINO_EVENT_MAX);
+
+    wl_status_t begin(const char* ssid, const char* pass = nullptr,
+                      int32_t channel = 0, const uint8_t* bssid = nullptr,
+                      bool connect = true);
+    bool config(IPAddress ip, IPAddress gateway, IPAddress subnet,
+                IPAddress dns = IPAddress());
+    bool disconnect(bool wifiOff = false);
+    bool isConnected() const { return _connected; }
+    wl_status_t status() const { return _connected ? WL_CONNECTED : WL_DISCONNECTED; }
+
+    bool softAP(const char* ssid, const char* pass = nullptr);
+    IPAddress softAPIP() const { return IPAddress(192, 168, 4, 1); }
+
+    IPAddress localIP() const { return _connected ? _ip : IPAddress(); }
+    IPAddress gatewayIP() const { return _connected ? _gateway : IPAddress(); }
+    IPAddress subnetMask() const { return _connected ? _subnet : IPAddress(); }
+    IPAddress dnsIP(int = 0) const { return _connected ? _dns : IPAddress(); }
+    const uint8_t* BSSID() const { return _connected ? SIM_BSSID : nullptr; }
+    int32_t channel() const { return _connected ? SIM_CHANNEL : 0; }
+    int8_t RSSI() const { return _connected ? _rssi : 0; }
+
+    int16_t scanNetworks(bool async = false, bool showHidden = false,
+                         bool passive = false, uint32_t msPerChannel = 300);
+    int16_t scanComplete();
+    void scanDelete() { _scanDoneAt = 0; }
+    String SSID(uint8_t i) const;
+    int8_t RSSI(uint8_t i) const;
+    wifi_auth_mode_t encryptionType(uint8_t i) const;
+
+    // Simulator controls, called from the driver
+    void setNetwork(const char* ssid) { _ssid = ssid; }
+    void setInRange(bool inRange);
+    void setSignal(int8_t rssi) { _rssi = rssi; }
+    void setDhcpDelay(uint32_t ms) { _dhcpMs = ms; }
+    bool isInRange() const { return _inRange; }
+    wifi_ps_type_t getSleepMode() const { return _ps; }
+    void process();       // Deliver the events that are due
+
+    static const uint8_t SIM_BSSID[6];
+    static const int32_t SIM_CHANNEL = 6;
+
+private:
+    struct PendingEvent {
+        unsigned long at;
+        arduino_event_id_t id;
+        uint8_t reason;
+    };
+
+    wifi_mode_t _mode = WIFI_OFF;
+    wifi_ps_type_t _ps = WIFI_PS_MIN_MODEM;
+    String _ssid = "sim-ap";
+    volatile bool _inRange = true;
+    volatile bool _connected = false;
+    volatile int8_t _rssi = -58;
+    bool _static = false;
+    uint32_t _dhcpMs = 200;                // DHCP offer/ack after association
+    IPAddress _ip, _gateway, _subnet, _dns;
+    unsigned long _scanDoneAt = 0;         // 0 = no scan
+
+    std::mutex _mutex;
+    std::vector<PendingEvent> _events;
+    std::vector<WiFiEventFuncCb> _handlers;
+
+    void post(unsigned long delayMs, arduino_event_id_t id, uint8_t reason = 0);
+    void dropPending();
+};
+
+extern WiFiClass WiFi;
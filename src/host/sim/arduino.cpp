@@ -0,0 +1,146 @@
+#include <Arduino.h>
+
+#include <malloc.h>
+#include <new>
+#include "sim_kernel.h"
+
+#define PIN_COUNT 40
+
+HostSerial Serial;
+EspClass ESP;
+
+unsigned long millis() {
+    return (unsigned long)(SimKernel::nowUs() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)SimKernel::nowUs();
+}
+
+void delay(unsigned long ms) {
+    SimKernel::sleep(ms);
+}
+
+void yield() {}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size) {
+        size_t n = min(len, size - 1);
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+// ── Pins and interrupts ────────────────────────────────────────────────
+
+struct PinState {
+    int level = HIGH;
+    void (*isr)(void*) = nullptr;
+    void* arg = nullptr;
+    int mode = 0;
+};
+
+static PinState _pins[PIN_COUNT];
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin < PIN_COUNT) _pins[pin].level = val;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < PIN_COUNT ? _pins[pin].level : LOW;
+}
+
+void analogWrite(uint8_t, int) {}
+
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode) {
+    if (pin >= PIN_COUNT) return;
+    _pins[pin].isr = isr;
+    _pins[pin].arg = arg;
+    _pins[pin].mode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin < PIN_COUNT) _pins[pin].isr = nullptr;
+}
+
+// The ISR runs in the caller's thread, which stands in for the interrupt
+void hostSetPin(uint8_t pin, int level) {
+    if (pin >= PIN_COUNT) return;
+    PinState& p = _pins[pin];
+    int was = p.level;
+    p.level = level;
+    if (!p.isr || was == level) return;
+
+    bool rising = level == HIGH;
+    if (p.mode == CHANGE || (p.mode == RISING && rising) || (p.mode == FALLING && !rising)) {
+        p.isr(p.arg);
+    }
+}
+
+static uint32_t _cpuMhz = 240;
+
+bool setCpuFrequencyMhz(uint32_t mhz) {
+    _cpuMhz = mhz;
+    return true;
+}
+
+uint32_t getCpuFrequencyMhz() {
+    return _cpuMhz;
+}
+
+// ── Heap ───────────────────────────────────────────────────────────────
+
+size_t EspClass::hostLiveBytes() {
+    return mallinfo2().uordblks;
+}
+
+uint32_t EspClass::getFreeHeap() {
+    size_t live = hostLiveBytes();
+    size_t used = live > _baseline ? live - _baseline : 0;
+    uint32_t free = used < SIM_HEAP_BYTES ? SIM_HEAP_BYTES - used : 0;
+    if (free < _minFree) _minFree = free;
+    return free;
+}
+
+void EspClass::restart() {
+    Serial.println("[sim] restart requested");
+    _restart = true;
+}
+
+// As on the ESP32, new and delete go through malloc and free, so the
+// wrapped allocator (HeapMonitor) sees C++ allocations too
+void* operator new(size_t size) {
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
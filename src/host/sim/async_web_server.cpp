@@ -0,0 +1,164 @@
+#include "ESPAsyncWebServer.h"
+
+#include <strings.h>
+
+AsyncWebServer* AsyncWebServer::_instance = nullptr;
+
+AsyncWebSocket* AsyncWebSocket::_instance = nullptr;
+
+// ── Requests ───────────────────────────────────────────────────────────
+
+bool AsyncWebServerRequest::hasArg(const char* name) const {
+    for (const AsyncWebHeader& a : _args) {
+        if (a.name() == name) return true;
+    }
+    return false;
+}
+
+const String& AsyncWebServerRequest::arg(const char* name) const {
+    static const String empty;
+    for (const AsyncWebHeader& a : _args) {
+        if (a.name() == name) return a.value();
+    }
+    return empty;
+}
+
+const AsyncWebHeader* AsyncWebServerRequest::getHeader(const char* name) const {
+    for (const AsyncWebHeader& h : _headers) {
+        if (strcasecmp(h.name().c_str(), name) == 0) return &h;
+    }
+    return nullptr;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const String& contentType,
+                                                             const String& content) {
+    AsyncWebServerResponse* response = new AsyncWebServerResponse(code, contentType);
+    response->_body = content;
+    return response;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(fs::FS& fs, const String& path,
+                                                             const String& contentType, bool) {
+    File f = fs.open(path.c_str(), "r");
+    if (!f) return beginResponse(404);
+
+    AsyncWebServerResponse* response = new AsyncWebServerResponse(200, contentType);
+    uint8_t buf[512];
+    size_t n;
+    while ((n = f.read(buf, sizeof(buf))) > 0) {
+        response->_body.concat((const char*)buf, n);
+    }
+    return response;
+}
+
+// Pulled a segment at a time until the filler returns 0, as AsyncTCP does
+class AsyncChunkedResponse : public AsyncWebServerResponse {
+public:
+    AsyncChunkedResponse(const String& contentType, AwsResponseFiller filler)
+        : AsyncWebServerResponse(200, contentType), _filler(filler) {}
+
+    String body() override {
+        if (_filler) {
+            uint8_t buf[SIM_TCP_CHUNK];
+            size_t n;
+            while ((n = _filler(buf, sizeof(buf), _index)) > 0) {
+                _body.concat((const char*)buf, n);
+                _index += n;
+            }
+            _filler = nullptr;
+        }
+        return _body;
+    }
+
+private:
+    AwsResponseFiller _filler;
+    size_t _index = 0;
+};
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginChunkedResponse(const String& contentType,
+                                                                    AwsResponseFiller filler) {
+    return new AsyncChunkedResponse(contentType, filler);
+}
+
+void AsyncWebServerRequest::redirect(const String& url) {
+    AsyncWebServerResponse* response = beginResponse(302);
+    response->addHeader("Location", url);
+    send(response);
+}
+
+// ── Server ─────────────────────────────────────────────────────────────
+
+AsyncWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethod method,
+                                    ArRequestHandlerFunction fn) {
+    _routes.push_back({ uri, method, fn });
+    return _handler;
+}
+
+bool AsyncWebServer::handle(AsyncWebServerRequest& request) {
+    if (!_started) return false;
+
+    // Exact path match; the query string was split off into args
+    for (const Route& r : _routes) {
+        if ((r.method & request.method()) && r.uri == request.url()) {
+            r.fn(&request);
+            return true;
+        }
+    }
+    if (_notFound) _notFound(&request);
+    else request.send(404);
+    return true;
+}
+
+// ── WebSocket ──────────────────────────────────────────────────────────
+
+void AsyncWebSocketClient::text(const String& message) {
+    _messages++;
+    _bytes += message.length();
+}
+
+size_t AsyncWebSocket::count() const {
+    std::lock_guard<std::mutex> lk(_mutex);
+    return _clients.size();
+}
+
+void AsyncWebSocket::textAll(const String& message) {
+    std::lock_guard<std::mutex> lk(_mutex);
+    for (auto& c : _clients) c->text(message);
+}
+
+void AsyncWebSocket::connectClient() {
+    AsyncWebSocketClient* client;
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _clients.emplace_back(new AsyncWebSocketClient());
+        client = _clients.back().get();
+    }
+    if (_handler) _handler(this, client, WS_EVT_CONNECT, nullptr, nullptr, 0);
+}
+
+void AsyncWebSocket::disconnectClient() {
+    std::unique_ptr<AsyncWebSocketClient> client;
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        if (_clients.empty()) return;
+        client = std::move(_clients.front());
+        _clients.erase(_clients.begin());
+        _closedMessages += client->messages();
+        _closedBytes += client->bytes();
+    }
+    if (_handler) _handler(this, client.get(), WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+}
+
+uint32_t AsyncWebSocket::messagesSent() const {
+    std::lock_guard<std::mutex> lk(_mutex);
+    uint32_t n = _closedMessages;
+    for (auto& c : _clients) n += c->messages();
+    return n;
+}
+
+uint64_t AsyncWebSocket::bytesSent() const {
+    std::lock_guard<std::mutex> lk(_mutex);
+    uint64_t n = _closedBytes;
+    for (auto& c : _clients) n += c->bytes();
+    return n;
+}
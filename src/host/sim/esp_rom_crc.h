@@ -0,0 +1,15 @@
+#pragma once
+
+// Host simulator: the ROM's CRC32 (IEEE 802.3, reflected), so NVS blobs
+// written by the simulator check out the same way as on the device.
+
+#include <cstdint>
+
+inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// Host simulator: loop pass times are measured by LatencyTracker; there
+// is nothing here to reset the process.
+
+#include <cstdint>
+
+#ifndef ESP_OK
+#define ESP_OK 0
+#endif
+typedef int esp_err_t;
+
+inline esp_err_t esp_task_wdt_init(uint32_t, bool) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_add(void*) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_reset() { return ESP_OK; }
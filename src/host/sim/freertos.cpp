@@ -0,0 +1,229 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/event_groups.h>
+
+#include <cstring>
+#include <map>
+#include <thread>
+#include <vector>
+#include "sim_kernel.h"
+
+#define LOOP_TASK_STACK  8192   // Arduino's loopTask
+
+// ── Critical sections ──────────────────────────────────────────────────
+
+// Any address unique to the thread will do as the owner
+static thread_local char _self;
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+    uintptr_t self = (uintptr_t)&_self;
+    if (mux->owner == self) {
+        mux->count++;
+        return;
+    }
+    uintptr_t unlocked = 0;
+    while (!__atomic_compare_exchange_n(&mux->owner, &unlocked, self, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        unlocked = 0;
+        std::this_thread::yield();
+    }
+    mux->count = 1;
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+    if (--mux->count == 0) __atomic_store_n(&mux->owner, 0, __ATOMIC_RELEASE);
+}
+
+BaseType_t xPortGetCoreID() {
+    return 1;
+}
+
+// ── Tasks ──────────────────────────────────────────────────────────────
+
+static std::map<TaskHandle_t, uint32_t> _stackDepth;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t entry, const char* name,
+                                   uint32_t stackDepth, void* arg,
+                                   UBaseType_t, TaskHandle_t* handle,
+                                   BaseType_t) {
+    TaskHandle_t task = SimKernel::startTask(name, entry, arg);
+    {
+        SimKernel::Lock lk = SimKernel::lock();
+        _stackDepth[task] = stackDepth;
+    }
+    if (handle) *handle = task;
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t entry, const char* name,
+                       uint32_t stackDepth, void* arg,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(entry, name, stackDepth, arg, priority, handle, 0);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    SimKernel::sleep(ticks);
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(SimKernel::nowUs() / 1000);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    return SimKernel::takeNotify(clearOnExit, ticks);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    SimKernel::notify(task);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken) {
+    SimKernel::notify(task);
+    if (woken) *woken = pdTRUE;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return SimKernel::currentTask();
+}
+
+TaskHandle_t xTaskGetHandle(const char* name) {
+    return SimKernel::findTask(name);
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+    return SimKernel::taskName(task ? task : SimKernel::currentTask());
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    if (!task) task = SimKernel::currentTask();
+    SimKernel::Lock lk = SimKernel::lock();
+    auto it = _stackDepth.find(task);
+    return it != _stackDepth.end() ? it->second : LOOP_TASK_STACK;
+}
+
+// ── Queues ─────────────────────────────────────────────────────────────
+
+// Fixed ring of items copied in and out, as FreeRTOS does
+struct SimQueue {
+    size_t length;
+    size_t itemSize;
+    std::vector<uint8_t> buf;
+    size_t head = 0;
+    size_t count = 0;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    SimQueue* q = new SimQueue();
+    q->length = length;
+    q->itemSize = itemSize;
+    q->buf.resize((size_t)length * itemSize);
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    SimQueue* q = static_cast<SimQueue*>(queue);
+    SimKernel::Lock lk = SimKernel::lock();
+    if (!SimKernel::wait(lk, [q] { return q->count < q->length; }, ticks)) return pdFALSE;
+
+    size_t slot = (q->head + q->count) % q->length;
+    memcpy(&q->buf[slot * q->itemSize], item, q->itemSize);
+    q->count++;
+    SimKernel::changed();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    SimQueue* q = static_cast<SimQueue*>(queue);
+    SimKernel::Lock lk = SimKernel::lock();
+    if (!SimKernel::wait(lk, [q] { return q->count > 0; }, ticks)) return pdFALSE;
+
+    memcpy(item, &q->buf[q->head * q->itemSize], q->itemSize);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    SimKernel::changed();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    SimKernel::Lock lk = SimKernel::lock();
+    return static_cast<SimQueue*>(queue)->count;
+}
+
+// ── Mutexes ────────────────────────────────────────────────────────────
+
+struct SimMutex {
+    TaskHandle_t holder = nullptr;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new SimMutex();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks) {
+    SimMutex* m = static_cast<SimMutex*>(mutex);
+    SimKernel::Lock lk = SimKernel::lock();
+    if (!SimKernel::wait(lk, [m] { return m->holder == nullptr; }, ticks)) return pdFALSE;
+    m->holder = SimKernel::currentTask();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+    SimMutex* m = static_cast<SimMutex*>(mutex);
+    SimKernel::Lock lk = SimKernel::lock();
+    if (m->holder != SimKernel::currentTask()) return pdFALSE;
+    m->holder = nullptr;
+    SimKernel::changed();
+    return pdTRUE;
+}
+
+// ── Event groups ───────────────────────────────────────────────────────
+
+struct SimEventGroup {
+    EventBits_t bits = 0;
+};
+
+EventGroupHandle_t xEventGroupCreate() {
+    return new SimEventGroup();
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    SimEventGroup* g = static_cast<SimEventGroup*>(group);
+    SimKernel::Lock lk = SimKernel::lock();
+    g->bits |= bits;
+    SimKernel::changed();
+    return g->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    SimEventGroup* g = static_cast<SimEventGroup*>(group);
+    SimKernel::Lock lk = SimKernel::lock();
+    EventBits_t before = g->bits;
+    g->bits &= ~bits;
+    SimKernel::changed();
+    return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    SimKernel::Lock lk = SimKernel::lock();
+    return static_cast<SimEventGroup*>(group)->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits,
+                                BaseType_t clearOnExit, BaseType_t waitForAll,
+                                TickType_t ticks) {
+    SimEventGroup* g = static_cast<SimEventGroup*>(group);
+    SimKernel::Lock lk = SimKernel::lock();
+    auto ready = [g, bits, waitForAll] {
+        return waitForAll ? (g->bits & bits) == bits : (g->bits & bits) != 0;
+    };
+    bool met = SimKernel::wait(lk, ready, ticks);
+    EventBits_t result = g->bits;
+    if (met && clearOnExit) {
+        g->bits &= ~bits;
+        SimKernel::changed();
+    }
+    return result;
+}
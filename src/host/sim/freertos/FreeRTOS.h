@@ -0,0 +1,40 @@
+#pragma once
+
+// Host simulator: the FreeRTOS API the firmware uses, on threads. Ticks
+// are milliseconds, as with CONFIG_FREERTOS_HZ=1000 on the ESP32.
+
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE   1
+#define pdFALSE  0
+#define pdPASS   pdTRUE
+#define pdFAIL   pdFALSE
+
+#define portMAX_DELAY       0xffffffffu
+#define portTICK_PERIOD_MS  1
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+#define configTICK_RATE_HZ  1000
+
+#define portYIELD_FROM_ISR(...) do {} while (0)
+
+// Recursive spinlock, as on the ESP32
+typedef struct {
+    volatile uintptr_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0, 0 }
+
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+
+#define portENTER_CRITICAL(mux)      vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)       vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux)  vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)   vPortExitCritical(mux)
+
+BaseType_t xPortGetCoreID();
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef void* EventGroupHandle_t;
+typedef uint32_t EventBits_t;
+
+#ifndef BIT0
+#define BIT0  (1u << 0)
+#define BIT1  (1u << 1)
+#define BIT2  (1u << 2)
+#define BIT3  (1u << 3)
+#endif
+
+EventGroupHandle_t xEventGroupCreate();
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits,
+                                BaseType_t clearOnExit, BaseType_t waitForAll,
+                                TickType_t ticks);
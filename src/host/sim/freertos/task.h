@@ -0,0 +1,29 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t entry, const char* name,
+                                   uint32_t stackDepth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t entry, const char* name,
+                       uint32_t stackDepth, void* arg,
+                       UBaseType_t priority, TaskHandle_t* handle);
+
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken);
+
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TaskHandle_t xTaskGetHandle(const char* name);
+const char* pcTaskGetName(TaskHandle_t task);
+
+// Host threads have no comparable stack: reports the depth the task was
+// created with, i.e. an untouched stack
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
@@ -0,0 +1,213 @@
+#include "HTTPClient.h"
+#include <WiFi.h>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "sim_kernel.h"
+
+// Socket calls block in real time; the kernel is told so the clock is
+// not moved past a request in flight
+struct IOScope {
+    IOScope() { SimKernel::beginIO(); }
+    ~IOScope() { SimKernel::endIO(); }
+};
+
+bool HTTPClient::begin(const String& url) {
+    end();
+    _headers = "";
+
+    int scheme = url.indexOf("://");
+    if (scheme < 0) return false;
+    _https = url.substring(0, scheme) == "https";
+    _port = _https ? 443 : 80;
+
+    String rest = url.substring(scheme + 3);
+    int slash = rest.indexOf('/');
+    String authority = slash < 0 ? rest : rest.substring(0, slash);
+    _path = slash < 0 ? String("/") : rest.substring(slash);
+
+    int colon = authority.indexOf(':');
+    if (colon >= 0) {
+        _host = authority.substring(0, colon);
+        _port = (uint16_t)authority.substring(colon + 1).toInt();
+    } else {
+        _host = authority;
+    }
+    return !_host.isEmpty();
+}
+
+void HTTPClient::end() {
+    if (_fd >= 0) close(_fd);
+    _fd = -1;
+    _buf.clear();
+    _contentLength = -1;
+    _chunked = false;
+    _readError = 0;
+}
+
+void HTTPClient::addHeader(const String& name, const String& value) {
+    _headers += name + ": " + value + "\r\n";
+}
+
+int HTTPClient::connect() {
+    if (_https) {
+        static bool warned = false;
+        if (!warned) Serial.println("[sim] HTTPS is not simulated; use an http:// server");
+        warned = true;
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    // No route without the link
+    if (!WiFi.isConnected()) return HTTPC_ERROR_CONNECTION_REFUSED;
+
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addr = nullptr;
+    if (getaddrinfo(_host.c_str(), String((unsigned int)_port).c_str(), &hints, &addr) != 0) {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+
+    _fd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+    bool ok = _fd >= 0;
+    if (ok) {
+        fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) | O_NONBLOCK);
+        if (::connect(_fd, addr->ai_addr, addr->ai_addrlen) < 0) {
+            ok = errno == EINPROGRESS;
+            pollfd p = { _fd, POLLOUT, 0 };
+            int err = 0;
+            socklen_t len = sizeof(err);
+            ok = ok && poll(&p, 1, _connectTimeoutMs) == 1 &&
+                 getsockopt(_fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0;
+        }
+    }
+    freeaddrinfo(addr);
+
+    if (!ok) {
+        end();
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    return 0;
+}
+
+int HTTPClient::readSome() {
+    pollfd p = { _fd, POLLIN, 0 };
+    int ready = poll(&p, 1, _timeoutMs);
+    if (ready <= 0) {
+        _readError = ready == 0 ? HTTPC_ERROR_READ_TIMEOUT : HTTPC_ERROR_CONNECTION_LOST;
+        return _readError;
+    }
+
+    char chunk[2048];
+    ssize_t n = recv(_fd, chunk, sizeof(chunk), 0);
+    if (n <= 0) {
+        _readError = HTTPC_ERROR_CONNECTION_LOST;
+        return n == 0 ? 0 : _readError;
+    }
+    _buf.insert(_buf.end(), chunk, chunk + n);
+    return (int)n;
+}
+
+bool HTTPClient::readLine(String& line) {
+    for (;;) {
+        for (size_t i = 0; i + 1 < _buf.size(); i++) {
+            if (_buf[i] == '\r' && _buf[i + 1] == '\n') {
+                line = String(std::string(_buf.data(), i));
+                _buf.erase(_buf.begin(), _buf.begin() + i + 2);
+                return true;
+            }
+        }
+        if (readSome() <= 0) return false;
+    }
+}
+
+int HTTPClient::GET() {
+    IOScope io;
+    int err = connect();
+    if (err) return err;
+
+    String request = "GET " + _path + " HTTP/1.1\r\n"
+                     "Host: " + _host + "\r\n"
+                     "User-Agent: ESP32HTTPClient\r\n"
+                     "Connection: close\r\n" + _headers + "\r\n";
+    size_t sent = 0;
+    while (sent < request.length()) {
+        pollfd p = { _fd, POLLOUT, 0 };
+        if (poll(&p, 1, _timeoutMs) != 1) return HTTPC_ERROR_SEND_HEADER_FAILED;
+        ssize_t n = send(_fd, request.c_str() + sent, request.length() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return HTTPC_ERROR_SEND_HEADER_FAILED;
+        sent += n;
+    }
+
+    // Status line, then headers up to the blank line
+    String line;
+    if (!readLine(line)) return _readError;
+    if (!line.startsWith("HTTP/1.")) return HTTPC_ERROR_NO_HTTP_SERVER;
+    int code = line.substring(9, 12).toInt();
+
+    for (;;) {
+        if (!readLine(line)) return _readError;
+        if (line.isEmpty()) break;
+        int colon = line.indexOf(':');
+        if (colon < 0) continue;
+        String name = line.substring(0, colon);
+        String value = line.substring(colon + 1);
+        name.toLowerCase();
+        value.trim();
+        value.toLowerCase();
+        if (name == "content-length") _contentLength = value.toInt();
+        else if (name == "transfer-encoding" && value == "chunked") _chunked = true;
+    }
+    return code > 0 ? code : HTTPC_ERROR_NO_HTTP_SERVER;
+}
+
+// Whatever arrived: a body cut short by a lost connection or a timeout
+// comes back incomplete, as on the device
+String HTTPClient::getString() {
+    if (_fd < 0) return String();
+    IOScope io;
+    std::string body;
+
+    if (_chunked) {
+        String line;
+        while (readLine(line)) {
+            long size = strtol(line.c_str(), nullptr, 16);
+            if (size <= 0) break;
+            while (_buf.size() < (size_t)size + 2 && readSome() > 0) {}
+            size_t n = min(_buf.size(), (size_t)size);
+            body.append(_buf.data(), n);
+            _buf.erase(_buf.begin(), _buf.begin() + min(_buf.size(), (size_t)size + 2));
+            if (n < (size_t)size) break;
+        }
+        return String(body);
+    }
+
+    while (_contentLength < 0 || _buf.size() < (size_t)_contentLength) {
+        if (readSome() <= 0) break;
+    }
+    size_t n = _contentLength < 0 ? _buf.size() : min(_buf.size(), (size_t)_contentLength);
+    body.assign(_buf.data(), n);
+    _buf.clear();
+    return String(body);
+}
+
+String HTTPClient::errorToString(int error) {
+    switch (error) {
+        case HTTPC_ERROR_CONNECTION_REFUSED:  return "connection refused";
+        case HTTPC_ERROR_SEND_HEADER_FAILED:  return "send header failed";
+        case HTTPC_ERROR_SEND_PAYLOAD_FAILED: return "send payload failed";
+        case HTTPC_ERROR_NOT_CONNECTED:       return "not connected";
+        case HTTPC_ERROR_CONNECTION_LOST:     return "connection lost";
+        case HTTPC_ERROR_NO_STREAM:           return "no stream";
+        case HTTPC_ERROR_NO_HTTP_SERVER:      return "no HTTP server";
+        case HTTPC_ERROR_TOO_LESS_RAM:        return "too less ram";
+        case HTTPC_ERROR_ENCODING:            return "Transfer-Encoding not supported";
+        case HTTPC_ERROR_STREAM_WRITE:        return "Stream write error";
+        case HTTPC_ERROR_READ_TIMEOUT:        return "read Timeout";
+        default:                              return String();
+    }
+}
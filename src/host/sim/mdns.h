@@ -0,0 +1,54 @@
+#pragma once
+
+// Host simulator: ESP-IDF mDNS queries on a LAN where nothing answers.
+// A query completes with no results once its timeout has passed, as the
+// real one does.
+
+#include <Arduino.h>
+
+typedef struct { uint32_t addr; } esp_ip4_addr_t;
+typedef struct {
+    union { esp_ip4_addr_t ip4; } u_addr;
+    uint8_t type;
+} esp_ip_addr_t;
+
+#define ESP_IPADDR_TYPE_V4 0
+
+typedef struct mdns_ip_addr_s {
+    esp_ip_addr_t addr;
+    struct mdns_ip_addr_s* next;
+} mdns_ip_addr_t;
+
+typedef struct mdns_result_s {
+    struct mdns_result_s* next;
+    char* instance_name;
+    char* hostname;
+    uint16_t port;
+    mdns_ip_addr_t* addr;
+} mdns_result_t;
+
+struct mdns_search_once_s {
+    unsigned long doneAt;
+};
+typedef struct mdns_search_once_s mdns_search_once_t;
+
+#define MDNS_TYPE_A    0x0001
+#define MDNS_TYPE_PTR  0x000C
+
+inline mdns_search_once_t* mdns_query_async_new(const char*, const char*, const char*,
+                                                uint16_t, uint32_t timeout, size_t) {
+    return new mdns_search_once_t{ millis() + timeout };
+}
+
+inline bool mdns_query_async_get_results(mdns_search_once_t* search, uint32_t,
+                                         mdns_result_t** results) {
+    if ((long)(millis() - search->doneAt) < 0) return false;
+    *results = nullptr;
+    return true;
+}
+
+inline void mdns_query_async_delete(mdns_search_once_t* search) {
+    delete search;
+}
+
+inline void mdns_query_results_free(mdns_result_t*) {}
@@ -0,0 +1,135 @@
+#include "Preferences.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// NVS keys are at most 15 characters, namespaces likewise
+#define NVS_KEY_MAX  15
+
+typedef std::map<std::string, std::vector<uint8_t>> Namespace;
+
+static std::mutex _mutex;
+static std::map<std::string, Namespace> _store;
+static std::string _hostFile;
+static bool _loaded = false;
+
+// One line per value: namespace, key, hex bytes
+static void load() {
+    _loaded = true;
+    FILE* f = _hostFile.empty() ? nullptr : fopen(_hostFile.c_str(), "r");
+    if (!f) return;
+
+    char ns[NVS_KEY_MAX + 2], key[NVS_KEY_MAX + 2];
+    static char hex[16384];
+    while (fscanf(f, "%16s %16s %16383s", ns, key, hex) == 3) {
+        std::vector<uint8_t>& value = _store[ns][key];
+        value.clear();
+        if (strcmp(hex, "-") == 0) continue;    // Empty value
+        for (size_t i = 0; hex[i] && hex[i + 1]; i += 2) {
+            unsigned byte;
+            sscanf(hex + i, "%2x", &byte);
+            value.push_back((uint8_t)byte);
+        }
+    }
+    fclose(f);
+}
+
+static void save() {
+    if (_hostFile.empty()) return;
+    std::string tmp = _hostFile + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (!f) return;
+    for (auto& ns : _store) {
+        for (auto& kv : ns.second) {
+            fprintf(f, "%s %s ", ns.first.c_str(), kv.first.c_str());
+            if (kv.second.empty()) fputc('-', f);
+            for (uint8_t b : kv.second) fprintf(f, "%02x", b);
+            fputc('\n', f);
+        }
+    }
+    fclose(f);
+    rename(tmp.c_str(), _hostFile.c_str());
+}
+
+void Preferences::setHostFile(const char* path) {
+    std::lock_guard<std::mutex> lk(_mutex);
+    _hostFile = path ? path : "";
+    _store.clear();
+    _loaded = false;
+}
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    if (!name || strlen(name) > NVS_KEY_MAX) return false;
+    std::lock_guard<std::mutex> lk(_mutex);
+    if (!_loaded) load();
+    _ns = name;
+    _open = true;
+    _readOnly = readOnly;
+    return true;
+}
+
+bool Preferences::clear() {
+    if (!_open || _readOnly) return false;
+    std::lock_guard<std::mutex> lk(_mutex);
+    _store.erase(_ns.c_str());
+    save();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!_open || _readOnly) return false;
+    std::lock_guard<std::mutex> lk(_mutex);
+    bool removed = _store[_ns.c_str()].erase(key) > 0;
+    if (removed) save();
+    return removed;
+}
+
+bool Preferences::isKey(const char* key) {
+    if (!_open) return false;
+    std::lock_guard<std::mutex> lk(_mutex);
+    const Namespace& ns = _store[_ns.c_str()];
+    return ns.find(key) != ns.end();
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    if (!_open || _readOnly || !key || strlen(key) > NVS_KEY_MAX) return 0;
+    std::lock_guard<std::mutex> lk(_mutex);
+    const uint8_t* p = static_cast<const uint8_t*>(value);
+    _store[_ns.c_str()][key].assign(p, p + len);
+    save();
+    return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    if (!_open) return 0;
+    std::lock_guard<std::mutex> lk(_mutex);
+    const Namespace& ns = _store[_ns.c_str()];
+    auto it = ns.find(key);
+    // Like NVS: a buffer too small for the value gets nothing
+    if (it == ns.end() || it->second.size() > maxLen) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!_open) return 0;
+    std::lock_guard<std::mutex> lk(_mutex);
+    const Namespace& ns = _store[_ns.c_str()];
+    auto it = ns.find(key);
+    return it == ns.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::putString(const char* key, const String& value) {
+    // Stored with its terminator, as NVS does
+    return putBytes(key, value.c_str(), value.length() + 1) ? value.length() : 0;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    size_t len = getBytesLength(key);
+    if (!len) return defaultValue;
+    std::vector<char> buf(len + 1, 0);
+    getBytes(key, buf.data(), len);
+    return String(buf.data());
+}
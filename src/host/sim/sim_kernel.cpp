@@ -0,0 +1,196 @@
+#include "sim_kernel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct SimTask {
+    std::string name;
+    uint32_t notify = 0;
+};
+
+struct Waiter {
+    const std::function<bool()>* ready;
+    uint64_t deadline;       // Clock value, UINT64_MAX = none
+    bool woken;
+};
+
+static std::mutex _mutex;
+static std::condition_variable _wake;
+static std::vector<SimTask*> _tasks;          // Never freed, like the tasks
+static std::vector<Waiter*> _waiters;
+static int _running = 0;                      // Tasks not blocked in wait()
+static int _io = 0;                           // Tasks in socket I/O
+static thread_local SimTask* _current = nullptr;
+
+// Clock = wall clock + offset; jumps only ever add to the offset
+static const auto _start = std::chrono::steady_clock::now();
+static std::atomic<int64_t> _offsetUs{0};
+
+static uint64_t clockUs() {
+    int64_t real = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - _start).count();
+    return (uint64_t)(real + _offsetUs.load(std::memory_order_relaxed));
+}
+
+// Lock held: wake every waiter pred() picks
+template <typename Pred>
+static void wakeWhere(Pred pred) {
+    bool any = false;
+    for (size_t i = 0; i < _waiters.size();) {
+        Waiter* w = _waiters[i];
+        if (pred(w)) {
+            w->woken = true;
+            _running++;
+            _waiters.erase(_waiters.begin() + i);
+            any = true;
+        } else {
+            i++;
+        }
+    }
+    if (any) _wake.notify_all();
+}
+
+// Lock held: if every task is blocked and no request is in flight, move
+// the clock to the earliest timeout and wake whoever it releases
+static void settle() {
+    if (_running > 0 || _io > 0 || _waiters.empty()) return;
+
+    uint64_t next = UINT64_MAX;
+    for (Waiter* w : _waiters) next = std::min(next, w->deadline);
+    if (next == UINT64_MAX) {
+        fprintf(stderr, "sim: every task is blocked with no timeout\n");
+        abort();
+    }
+
+    uint64_t now = clockUs();
+    if (next > now) _offsetUs += (int64_t)(next - now);
+    wakeWhere([](Waiter* w) { return clockUs() >= w->deadline; });
+}
+
+SimKernel::Lock SimKernel::lock() {
+    return Lock(_mutex);
+}
+
+uint64_t SimKernel::nowUs() {
+    return clockUs();
+}
+
+bool SimKernel::wait(Lock& lk, const std::function<bool()>& ready, uint32_t timeoutMs) {
+    uint64_t deadline = timeoutMs == UINT32_MAX ? UINT64_MAX
+                                                : clockUs() + (uint64_t)timeoutMs * 1000;
+    for (;;) {
+        if (ready()) return true;
+        if (clockUs() >= deadline) return false;
+
+        Waiter w = { &ready, deadline, false };
+        _waiters.push_back(&w);
+        _running--;
+        settle();
+
+        while (!w.woken) {
+            if (deadline == UINT64_MAX) {
+                _wake.wait(lk);
+                continue;
+            }
+            // Time also passes for real while another task computes or
+            // waits on the network
+            uint64_t now = clockUs();
+            if (now >= deadline) {
+                _waiters.erase(std::find(_waiters.begin(), _waiters.end(), &w));
+                _running++;
+                break;
+            }
+            _wake.wait_for(lk, std::chrono::microseconds(deadline - now));
+        }
+    }
+}
+
+void SimKernel::changed() {
+    wakeWhere([](Waiter* w) { return (*w->ready)(); });
+}
+
+void* SimKernel::startTask(const char* name, void (*entry)(void*), void* arg) {
+    SimTask* task = new SimTask();
+    task->name = name;
+
+    Lock lk = lock();
+    _tasks.push_back(task);
+    _running++;
+    lk.unlock();
+
+    std::thread([task, entry, arg]() {
+        _current = task;
+        entry(arg);
+
+        // FreeRTOS tasks never return; treat it as deleting itself
+        Lock lk = lock();
+        _running--;
+        settle();
+    }).detach();
+    return task;
+}
+
+void* SimKernel::currentTask() {
+    return _current;
+}
+
+void* SimKernel::findTask(const char* name) {
+    Lock lk = lock();
+    for (SimTask* t : _tasks) {
+        if (t->name == name) return t;
+    }
+    return nullptr;
+}
+
+const char* SimKernel::taskName(void* task) {
+    return task ? static_cast<SimTask*>(task)->name.c_str() : "";
+}
+
+void SimKernel::notify(void* task) {
+    if (!task) return;
+    Lock lk = lock();
+    static_cast<SimTask*>(task)->notify++;
+    changed();
+}
+
+uint32_t SimKernel::takeNotify(bool clear, uint32_t timeoutMs) {
+    SimTask* self = _current;
+    Lock lk = lock();
+    if (!wait(lk, [self] { return self->notify > 0; }, timeoutMs)) return 0;
+    uint32_t value = self->notify;
+    self->notify = clear ? 0 : value - 1;
+    return value;
+}
+
+void SimKernel::sleep(uint32_t ms) {
+    Lock lk = lock();
+    wait(lk, [] { return false; }, ms);
+}
+
+void SimKernel::beginIO() {
+    Lock lk = lock();
+    _io++;
+    _running--;
+}
+
+void SimKernel::endIO() {
+    Lock lk = lock();
+    _io--;
+    _running++;
+}
+
+void SimKernel::attachDriver() {
+    Lock lk = lock();
+    SimTask* task = new SimTask();
+    task->name = "loopTask";
+    _tasks.push_back(task);
+    _running++;
+    _current = task;
+}
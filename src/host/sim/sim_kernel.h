@@ -0,0 +1,56 @@
+#pragma once
+
+// Host simulator: virtual time and the scheduler behind the FreeRTOS shim.
+//
+// Every FreeRTOS task is a thread, and so is loop(). The clock runs at
+// wall-clock speed while any of them has work to do, and jumps ahead
+// when all of them are blocked: a poll interval spent waiting costs
+// nothing, while rendering, parsing and requests in flight take the time
+// they really take on this machine.
+//
+// All shim objects (queues, event groups, mutexes, notifications) share
+// one lock; a thread blocks in wait() and is woken by changed() or when
+// the clock reaches its timeout.
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+class SimKernel {
+public:
+    typedef std::unique_lock<std::mutex> Lock;
+
+    static Lock lock();
+
+    // Microseconds since boot
+    static uint64_t nowUs();
+
+    // Block the calling task until ready() holds or timeoutMs passes
+    // (0 = don't block, UINT32_MAX = forever). ready() is called with the
+    // lock held. Returns the last result of ready().
+    static bool wait(Lock& lk, const std::function<bool()>& ready, uint32_t timeoutMs);
+
+    // Call with the lock held after changing something a waiter tests
+    static void changed();
+
+    // Start a task thread; returns its handle
+    static void* startTask(const char* name, void (*entry)(void*), void* arg);
+    static void* currentTask();
+    static void* findTask(const char* name);
+    static const char* taskName(void* task);
+
+    // Task notification value, as ulTaskNotifyTake uses it
+    static void notify(void* task);
+    static uint32_t takeNotify(bool clear, uint32_t timeoutMs);
+
+    // Sleep the calling task. From the driver thread this is what lets
+    // the other tasks run and moves the clock on.
+    static void sleep(uint32_t ms);
+
+    // Bracket blocking socket I/O, so the clock is not moved past it
+    static void beginIO();
+    static void endIO();
+
+    // The calling thread becomes the loop task; call once from main()
+    static void attachDriver();
+};
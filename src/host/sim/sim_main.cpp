@@ -0,0 +1,447 @@
+/*
+ * Host simulator
+ *
+ * Runs the unmodified firmware — setup(), loop(), the network, touch and
+ * WiFi tasks — against a real TapeBackarr server (or tools/mock_server.py)
+ * in accelerated time: the clock skips ahead whenever every task is
+ * blocked, so a day of polling takes minutes. Along the way it takes the
+ * AP out of range, plays touch gestures, keeps web UI viewers connected
+ * and fetches the diagnostic pages, then reports loop and poll latency,
+ * render counts and heap use hour by hour.
+ *
+ * Usage: program --server HOST:PORT [options]
+ *   --server HOST:PORT   Server to poll, plain HTTP
+ *   --api-key KEY        X-API-Key to send (default sim; the mock server
+ *                        takes any)
+ *   --hours H            Simulated time to run (default 24)
+ *   --poll S             Poll interval in seconds (default 30)
+ *   --tick MS            delay() between loop() passes (default 10)
+ *   --wifi-drop-every M  Take the AP out of range every M minutes (0 = never)
+ *   --wifi-drop-for S    ... for S seconds (default 90)
+ *   --dhcp-ms MS         DHCP time after each association (default 200)
+ *   --touch-every S      A gesture every S seconds, cycling tap, swipe,
+ *                        drag and long press (default 120, 0 = none)
+ *   --viewers N          Web UI viewers on the snapshot WebSocket (default 1)
+ *   --web-every S        Fetch /status, /metrics and /heap every S seconds
+ *                        (default 60, 0 = never)
+ *   --nvs FILE           NVS contents, kept between runs (default: blank)
+ *   --spiffs DIR         SPIFFS partition (default: none, as if never flashed)
+ *   --record             Record API answers to DIR/capture.bin from boot
+ *   --replay FILE        Answer from a capture instead of the server, with
+ *                        its timing; the run ends when it is used up.
+ *                        Needs --spiffs (FILE is copied in as replay.bin)
+ *   --max-growth KB      Fail if the live heap grows more than this from
+ *                        the end of hour 1 to the end (default 64)
+ *   --csv FILE           Also write the hourly samples as CSV
+ *
+ * A capture downloaded from a device (/capture in its web UI) replays a
+ * real server's answers and timing without the server.
+ *
+ * Exit status is non-zero if the firmware asked for a restart or the heap
+ * grew past --max-growth.
+ */
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <Preferences.h>
+#include <SPIFFS.h>
+#include <WiFi.h>
+#include <chrono>
+#include <deque>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "settings.h"
+#include "api_client.h"
+#include "api_capture.h"
+#include "display.h"
+#include "touch_input.h"
+#include "latency.h"
+#include "heap_monitor.h"
+#include "sim_kernel.h"
+
+// main.cpp
+void setup();
+void loop();
+extern SettingsManager settings;
+extern APIClient apiClient;
+extern ApiCapture apiCapture;
+extern Display display;
+
+#define SIM_PEN_STEP_MS   20      // Pen position updates during a gesture
+#define SIM_WEB_QUEUE     4
+
+struct SimOptions {
+    String server;
+    String apiKey = "sim";
+    double hours = 24;
+    uint16_t pollS = 30;
+    uint32_t tickMs = 10;
+    uint32_t dropEveryMin = 0;
+    uint32_t dropForS = 90;
+    uint32_t dhcpMs = 200;
+    uint32_t touchEveryS = 120;
+    uint32_t viewers = 1;
+    uint32_t webEveryS = 60;
+    String nvsFile;
+    String spiffsDir;
+    bool record = false;
+    String replayFile;
+    uint32_t maxGrowthKB = 64;
+    String csvFile;
+};
+
+struct HourSample {
+    uint32_t hour;
+    size_t liveBytes;        // Host heap in use
+    uint32_t minFree;        // Simulated free heap low-water mark
+    uint32_t loopMaxMs;
+    uint32_t loopStalls;
+    uint32_t requests;
+    uint32_t errors;
+    uint32_t renders;
+    uint32_t wsMessages;
+};
+
+// ── Touch ──────────────────────────────────────────────────────────────
+
+struct PenStep {
+    unsigned long at;
+    bool down;
+    uint16_t x, y;
+};
+
+static std::deque<PenStep> _pen;
+static bool _penDown = false;
+
+// Pen down at (x0, y0), moved in a straight line to (x1, y1) over ms,
+// held for holdMs, lifted
+static void gesture(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                    uint32_t ms, uint32_t holdMs) {
+    unsigned long t = millis();
+    uint32_t steps = ms / SIM_PEN_STEP_MS;
+    _pen.push_back({ t, true, x0, y0 });
+    for (uint32_t i = 1; i <= steps; i++) {
+        _pen.push_back({ t + i * SIM_PEN_STEP_MS, true,
+                         (uint16_t)(x0 + ((int)x1 - x0) * (int)i / (int)steps),
+                         (uint16_t)(y0 + ((int)y1 - y0) * (int)i / (int)steps) });
+    }
+    _pen.push_back({ t + ms + holdMs, false, x1, y1 });
+}
+
+static void nextGesture(uint32_t n) {
+    switch (n % 5) {
+        case 0: gesture(160, 225, 160, 225, 0, 80); break;         // Tap: Jobs tab
+        case 1: gesture(260, 120, 100, 120, 200, 0); break;        // Swipe left
+        case 2: gesture(160, 190, 160, 70, 600, 0); break;         // Drag a list up
+        case 3: gesture(160, 120, 160, 120, 0, 1000); break;       // Long press
+        case 4: gesture(50, 225, 50, 225, 0, 80); break;           // Tap: Dashboard
+    }
+}
+
+// The XPT2046 pulls PENIRQ low while the pen is down
+static void updatePen() {
+    unsigned long now = millis();
+    while (!_pen.empty() && (long)(now - _pen.front().at) >= 0) {
+        const PenStep& s = _pen.front();
+        display.getPanel().setPen(s.down, s.x, s.y);
+        if (s.down != _penDown) hostSetPin(TOUCH_IRQ_PIN, s.down ? LOW : HIGH);
+        _penDown = s.down;
+        _pen.pop_front();
+    }
+}
+
+// ── Web UI ─────────────────────────────────────────────────────────────
+
+// Requests are served from their own task, as AsyncTCP does on the device
+static QueueHandle_t _webQueue = nullptr;
+static uint32_t _webRequests = 0;
+static uint32_t _webErrors = 0;
+static uint64_t _webBytes = 0;
+
+static void asyncTcpTask(void*) {
+    for (;;) {
+        const char* url;
+        xQueueReceive(_webQueue, &url, portMAX_DELAY);
+        AsyncWebServer* server = AsyncWebServer::instance();
+        if (!server) continue;
+
+        AsyncWebServerRequest request(HTTP_GET, url);
+        server->handle(request);
+        AsyncWebServerResponse* response = request.response();
+        _webRequests++;
+        if (!response || response->code() != 200) _webErrors++;
+        if (response) _webBytes += response->body().length();
+    }
+}
+
+static void fetchPages() {
+    static const char* const PAGES[] = { "/status", "/metrics", "/heap", "/latency" };
+    for (const char* page : PAGES) xQueueSend(_webQueue, &page, 0);
+}
+
+// ── Report ─────────────────────────────────────────────────────────────
+
+static uint32_t totalRenders() {
+    uint32_t n = 0;
+    for (int tab = 0; tab < SCREEN_CACHE_SLOTS; tab++) n += display.getRenderTiming(tab).renders;
+    return n;
+}
+
+static HourSample sample(uint32_t hour) {
+    HourSample s = {};
+    s.hour = hour;
+    s.liveBytes = EspClass::hostLiveBytes();
+    s.minFree = ESP.getMinFreeHeap();
+    if (LatencyTracker::count() > 0) {
+        LatencyStats loop = LatencyTracker::get(0)->getStats();
+        s.loopMaxMs = loop.maxMs;
+        s.loopStalls = loop.stalls;
+    }
+    for (int e = 0; e < API_ENDPOINT_COUNT; e++) {
+        EndpointStats st = apiClient.getStats(e);
+        s.requests += st.requests;
+        s.errors += st.errors;
+    }
+    s.renders = totalRenders();
+    AsyncWebSocket* ws = AsyncWebSocket::instance();
+    s.wsMessages = ws ? ws->messagesSent() : 0;
+    return s;
+}
+
+static void report(const std::vector<HourSample>& hours, double realS, double simS) {
+    printf("\nSimulated %.1f h in %.1f s (%.0fx)\n\n", simS / 3600, realS,
+           realS > 0 ? simS / realS : 0);
+
+    printf("%4s %10s %10s %9s %7s %8s %7s %8s %8s\n", "hour", "live_kb", "min_free",
+           "loop_max", "stalls", "requests", "errors", "renders", "ws_msgs");
+    for (const HourSample& s : hours) {
+        printf("%4u %10.1f %10u %9u %7u %8u %7u %8u %8u\n", s.hour, s.liveBytes / 1024.0,
+               s.minFree, s.loopMaxMs, s.loopStalls, s.requests, s.errors, s.renders,
+               s.wsMessages);
+    }
+
+    printf("\n%-10s %10s %10s %8s %8s\n", "task", "iterations", "avg_us", "max_ms", "stalls");
+    for (size_t i = 0; i < LatencyTracker::count(); i++) {
+        LatencyStats st = LatencyTracker::get(i)->getStats();
+        printf("%-10s %10u %10llu %8u %8u\n", st.task, st.iterations,
+               (unsigned long long)(st.iterations ? st.totalUs / st.iterations : 0),
+               st.maxMs, st.stalls);
+    }
+
+    printf("\n%-12s %8s %7s %8s %8s\n", "endpoint", "requests", "errors", "retries", "avg_ms");
+    for (int e = 0; e < API_ENDPOINT_COUNT; e++) {
+        EndpointStats st = apiClient.getStats(e);
+        printf("%-12s %8u %7u %8u %8llu\n", APIClient::endpointName(e), st.requests,
+               st.errors, st.retries,
+               (unsigned long long)(st.requests ? st.totalMs / st.requests : 0));
+    }
+
+    printf("\n%-8s %8s %8s\n", "tab", "renders", "blits");
+    for (int tab = 0; tab < SCREEN_CACHE_SLOTS; tab++) {
+        const RenderTiming& t = display.getRenderTiming(tab);
+        printf("%-8d %8u %8u\n", tab, t.renders, t.blits);
+    }
+
+    printf("\n%-8s %10s %12s %9s\n", "heap", "allocs", "bytes", "failures");
+    for (uint8_t tag = 0; tag < HEAP_TAG_COUNT; tag++) {
+        HeapTagStats st = HeapMonitor::getTagStats(tag);
+        printf("%-8s %10u %12llu %9u\n", HeapMonitor::tagName(tag), st.allocs,
+               (unsigned long long)st.bytes, st.failures);
+    }
+
+    AsyncWebSocket* ws = AsyncWebSocket::instance();
+    printf("\nweb: %u page requests (%u failed, %llu bytes), %u WebSocket messages (%llu bytes)\n",
+           _webRequests, _webErrors, (unsigned long long)_webBytes,
+           ws ? ws->messagesSent() : 0, (unsigned long long)(ws ? ws->bytesSent() : 0));
+}
+
+static void writeCSV(const String& path, const std::vector<HourSample>& hours) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", path.c_str());
+        return;
+    }
+    fprintf(f, "hour,live_bytes,min_free,loop_max_ms,loop_stalls,requests,errors,renders,ws_messages\n");
+    for (const HourSample& s : hours) {
+        fprintf(f, "%u,%zu,%u,%u,%u,%u,%u,%u,%u\n", s.hour, s.liveBytes, s.minFree,
+                s.loopMaxMs, s.loopStalls, s.requests, s.errors, s.renders, s.wsMessages);
+    }
+    fclose(f);
+}
+
+// ── Main ───────────────────────────────────────────────────────────────
+
+static bool parseArgs(int argc, char** argv, SimOptions& o) {
+    for (int i = 1; i < argc; i++) {
+        String arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--server" && hasValue) o.server = argv[++i];
+        else if (arg == "--api-key" && hasValue) o.apiKey = argv[++i];
+        else if (arg == "--hours" && hasValue) o.hours = atof(argv[++i]);
+        else if (arg == "--poll" && hasValue) o.pollS = atoi(argv[++i]);
+        else if (arg == "--tick" && hasValue) o.tickMs = atoi(argv[++i]);
+        else if (arg == "--wifi-drop-every" && hasValue) o.dropEveryMin = atoi(argv[++i]);
+        else if (arg == "--wifi-drop-for" && hasValue) o.dropForS = atoi(argv[++i]);
+        else if (arg == "--dhcp-ms" && hasValue) o.dhcpMs = atoi(argv[++i]);
+        else if (arg == "--touch-every" && hasValue) o.touchEveryS = atoi(argv[++i]);
+        else if (arg == "--viewers" && hasValue) o.viewers = atoi(argv[++i]);
+        else if (arg == "--web-every" && hasValue) o.webEveryS = atoi(argv[++i]);
+        else if (arg == "--nvs" && hasValue) o.nvsFile = argv[++i];
+        else if (arg == "--spiffs" && hasValue) o.spiffsDir = argv[++i];
+        else if (arg == "--record") o.record = true;
+        else if (arg == "--replay" && hasValue) o.replayFile = argv[++i];
+        else if (arg == "--max-growth" && hasValue) o.maxGrowthKB = atoi(argv[++i]);
+        else if (arg == "--csv" && hasValue) o.csvFile = argv[++i];
+        else return false;
+    }
+    if ((o.record || o.replayFile.length() > 0) && o.spiffsDir.isEmpty()) return false;
+    return o.hours > 0 && o.tickMs > 0 &&
+           (o.server.length() > 0 || o.nvsFile.length() > 0 || o.replayFile.length() > 0);
+}
+
+static bool copyFile(const String& from, const String& to) {
+    FILE* in = fopen(from.c_str(), "rb");
+    if (!in) return false;
+    FILE* out = fopen(to.c_str(), "wb");
+    bool ok = out != nullptr;
+    char buf[4096];
+    size_t n;
+    while (ok && (n = fread(buf, 1, sizeof(buf), in)) > 0) ok = fwrite(buf, 1, n, out) == n;
+    fclose(in);
+    if (out) ok = fclose(out) == 0 && ok;
+    return ok;
+}
+
+// What the web UI would have saved: the simulated network and the server
+static void provision(const SimOptions& o) {
+    SettingsManager s;
+    s.begin();
+    AppSettings& a = s.get();
+    a.wifiSSID = "sim-ap";
+    a.wifiPassword = "simulated";
+    if (o.server.length() > 0) {
+        int colon = o.server.lastIndexOf(':');
+        a.serverHost = colon < 0 ? o.server : o.server.substring(0, colon);
+        if (colon >= 0) a.serverPort = o.server.substring(colon + 1).toInt();
+        a.useHTTPS = false;
+    } else if (o.replayFile.length() > 0) {
+        a.serverHost = "replay";   // Never contacted, but polling needs one
+    }
+    a.apiKey = o.apiKey;
+    a.pollInterval = o.pollS;
+    s.save();
+}
+
+int main(int argc, char** argv) {
+    SimOptions o;
+    if (!parseArgs(argc, argv, o)) {
+        fprintf(stderr, "usage: %s --server HOST:PORT [--api-key KEY] [--hours H] [--poll S]\n"
+                        "       [--tick MS] [--wifi-drop-every M] [--wifi-drop-for S] [--dhcp-ms MS]\n"
+                        "       [--touch-every S] [--viewers N] [--web-every S] [--nvs FILE]\n"
+                        "       [--spiffs DIR [--record] [--replay FILE]] [--max-growth KB]\n"
+                        "       [--csv FILE]\n", argv[0]);
+        return 2;
+    }
+    SimKernel::attachDriver();
+
+    char tmpNvs[] = "/tmp/cyd-sim-nvs-XXXXXX";
+    if (o.nvsFile.isEmpty()) {
+        int fd = mkstemp(tmpNvs);
+        if (fd >= 0) close(fd);
+        Preferences::setHostFile(tmpNvs);
+    } else {
+        Preferences::setHostFile(o.nvsFile.c_str());
+    }
+    if (o.spiffsDir.length() > 0) SPIFFSFS::setHostDir(o.spiffsDir.c_str());
+    if (o.replayFile.length() > 0 && !copyFile(o.replayFile, o.spiffsDir + REPLAY_FILE)) {
+        fprintf(stderr, "cannot copy %s into %s\n", o.replayFile.c_str(), o.spiffsDir.c_str());
+        return 2;
+    }
+    provision(o);
+
+    WiFi.setNetwork("sim-ap");
+    WiFi.setDhcpDelay(o.dhcpMs);
+    _webQueue = xQueueCreate(SIM_WEB_QUEUE, sizeof(const char*));
+    xTaskCreate(asyncTcpTask, "async_tcp", 8192, nullptr, 3, nullptr);
+
+    ESP.setBaseline();
+    auto realStart = std::chrono::steady_clock::now();
+    setup();
+    if (o.record) apiCapture.start();
+
+    if (AsyncWebSocket* ws = AsyncWebSocket::instance()) {
+        for (uint32_t i = 0; i < o.viewers; i++) ws->connectClient();
+    }
+
+    const unsigned long endMs = millis() + (unsigned long)(o.hours * 3600000.0);
+    unsigned long nextHour = millis() + 3600000UL;
+    unsigned long nextTouch = millis() + o.touchEveryS * 1000UL;
+    unsigned long nextWeb = millis() + o.webEveryS * 1000UL;
+    unsigned long nextDrop = millis() + o.dropEveryMin * 60000UL;
+    unsigned long restoreAt = 0;
+    uint32_t gestures = 0;
+    std::vector<HourSample> hours;
+
+    while ((long)(millis() - endMs) < 0 && !ESP.restartRequested() &&
+           !apiCapture.getStatus().replayDone) {
+        unsigned long now = millis();
+
+        if (o.dropEveryMin && (long)(now - nextDrop) >= 0) {
+            WiFi.setInRange(false);
+            restoreAt = now + o.dropForS * 1000UL;
+            nextDrop += o.dropEveryMin * 60000UL;
+        }
+        if (restoreAt && (long)(now - restoreAt) >= 0) {
+            WiFi.setInRange(true);
+            restoreAt = 0;
+        }
+        WiFi.process();
+
+        if (o.touchEveryS && (long)(now - nextTouch) >= 0) {
+            if (_pen.empty()) nextGesture(gestures++);
+            nextTouch += o.touchEveryS * 1000UL;
+        }
+        updatePen();
+
+        if (o.webEveryS && (long)(now - nextWeb) >= 0) {
+            fetchPages();
+            nextWeb += o.webEveryS * 1000UL;
+        }
+
+        loop();
+
+        if ((long)(millis() - nextHour) >= 0) {
+            hours.push_back(sample(hours.size() + 1));
+            nextHour += 3600000UL;
+        }
+        delay(o.tickMs);
+    }
+
+    double realS = std::chrono::duration<double>(std::chrono::steady_clock::now() - realStart).count();
+    if (hours.empty() || hours.back().hour * 3600000UL < millis()) {
+        hours.push_back(sample(hours.size() + 1));
+    }
+    report(hours, realS, millis() / 1000.0);
+    if (o.csvFile.length() > 0) writeCSV(o.csvFile, hours);
+    if (o.nvsFile.isEmpty()) unlink(tmpNvs);
+
+    int status = 0;
+    if (ESP.restartRequested()) {
+        printf("\nFAIL: restart requested at %.1f h\n", millis() / 3600000.0);
+        status = 1;
+    }
+    if (hours.size() >= 2) {
+        long growth = (long)hours.back().liveBytes - (long)hours.front().liveBytes;
+        printf("\nheap growth since hour 1: %+.1f KB\n", growth / 1024.0);
+        if (growth > (long)o.maxGrowthKB * 1024) {
+            printf("FAIL: more than %u KB\n", o.maxGrowthKB);
+            status = 1;
+        }
+    }
+    fflush(stdout);
+    // Tasks never return; leave without running destructors under them
+    _exit(status);
+}
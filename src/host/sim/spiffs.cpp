@@ -0,0 +1,172 @@
+#include "SPIFFS.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace stdfs = std::filesystem;
+
+SPIFFSFS SPIFFS;
+
+static std::string _hostDir;
+
+namespace fs {
+
+struct FileImpl {
+    std::string path;                  // As the firmware names it, "/www/x"
+    std::string name;
+    FILE* f = nullptr;
+    bool dir = false;
+    std::vector<std::string> entries;  // Directory: device paths under it
+    size_t next = 0;
+    String root;
+
+    ~FileImpl() {
+        if (f) fclose(f);
+    }
+};
+
+static size_t usedIn(const String& root) {
+    size_t used = 0;
+    std::error_code ec;
+    for (auto& e : stdfs::recursive_directory_iterator(root.c_str(), ec)) {
+        if (e.is_regular_file(ec)) used += e.file_size(ec);
+    }
+    return used;
+}
+
+File::operator bool() const {
+    return _impl && (_impl->f || _impl->dir);
+}
+
+size_t File::read(uint8_t* buf, size_t len) {
+    return _impl && _impl->f ? fread(buf, 1, len, _impl->f) : 0;
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::write(const uint8_t* buf, size_t len) {
+    if (!_impl || !_impl->f) return 0;
+    // A full partition takes nothing
+    if (usedIn(_impl->root) + len > SIM_SPIFFS_BYTES) return 0;
+    size_t n = fwrite(buf, 1, len, _impl->f);
+    fflush(_impl->f);
+    return n;
+}
+
+int File::available() {
+    return (int)(size() - position());
+}
+
+size_t File::size() const {
+    if (!_impl || !_impl->f) return 0;
+    long pos = ftell(_impl->f);
+    fseek(_impl->f, 0, SEEK_END);
+    long end = ftell(_impl->f);
+    fseek(_impl->f, pos, SEEK_SET);
+    return end > 0 ? (size_t)end : 0;
+}
+
+size_t File::position() const {
+    return _impl && _impl->f ? (size_t)ftell(_impl->f) : 0;
+}
+
+bool File::seek(uint32_t pos) {
+    return _impl && _impl->f && fseek(_impl->f, pos, SEEK_SET) == 0;
+}
+
+void File::flush() {
+    if (_impl && _impl->f) fflush(_impl->f);
+}
+
+void File::close() {
+    _impl.reset();
+}
+
+const char* File::path() const {
+    return _impl ? _impl->path.c_str() : "";
+}
+
+const char* File::name() const {
+    return _impl ? _impl->name.c_str() : "";
+}
+
+bool File::isDirectory() const {
+    return _impl && _impl->dir;
+}
+
+File File::openNextFile() {
+    if (!_impl || !_impl->dir || _impl->next >= _impl->entries.size()) return File();
+    FS& fs = SPIFFS;
+    return fs.open(_impl->entries[_impl->next++].c_str());
+}
+
+File FS::open(const char* path, const char* mode, bool) {
+    if (_root.isEmpty() || !path || path[0] != '/') return File();
+
+    auto impl = std::make_shared<FileImpl>();
+    impl->path = path;
+    impl->name = stdfs::path(path).filename().string();
+    impl->root = _root;
+    stdfs::path host = stdfs::path(_root.c_str()) / (path + 1);
+
+    std::error_code ec;
+    if (mode[0] == 'r' && stdfs::is_directory(host, ec)) {
+        // SPIFFS has no directories: everything under the prefix
+        impl->dir = true;
+        for (auto& e : stdfs::recursive_directory_iterator(host, ec)) {
+            if (!e.is_regular_file(ec)) continue;
+            impl->entries.push_back("/" + stdfs::relative(e.path(), _root.c_str()).string());
+        }
+        return File(impl);
+    }
+
+    if (mode[0] != 'r') stdfs::create_directories(host.parent_path(), ec);
+    const char* hostMode = mode[0] == 'w' ? "w+b" : mode[0] == 'a' ? "a+b" : "rb";
+    impl->f = fopen(host.c_str(), hostMode);
+    if (!impl->f) return File();
+    return File(impl);
+}
+
+bool FS::exists(const char* path) {
+    std::error_code ec;
+    return !_root.isEmpty() && path && path[0] == '/' &&
+           stdfs::exists(stdfs::path(_root.c_str()) / (path + 1), ec);
+}
+
+bool FS::remove(const char* path) {
+    std::error_code ec;
+    return !_root.isEmpty() && path && path[0] == '/' &&
+           stdfs::remove(stdfs::path(_root.c_str()) / (path + 1), ec);
+}
+
+bool FS::rename(const char* from, const char* to) {
+    if (_root.isEmpty() || !from || !to || from[0] != '/' || to[0] != '/') return false;
+    std::error_code ec;
+    stdfs::rename(stdfs::path(_root.c_str()) / (from + 1),
+                  stdfs::path(_root.c_str()) / (to + 1), ec);
+    return !ec;
+}
+
+}  // namespace fs
+
+bool SPIFFSFS::begin(bool formatOnFail, const char*, uint8_t, const char*) {
+    if (_hostDir.empty()) return false;
+    std::error_code ec;
+    if (!stdfs::is_directory(_hostDir, ec)) {
+        if (!formatOnFail || !stdfs::create_directories(_hostDir, ec)) return false;
+    }
+    _root = _hostDir.c_str();
+    return true;
+}
+
+size_t SPIFFSFS::usedBytes() {
+    return _root.isEmpty() ? 0 : fs::usedIn(_root);
+}
+
+void SPIFFSFS::setHostDir(const char* dir) {
+    _hostDir = dir ? dir : "";
+}
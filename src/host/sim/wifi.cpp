@@ -0,0 +1,184 @@
+#include "WiFi.h"
+#include "ESPmDNS.h"
+
+// Rough association times: straight to a known BSSID, or a full scan
+// first. DHCP follows unless the address is static.
+#define SIM_FAST_CONNECT_MS  150
+#define SIM_SCAN_CONNECT_MS  2400
+#define SIM_NO_AP_MS         3000    // Scan finds nothing
+#define SIM_SCAN_MS          2000
+
+WiFiClass WiFi;
+MDNSResponder MDNS;
+
+const uint8_t WiFiClass::SIM_BSSID[6] = { 0x02, 0x51, 0x4d, 0x00, 0x00, 0x01 };
+
+// Neighbours a scan finds besides the simulated AP
+static const struct {
+    const char* ssid;
+    int8_t rssi;
+    wifi_auth_mode_t auth;
+} NEIGHBOURS[] = {
+    { "neighbour-5g", -71, WIFI_AUTH_WPA2_PSK },
+    { "guest",        -80, WIFI_AUTH_OPEN },
+};
+#define NEIGHBOUR_COUNT (sizeof(NEIGHBOURS) / sizeof(NEIGHBOURS[0]))
+
+bool WiFiClass::mode(wifi_mode_t m) {
+    if (m != WIFI_STA && m != WIFI_AP_STA && _connected) disconnect();
+    _mode = m;
+    return true;
+}
+
+int WiFiClass::onEvent(WiFiEventFuncCb cb, arduino_event_id_t) {
+    std::lock_guard<std::mutex> lk(_mutex);
+    _handlers.push_back(cb);
+    return (int)_handlers.size();
+}
+
+void WiFiClass::post(unsigned long delayMs, arduino_event_id_t id, uint8_t reason) {
+    std::lock_guard<std::mutex> lk(_mutex);
+    _events.push_back({ millis() + delayMs, id, reason });
+}
+
+void WiFiClass::dropPending() {
+    std::lock_guard<std::mutex> lk(_mutex);
+    _events.clear();
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char*, int32_t channel,
+                             const uint8_t* bssid, bool) {
+    if (_mode == WIFI_OFF || _mode == WIFI_AP) _mode = WIFI_STA;
+    dropPending();
+    if (_connected) disconnect();
+
+    bool known = channel == SIM_CHANNEL && bssid && !memcmp(bssid, SIM_BSSID, 6);
+    if (!_inRange || _ssid != ssid) {
+        post(SIM_NO_AP_MS, ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_NO_AP_FOUND);
+    } else {
+        unsigned long assocMs = known ? SIM_FAST_CONNECT_MS : SIM_SCAN_CONNECT_MS;
+        post(assocMs, ARDUINO_EVENT_WIFI_STA_CONNECTED);
+        post(assocMs + (_static ? 0 : _dhcpMs), ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    }
+    return WL_DISCONNECTED;
+}
+
+bool WiFiClass::config(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns) {
+    _static = (uint32_t)ip != 0;
+    if (_static) {
+        _ip = ip;
+        _gateway = gateway;
+        _subnet = subnet;
+        _dns = dns;
+    }
+    return true;
+}
+
+bool WiFiClass::disconnect(bool) {
+    dropPending();
+    if (_connected) {
+        _connected = false;
+        post(0, ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_ASSOC_LEAVE);
+    }
+    return true;
+}
+
+bool WiFiClass::softAP(const char*, const char*) {
+    if (_mode == WIFI_STA) _mode = WIFI_AP_STA;
+    else if (_mode == WIFI_OFF) _mode = WIFI_AP;
+    return true;
+}
+
+void WiFiClass::setInRange(bool inRange) {
+    if (inRange == _inRange) return;
+    _inRange = inRange;
+    if (inRange) return;
+
+    // An association or DHCP in progress fails; a live link times out
+    std::lock_guard<std::mutex> lk(_mutex);
+    bool pending = false;
+    unsigned long failAt = 0;
+    for (size_t i = 0; i < _events.size();) {
+        const PendingEvent& e = _events[i];
+        if (e.id == ARDUINO_EVENT_WIFI_STA_CONNECTED || e.id == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+            if (!pending || (long)(e.at - failAt) < 0) failAt = e.at;
+            pending = true;
+            _events.erase(_events.begin() + i);
+        } else {
+            i++;
+        }
+    }
+    if (pending) {
+        _events.push_back({ failAt, ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+                            WIFI_REASON_NO_AP_FOUND });
+    }
+    if (_connected) {
+        _connected = false;
+        _events.push_back({ millis(), ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+                            WIFI_REASON_BEACON_TIMEOUT });
+    }
+}
+
+void WiFiClass::process() {
+    std::vector<PendingEvent> due;
+    std::vector<WiFiEventFuncCb> handlers;
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        unsigned long now = millis();
+        for (size_t i = 0; i < _events.size();) {
+            if ((long)(now - _events[i].at) >= 0) {
+                due.push_back(_events[i]);
+                _events.erase(_events.begin() + i);
+            } else {
+                i++;
+            }
+        }
+        // Copied only when needed: this runs every loop() pass, and the
+        // heap accounting would charge the copy to loop()
+        if (!due.empty()) handlers = _handlers;
+    }
+
+    for (const PendingEvent& e : due) {
+        if (e.id == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+            if (!_static) {
+                _ip = IPAddress(192, 168, 1, 50);
+                _gateway = IPAddress(192, 168, 1, 1);
+                _subnet = IPAddress(255, 255, 255, 0);
+                _dns = _gateway;
+            }
+            _connected = true;
+        }
+        arduino_event_info_t info = {};
+        info.wifi_sta_disconnected.reason = e.reason;
+        for (WiFiEventFuncCb& cb : handlers) cb(e.id, info);
+    }
+}
+
+int16_t WiFiClass::scanNetworks(bool async, bool, bool, uint32_t) {
+    _scanDoneAt = millis() + SIM_SCAN_MS;
+    if (async) return WIFI_SCAN_RUNNING;
+    delay(SIM_SCAN_MS);
+    return scanComplete();
+}
+
+int16_t WiFiClass::scanComplete() {
+    if (!_scanDoneAt) return WIFI_SCAN_FAILED;
+    if ((long)(millis() - _scanDoneAt) < 0) return WIFI_SCAN_RUNNING;
+    return (_inRange ? 1 : 0) + NEIGHBOUR_COUNT;
+}
+
+// The simulated AP first while in range, then the neighbours
+String WiFiClass::SSID(uint8_t i) const {
+    if (_inRange && i-- == 0) return _ssid;
+    return i < NEIGHBOUR_COUNT ? NEIGHBOURS[i].ssid : "";
+}
+
+int8_t WiFiClass::RSSI(uint8_t i) const {
+    if (_inRange && i-- == 0) return _rssi;
+    return i < NEIGHBOUR_COUNT ? NEIGHBOURS[i].rssi : 0;
+}
+
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t i) const {
+    if (_inRange && i-- == 0) return WIFI_AUTH_WPA2_PSK;
+    return i < NEIGHBOUR_COUNT ? NEIGHBOURS[i].auth : WIFI_AUTH_OPEN;
+}
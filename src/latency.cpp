@@ -0,0 +1,94 @@
+#include "latency.h"
+#include <esp_task_wdt.h>
+
+LatencyTracker* LatencyTracker::_trackers[LATENCY_MAX_TRACKERS];
+size_t LatencyTracker::_count = 0;
+
+LatencyTracker::LatencyTracker(const char* task, const char* const* phaseNames,
+                               uint8_t phaseCount, uint32_t stallMs)
+    : _task(task), _phaseNames(phaseNames),
+      _phaseCount(min(phaseCount, (uint8_t)LATENCY_PHASE_MAX)), _stallMs(stallMs) {
+    _stats.task = task;
+    _stats.phaseNames = phaseNames;
+    if (_count < LATENCY_MAX_TRACKERS) _trackers[_count++] = this;
+}
+
+void LatencyTracker::begin(bool watchdog) {
+    if (!watchdog) return;
+
+    // The default 5 s also covers the idle tasks; a longer timeout that
+    // only reports leaves a slow render or NVS write alone
+    esp_task_wdt_init(LATENCY_WDT_S, false);
+    _watchdog = esp_task_wdt_add(nullptr) == ESP_OK;
+}
+
+void LatencyTracker::beginIteration(uint8_t phase) {
+    if (_running) endIteration();
+
+    memset(_phaseUs, 0, sizeof(_phaseUs));
+    _phaseStart = micros();
+    _iterStart = _phaseStart;
+    _phase = phase;
+    _running = true;
+}
+
+void LatencyTracker::enter(uint8_t phase) {
+    unsigned long now = micros();
+    _phaseUs[_phase] += now - _phaseStart;
+    _phaseStart = now;
+    _phase = phase < _phaseCount ? phase : 0;
+}
+
+void LatencyTracker::endIteration() {
+    if (!_running) return;
+    unsigned long now = micros();
+    _phaseUs[_phase] += now - _phaseStart;
+    uint32_t us = now - _iterStart;
+    uint32_t ms = us / 1000;
+
+    uint8_t slowest = 0;
+    for (uint8_t i = 1; i < _phaseCount; i++) {
+        if (_phaseUs[i] > _phaseUs[slowest]) slowest = i;
+    }
+
+    // Smallest bucket whose bound (1 << i ms) holds it
+    int bucket = 0;
+    while (bucket < LATENCY_BUCKETS - 1 && us > (1000UL << bucket)) bucket++;
+
+    portENTER_CRITICAL(&_mux);
+    _running = false;
+    _stats.iterations++;
+    _stats.histogram[bucket]++;
+    _stats.totalUs += us;
+    if (ms > _stats.maxMs) {
+        _stats.maxMs = ms;
+        _stats.maxPhase = slowest;
+        _stats.maxAtMs = millis();
+    }
+    bool stall = ms >= _stallMs;
+    if (stall) {
+        _stats.stalls++;
+        memmove(&_stats.recent[1], &_stats.recent[0],
+                (LATENCY_RECENT_STALLS - 1) * sizeof(LatencyStall));
+        _stats.recent[0] = { slowest, ms, (uint32_t)millis() };
+        if (_stats.recentCount < LATENCY_RECENT_STALLS) _stats.recentCount++;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if (stall) {
+        Serial.printf("Stall: %s %u ms in %s\n", _task, (unsigned)ms,
+                      _phaseNames[slowest]);
+    }
+    if (_watchdog) esp_task_wdt_reset();
+}
+
+LatencyStats LatencyTracker::getStats() const {
+    portENTER_CRITICAL(&_mux);
+    LatencyStats stats = _stats;
+    portEXIT_CRITICAL(&_mux);
+
+    stats.running = _running;
+    stats.phase = _phase;
+    stats.runningMs = stats.running ? (micros() - _iterStart) / 1000 : 0;
+    return stats;
+}
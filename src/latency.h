@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define LATENCY_BUCKETS        14    // <= 1, 2, 4 ... 4096 ms, then longer
+#define LATENCY_PHASE_MAX      8
+#define LATENCY_RECENT_STALLS  8
+#define LATENCY_MAX_TRACKERS   4
+#define LATENCY_WDT_S          10    // Task watchdog timeout for subscribed tasks
+
+// An iteration that ran over the stall threshold
+struct LatencyStall {
+    uint8_t phase;         // Phase that took the longest in it
+    uint32_t ms;
+    uint32_t atMs;         // millis() when it ended
+};
+
+struct LatencyStats {
+    const char* task;
+    const char* const* phaseNames;
+    uint32_t iterations;
+    uint32_t histogram[LATENCY_BUCKETS];
+    uint64_t totalUs;
+    uint32_t maxMs;
+    uint8_t maxPhase;
+    uint32_t maxAtMs;
+    uint32_t stalls;
+    LatencyStall recent[LATENCY_RECENT_STALLS];   // Newest first
+    uint8_t recentCount;
+    bool running;          // In an iteration right now
+    uint8_t phase;         // ... in this phase
+    uint32_t runningMs;    // ... for this long
+};
+
+// Iteration times of one task, split into named phases, so a frozen
+// screen can be traced to the code path that held it.
+//
+// The owning task brackets each iteration and says which phase it is in;
+// the longest phase of every iteration over the stall threshold is kept.
+// Subscribed tasks also feed the ESP-IDF task watchdog once per iteration,
+// so a hang longer than LATENCY_WDT_S is reported with a backtrace. Stats
+// can be read from any task (web handlers), also while the owner is stuck.
+class LatencyTracker {
+public:
+    LatencyTracker(const char* task, const char* const* phaseNames,
+                   uint8_t phaseCount, uint32_t stallMs);
+
+    // From the owning task. watchdog subscribes it to the task watchdog.
+    void begin(bool watchdog);
+
+    // Start an iteration in the given phase; closes one still open
+    void beginIteration(uint8_t phase);
+    void enter(uint8_t phase);     // Time from here on counts for phase
+    void endIteration();
+
+    LatencyStats getStats() const;
+
+    // Every tracker created, for /latency and /metrics
+    static size_t count() { return _count; }
+    static LatencyTracker* get(size_t i) { return _trackers[i]; }
+
+private:
+    const char* _task;
+    const char* const* _phaseNames;
+    uint8_t _phaseCount;
+    uint32_t _stallMs;
+    bool _watchdog = false;
+
+    uint32_t _phaseUs[LATENCY_PHASE_MAX] = {};
+    unsigned long _phaseStart = 0;
+
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    LatencyStats _stats = {};
+    volatile bool _running = false;
+    volatile uint8_t _phase = 0;
+    volatile unsigned long _iterStart = 0;
+
+    static LatencyTracker* _trackers[LATENCY_MAX_TRACKERS];
+    static size_t _count;
+};
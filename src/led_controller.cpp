@@ -0,0 +1,114 @@
+#include "led_controller.h"
+#include <driver/ledc.h>
+
+#define LEDC_MODE          LEDC_LOW_SPEED_MODE
+#define LEDC_RESOLUTION    LEDC_TIMER_13_BIT
+#define LEDC_FULL_DUTY     (1 << 13)
+
+// Steady timer: backlight and solid LED colours
+#define STEADY_TIMER       LEDC_TIMER_0
+#define STEADY_FREQ_HZ     5000
+
+// Blink timer: its PWM period *is* the blink period. Clocked from REF_TICK
+// so the rate holds if the CPU/APB clock is scaled down.
+#define BLINK_TIMER        LEDC_TIMER_1
+#define BLINK_FREQ_HZ      1
+
+#define CH_BACKLIGHT       LEDC_CHANNEL_0
+#define CH_RED             LEDC_CHANNEL_1
+#define CH_GREEN           LEDC_CHANNEL_2
+#define CH_BLUE            LEDC_CHANNEL_3
+
+struct PatternDef {
+    bool r, g, b;
+    uint8_t blinkHz;      // 0 = solid
+    uint8_t blinkDutyPct; // On-time per blink period
+};
+
+static const PatternDef PATTERNS[] = {
+    /* OFF     */ {false, false, false, 0, 0},
+    /* OK      */ {false, true,  false, 0, 0},
+    /* AP_MODE */ {false, false, true,  1, 10},
+    /* FORMAT  */ {false, false, true,  1, 50},
+    /* ALERT   */ {true,  false, false, 2, 50},
+    /* ERROR   */ {true,  false, false, 0, 0},
+};
+
+static void configTimer(ledc_timer_t timer, uint32_t hz, ledc_clk_cfg_t clk) {
+    ledc_timer_config_t cfg = {};
+    cfg.speed_mode = LEDC_MODE;
+    cfg.duty_resolution = LEDC_RESOLUTION;
+    cfg.timer_num = timer;
+    cfg.freq_hz = hz;
+    cfg.clk_cfg = clk;
+    ledc_timer_config(&cfg);
+}
+
+static void configChannel(ledc_channel_t ch, int pin, bool activeLow) {
+    ledc_channel_config_t cfg = {};
+    cfg.gpio_num = pin;
+    cfg.speed_mode = LEDC_MODE;
+    cfg.channel = ch;
+    cfg.intr_type = LEDC_INTR_DISABLE;
+    cfg.timer_sel = STEADY_TIMER;
+    cfg.duty = 0;
+    cfg.hpoint = 0;
+    cfg.flags.output_invert = activeLow ? 1 : 0;
+    ledc_channel_config(&cfg);
+}
+
+static void setChannel(ledc_channel_t ch, bool on, const PatternDef& p) {
+    if (on && p.blinkHz) {
+        ledc_bind_channel_timer(LEDC_MODE, ch, BLINK_TIMER);
+        ledc_set_duty(LEDC_MODE, ch, LEDC_FULL_DUTY * p.blinkDutyPct / 100);
+    } else {
+        ledc_bind_channel_timer(LEDC_MODE, ch, STEADY_TIMER);
+        ledc_set_duty(LEDC_MODE, ch, on ? LEDC_FULL_DUTY : 0);
+    }
+    ledc_update_duty(LEDC_MODE, ch);
+}
+
+void LedController::begin() {
+    configTimer(STEADY_TIMER, STEADY_FREQ_HZ, LEDC_USE_APB_CLK);
+    configTimer(BLINK_TIMER, BLINK_FREQ_HZ, LEDC_USE_REF_TICK);
+
+    configChannel(CH_BACKLIGHT, TFT_BL, false);
+    configChannel(CH_RED, LED_RED, true);
+    configChannel(CH_GREEN, LED_GREEN, true);
+    configChannel(CH_BLUE, LED_BLUE, true);
+
+    ledc_fade_func_install(0);
+    _ready = true;
+
+    _pattern = LED_PATTERN_ERROR;  // Force the first setPattern through
+    setPattern(LED_PATTERN_OFF);
+}
+
+void LedController::setPattern(LedPattern pattern) {
+    if (!_ready || pattern == _pattern) return;
+    _pattern = pattern;
+
+    const PatternDef& p = PATTERNS[pattern];
+    if (p.blinkHz) {
+        ledc_set_freq(LEDC_MODE, BLINK_TIMER, p.blinkHz);
+        // Restart the period so the first blink is immediate
+        ledc_timer_rst(LEDC_MODE, BLINK_TIMER);
+    }
+    setChannel(CH_RED, p.r, p);
+    setChannel(CH_GREEN, p.g, p);
+    setChannel(CH_BLUE, p.b, p);
+}
+
+void LedController::setBacklight(uint8_t pct, uint16_t fadeMs) {
+    if (!_ready) return;
+    pct = constrain(pct, 0, 100);
+    _backlight = pct;
+
+    uint32_t duty = (uint32_t)LEDC_FULL_DUTY * pct / 100;
+    if (fadeMs > 0) {
+        ledc_set_fade_time_and_start(LEDC_MODE, CH_BACKLIGHT, duty, fadeMs,
+                                     LEDC_FADE_NO_WAIT);
+    } else {
+        ledc_set_duty_and_update(LEDC_MODE, CH_BACKLIGHT, duty, 0);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+
+// CYD2USB RGB LED pins (active LOW)
+#define LED_RED   4
+#define LED_GREEN 16
+#define LED_BLUE  17
+
+// Backlight pin
+#define TFT_BL    21
+
+enum LedPattern {
+    LED_PATTERN_OFF,
+    LED_PATTERN_OK,        // Solid green
+    LED_PATTERN_AP_MODE,   // Blue heartbeat, 1 Hz short flash
+    LED_PATTERN_FORMAT,    // Blue blink, 1 Hz
+    LED_PATTERN_ALERT,     // Red blink, 2 Hz
+    LED_PATTERN_ERROR      // Solid red
+};
+
+// RGB LED and TFT backlight on the LEDC peripheral.
+//
+// Blink patterns run on a dedicated low-frequency LEDC timer, so the LED
+// keeps its rhythm no matter what the CPU is doing (blocking HTTP, NVS
+// writes) and costs no CPU time once set. Backlight changes can use the
+// hardware fade engine.
+class LedController {
+public:
+    void begin();
+
+    void setPattern(LedPattern pattern);
+    LedPattern getPattern() const { return _pattern; }
+
+    // 0-100 %, optionally faded in hardware over fadeMs
+    void setBacklight(uint8_t pct, uint16_t fadeMs = 0);
+    uint8_t getBacklight() const { return _backlight; }
+
+private:
+    LedPattern _pattern = LED_PATTERN_OFF;
+    uint8_t _backlight = 0;
+    bool _ready = false;
+};
@@ -10,8 +10,11 @@
  *   - Drive status display with loaded tape info and format type
  *   - LTFS format progress monitoring
  *   - Tape change alerts with LED notification
- *   - Touch-based screen navigation
+ *   - Touch gestures: tap/swipe between screens, drag to scroll lists
+ *   - Last data shown instantly at boot (warm start)
+ *   - Idle backlight dimming / screen off with WiFi power save
  *   - Web-based configuration interface
+ *   - mDNS discovery of TapeBackarr servers
  *   - WiFi AP fallback for initial setup
  *   - CYD IP address shown on connection error screens
  *
@@ -26,7 +29,16 @@
 #include "settings.h"
 #include "wifi_manager.h"
 #include "api_client.h"
+#include "api_capture.h"
 #include "display.h"
+#include "touch_input.h"
+#include "power_manager.h"
+#include "discovery.h"
+#include "warm_start.h"
+#include "boot_profile.h"
+#include "net_task.h"
+#include "latency.h"
+#include "heap_monitor.h"
 #include "web_server.h"
 
 #define FW_VERSION "1.1.0"
@@ -35,16 +47,25 @@
 SettingsManager settings;
 WiFiManager     wifiMgr;
 APIClient       apiClient;
+ApiCapture      apiCapture;
 Display         display;
+TouchInput      touch;
+PowerManager    power;
+ServerDiscovery discovery;
+WarmStart       warmStart;
+BootProfile     bootProfile;
+NetTask         netTask;
 ConfigWebServer webServer;
 
 // State
 unsigned long lastPoll       = 0;
-unsigned long lastTouchTime  = 0;
 int           currentTab     = 0;
+size_t        listScroll     = 0;      // First row shown on Jobs / Drives
+int           dragAccum      = 0;      // Drag distance not yet scrolled
 bool          hasAlert       = false;
 bool          alertDismissed = false;  // Locally dismissed, re-shows if server still pending
 bool          initialBoot    = true;
+bool          firstPollDone  = false;
 
 // Cached data
 DashboardData              dashboardData = {};
@@ -53,37 +74,47 @@ std::vector<DriveData>     drives;
 std::vector<TapeChangeData> tapeChanges;
 LTFSFormatStatus           ltfsFormatStatus = {};
 
-#define TOUCH_DEBOUNCE 300  // ms
-
-void fetchAllData() {
-    if (!wifiMgr.isConnected() || !settings.isConfigured()) return;
-
-    bool hadJobs = !activeJobs.empty();
-
-    dashboardData = apiClient.fetchDashboard();
-    yield(); webServer.handleClient();
-    activeJobs    = apiClient.fetchActiveJobs();
-    yield(); webServer.handleClient();
-    drives        = apiClient.fetchDrives();
-    yield(); webServer.handleClient();
-    tapeChanges   = apiClient.fetchTapeChanges();
-    yield(); webServer.handleClient();
-    ltfsFormatStatus = apiClient.fetchLTFSFormatStatus();
-    yield(); webServer.handleClient();
-
-    // Auto-switch to Jobs tab when a new job appears
-    if (!hadJobs && !activeJobs.empty()) {
-        currentTab = 1;
+#define TAB_COUNT         3
+#define SCROLL_STEP_PX    40   // Drag distance per list row
+#define LOOP_STALL_MS     250  // A loop pass this long shows as a frozen screen
+
+// What loop() is doing, for the latency tracker
+enum LoopPhase {
+    LOOP_WIFI,
+    LOOP_MDNS,
+    LOOP_WEB,
+    LOOP_TOUCH,
+    LOOP_POWER,
+    LOOP_RENDER,
+    LOOP_NVS,
+    LOOP_SNAPSHOT,
+    LOOP_PHASE_COUNT
+};
+
+static const char* const LOOP_PHASES[LOOP_PHASE_COUNT] = {
+    "wifi", "mdns", "web", "touch", "power", "render", "nvs", "snapshot"
+};
+
+LatencyTracker loopLatency("loop", LOOP_PHASES, LOOP_PHASE_COUNT, LOOP_STALL_MS);
+
+// Render a tab screen off-screen so switching to it is a single blit
+void renderTab(int tab) {
+    size_t first = (tab == currentTab) ? listScroll : 0;
+    switch (tab) {
+        case 0:
+            display.renderDashboard(dashboardData);
+            break;
+        case 1:
+            display.renderActiveJobs(activeJobs, first);
+            break;
+        case 2:
+            display.renderDrives(drives, first);
+            break;
     }
+}
 
-    // Alert persists as long as server reports pending tape changes.
-    // If server clears the event (tape was changed), reset everything.
-    if (tapeChanges.empty()) {
-        hasAlert = false;
-        alertDismissed = false;
-    } else {
-        hasAlert = true;
-    }
+void renderTabs() {
+    for (int tab = 0; tab < TAB_COUNT; tab++) renderTab(tab);
 }
 
 void refreshDisplay() {
@@ -99,89 +130,296 @@ void refreshDisplay() {
         return;
     }
 
+    if (display.showTab(currentTab)) return;
+
+    // Screen cache unavailable (low memory): draw straight to the panel
     switch (currentTab) {
         case 0:
             display.showDashboard(dashboardData);
             break;
         case 1:
-            display.showActiveJobs(activeJobs);
+            display.showActiveJobs(activeJobs, listScroll);
             break;
         case 2:
-            display.showDrives(drives);
+            display.showDrives(drives, listScroll);
             break;
     }
 }
 
-void handleTouch() {
-    uint16_t tx = 0, ty = 0;
-    if (!display.readTouch(tx, ty)) return;
+// Start a poll round in the network task
+void requestPoll() {
+    if (!wifiMgr.isConnected() || !settings.isConfigured()) return;
+
+    const AppSettings& s = settings.get();
+    ServerConfig server = { s.serverHost, s.serverPort, s.apiKey, s.useHTTPS };
+    if (netTask.requestPoll(server)) {
+        lastPoll = millis();
+        power.beginPoll();
+    }
+}
+
+// Last first-row the current tab's list can scroll to
+size_t maxListScroll() {
+    size_t count = 0, perPage = 0;
+    if (currentTab == 1) {
+        count = activeJobs.size();
+        perPage = Display::JOBS_PER_PAGE;
+    } else if (currentTab == 2) {
+        count = drives.size();
+        perPage = Display::DRIVES_PER_PAGE;
+    }
+    return count > perPage ? count - perPage : 0;
+}
+
+// Take over a finished poll round and redraw
+void applyPoll(PollResult& poll) {
+    power.endPoll();
+
+    // WiFi dropped during or since the round: the connecting screen is up
+    if (poll.aborted || !wifiMgr.isConnected()) return;
+
+    bool hadJobs = !activeJobs.empty();
+    bool hadAlert = hasAlert;
+
+    dashboardData    = poll.dashboard;
+    activeJobs       = std::move(poll.jobs);
+    drives           = std::move(poll.drives);
+    tapeChanges      = std::move(poll.tapeChanges);
+    ltfsFormatStatus = poll.ltfs;
+
+    // Auto-switch to Jobs tab when a new job appears
+    if (!hadJobs && !activeJobs.empty()) {
+        currentTab = 1;
+        listScroll = 0;
+    }
+    // The list may have shrunk under the scroll position
+    listScroll = min(listScroll, maxListScroll());
+
+    display.setStale(false);
+    renderTabs();
+    loopLatency.enter(LOOP_NVS);
+    if (poll.connected) {
+        HeapMonitor::Scope heap(HEAP_OTHER);
+        warmStart.save(dashboardData, activeJobs, drives);
+    }
+    loopLatency.enter(LOOP_SNAPSHOT);
+    {
+        HeapMonitor::Scope heap(HEAP_WEB);
+        webServer.publishSnapshot(dashboardData, activeJobs, drives,
+                                  tapeChanges, ltfsFormatStatus);
+    }
+    loopLatency.enter(LOOP_RENDER);
+
+    // Alert persists as long as server reports pending tape changes.
+    // If server clears the event (tape was changed), reset everything.
+    if (tapeChanges.empty()) {
+        hasAlert = false;
+        alertDismissed = false;
+    } else {
+        hasAlert = true;
+    }
 
-    unsigned long now = millis();
-    if (now - lastTouchTime < TOUCH_DEBOUNCE) return;
-    lastTouchTime = now;
+    // A new tape alert must be seen, so light the screen back up
+    if (hasAlert && !hadAlert) power.wake();
 
-    // If alert showing, temporarily dismiss it (will re-appear on next
-    // poll if the server still reports pending tape change events)
-    if (display.getCurrentScreen() == SCREEN_ALERT) {
-        alertDismissed = true;
+    if (!poll.connected) {
+        display.showError(poll.error, wifiMgr.getIP());
+    } else {
         refreshDisplay();
-        return;
     }
 
-    // Check tab bar
-    int tab = display.getTabFromTouch(tx, ty);
-    if (tab >= 0 && tab != currentTab) {
-        currentTab = tab;
+    if (!firstPollDone) {
+        firstPollDone = true;
+        bootProfile.mark("first_poll");
+    }
+}
+
+void selectTab(int tab) {
+    if (tab < 0 || tab >= TAB_COUNT || tab == currentTab) return;
+    int previous = currentTab;
+    bool wasScrolled = listScroll > 0;
+
+    currentTab = tab;
+    listScroll = 0;
+    dragAccum = 0;
+    refreshDisplay();
+
+    // Next visit to the list we left starts back at the top
+    if (wasScrolled) renderTab(previous);
+}
+
+void scrollList(int rows) {
+    int maxFirst = (int)maxListScroll();
+    if (maxFirst == 0) return;
+
+    int first = constrain((int)listScroll + rows, 0, maxFirst);
+    if ((size_t)first != listScroll) {
+        listScroll = first;
+        renderTab(currentTab);
         refreshDisplay();
     }
 }
 
+void handleTouch() {
+    TouchEvent ev;
+    while (touch.poll(ev)) {
+        // While the network is unreachable, a long press is the way into
+        // the setup AP (WiFi never falls back to it on its own)
+        if (display.getCurrentScreen() == SCREEN_CONNECTING) {
+            if (ev.gesture == TOUCH_LONG_PRESS) {
+                wifiMgr.startAP();
+                display.showAPMode(wifiMgr.getAPName(), wifiMgr.getIP());
+            }
+            continue;
+        }
+
+        // If alert showing, any touch temporarily dismisses it (it will
+        // re-appear on next poll if the server still reports pending tape
+        // change events)
+        if (display.getCurrentScreen() == SCREEN_ALERT) {
+            if (ev.gesture != TOUCH_DRAG) {
+                alertDismissed = true;
+                refreshDisplay();
+            }
+            continue;
+        }
+
+        switch (ev.gesture) {
+            case TOUCH_TAP:
+                selectTab(display.getTabFromTouch(ev.x, ev.y));
+                break;
+            case TOUCH_SWIPE_LEFT:
+                selectTab(currentTab + 1);
+                break;
+            case TOUCH_SWIPE_RIGHT:
+                selectTab(currentTab - 1);
+                break;
+            case TOUCH_LONG_PRESS:
+                // Force a refresh on the next loop pass
+                lastPoll = millis() - (unsigned long)settings.get().pollInterval * 1000UL;
+                break;
+            case TOUCH_DRAG:
+                // Finger moving up scrolls the list down
+                dragAccum -= ev.dy;
+                if (abs(dragAccum) >= SCROLL_STEP_PX) {
+                    int rows = dragAccum / SCROLL_STEP_PX;
+                    dragAccum -= rows * SCROLL_STEP_PX;
+                    scrollList(rows);
+                }
+                break;
+        }
+    }
+}
+
 void setup() {
     Serial.begin(115200);
     Serial.println();
     Serial.println("=== TapeBackarr CYD v" FW_VERSION " ===");
+    bootProfile.mark("serial");
 
-    // Initialize display first for visual feedback
-    display.begin();
-    display.showBoot("v" FW_VERSION);
-
-    // Load settings
+    // Settings first: WiFi needs the credentials
     settings.begin();
-    display.setBrightness(settings.get().brightness);
+    bootProfile.mark("settings");
 
-    delay(1500);  // Show boot screen briefly
-
-    // Initialize WiFi
+    // Association and DHCP run in the WiFi task while the panel, warm
+    // start and web server come up below
     wifiMgr.begin(settings);
+    bootProfile.mark("wifi_start");
+
+    display.begin();
+    display.showBoot("v" FW_VERSION);
+    touch.begin(display);
+    power.begin(settings, display, touch);
+    touch.setWakeHandler([](void*) { return power.wake(); }, nullptr);
+    bootProfile.mark("display");
+
+    // Last poll from before the power cycle, up while WiFi connects
+    warmStart.begin();
+    bool warm = settings.isConfigured() &&
+                warmStart.load(dashboardData, activeJobs, drives);
+    if (warm) {
+        display.setStale(true);
+        renderTabs();
+        refreshDisplay();
+    }
+    bootProfile.mark("warm_start");
 
     if (wifiMgr.getState() == WIFI_STATE_AP_MODE) {
         display.showAPMode(wifiMgr.getAPName(), wifiMgr.getIP());
-    } else {
+    } else if (!warm) {
         display.showConnecting(settings.get().wifiSSID);
     }
 
-    // Initialize API client
-    apiClient.begin(settings);
+    // API client and the task that polls with it
+    apiClient.begin();
+    netTask.begin(apiClient);
+    discovery.begin(settings, apiClient);
 
     // Start web server (works in both STA and AP mode)
-    webServer.begin(settings, wifiMgr, apiClient);
+    webServer.begin(settings, wifiMgr, apiClient, power, display, discovery,
+                    bootProfile, apiCapture);
+    bootProfile.mark("web_server");
+
+    // Recording of API answers; replays a capture instead of polling the
+    // server if one was armed (needs SPIFFS, mounted by the web server)
+    apiCapture.begin(apiClient);
+
+    // loop() runs in this task: watch it from here on
+    loopLatency.begin(true);
+
+    // Allocation accounting and stack high-water marks. loop() draws
+    // unless it says otherwise.
+    HeapMonitor::watchTask(nullptr, HEAP_RENDER);
+    HeapMonitor::watchTask("net", HEAP_API);
+    HeapMonitor::watchTask("touch", HEAP_OTHER);
+    HeapMonitor::watchTask("async_tcp", HEAP_WEB);
+    HeapMonitor::watchTask("wifi", HEAP_WIFI);
+    HeapMonitor::watchTask("tiT", HEAP_WIFI);            // lwIP
+    HeapMonitor::watchTask("arduino_events", HEAP_WIFI);
+    HeapMonitor::update();
 
     Serial.println("Setup complete");
 }
 
 void loop() {
-    // Update WiFi state
-    wifiMgr.update();
+    // Closes the previous pass, whichever return it took
+    loopLatency.beginIteration(LOOP_WIFI);
+
+    {
+        HeapMonitor::Scope heap(HEAP_WIFI);
+
+        // Update WiFi state
+        wifiMgr.update();
+        netTask.setLinkUp(wifiMgr.isConnected());
 
-    // Handle web server requests
-    webServer.handleClient();
+        // mDNS: server discovery and ".local" address cache
+        loopLatency.enter(LOOP_MDNS);
+        discovery.update(wifiMgr.isConnected());
+    }
 
-    // Update display animations
-    display.update();
+    // Captive-portal DNS and actions queued by web requests
+    loopLatency.enter(LOOP_WEB);
+    {
+        HeapMonitor::Scope heap(HEAP_WEB);
+        webServer.update();
+    }
 
     // Handle touch input
+    loopLatency.enter(LOOP_TOUCH);
     handleTouch();
 
+    // Idle dimming and power save
+    loopLatency.enter(LOOP_POWER);
+    power.update();
+
+    // Heap and stack history
+    HeapMonitor::update();
+    loopLatency.enter(LOOP_RENDER);
+
+    // Results from the network task
+    std::unique_ptr<PollResult> poll = netTask.takeResult();
+    if (poll) applyPoll(*poll);
+
     // Show AP mode screen if in AP mode
     if (wifiMgr.getState() == WIFI_STATE_AP_MODE) {
         if (display.getCurrentScreen() != SCREEN_AP_MODE) {
@@ -190,9 +428,13 @@ void loop() {
         return;
     }
 
-    // Show connecting screen while connecting
-    if (wifiMgr.getState() == WIFI_STATE_CONNECTING) {
-        if (display.getCurrentScreen() != SCREEN_CONNECTING) {
+    // Show connecting screen while connecting or waiting to retry
+    if (wifiMgr.getState() == WIFI_STATE_CONNECTING ||
+        wifiMgr.getState() == WIFI_STATE_DISCONNECTED) {
+        // Restored data stays up for the first connect attempt
+        bool warmConnect = initialBoot && display.isStale() &&
+                           wifiMgr.getState() == WIFI_STATE_CONNECTING;
+        if (!warmConnect && display.getCurrentScreen() != SCREEN_CONNECTING) {
             display.showConnecting(settings.get().wifiSSID);
         }
         return;
@@ -201,27 +443,24 @@ void loop() {
     // Once connected, do initial data fetch
     if (initialBoot && wifiMgr.isConnected()) {
         initialBoot = false;
+        bootProfile.mark("wifi_up");
         Serial.println("WiFi connected, fetching initial data...");
 
         if (settings.isConfigured()) {
-            fetchAllData();
-            refreshDisplay();
+            requestPoll();
         } else {
             display.showError("Not configured - open web UI", wifiMgr.getIP());
         }
     }
 
+    // Back from an outage: show the last data again until the next poll
+    if (!initialBoot && display.getCurrentScreen() == SCREEN_CONNECTING) {
+        refreshDisplay();
+    }
+
     // Periodic polling
     unsigned long pollMs = (unsigned long)settings.get().pollInterval * 1000UL;
-    if (wifiMgr.isConnected() && settings.isConfigured() &&
-        millis() - lastPoll >= pollMs) {
-        lastPoll = millis();
-        fetchAllData();
-
-        if (!apiClient.isConnected()) {
-            display.showError(apiClient.getLastError(), wifiMgr.getIP());
-        } else {
-            refreshDisplay();
-        }
+    if (millis() - lastPoll >= pollMs && !netTask.isPolling()) {
+        requestPoll();
     }
 }
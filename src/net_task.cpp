@@ -0,0 +1,108 @@
+#include "net_task.h"
+#include "latency.h"
+
+#define NET_STALL_MS  5000   // A poll round this long delays the screen's data
+
+enum NetPhase {
+    NET_DASHBOARD,
+    NET_JOBS,
+    NET_DRIVES,
+    NET_EVENTS,
+    NET_LTFS,
+    NET_PHASE_COUNT
+};
+
+static const char* const NET_PHASES[NET_PHASE_COUNT] = {
+    "get_dashboard", "get_jobs", "get_drives", "get_events", "get_ltfs_format"
+};
+
+// Not on the task watchdog: one request may legitimately take several
+// timeouts and retries
+static LatencyTracker netLatency("net", NET_PHASES, NET_PHASE_COUNT, NET_STALL_MS);
+
+void NetTask::begin(APIClient& api) {
+    _api = &api;
+    _requests = xQueueCreate(1, sizeof(ServerConfig*));
+    _results = xQueueCreate(1, sizeof(PollResult*));
+    _events = xEventGroupCreate();
+    xTaskCreatePinnedToCore(taskEntry, "net", NET_TASK_STACK, this,
+                            NET_TASK_PRIORITY, &_task, NET_TASK_CORE);
+}
+
+void NetTask::setLinkUp(bool up) {
+    if (up == _linkUp) return;
+    _linkUp = up;
+    if (up) xEventGroupSetBits(_events, NET_LINK_UP);
+    else xEventGroupClearBits(_events, NET_LINK_UP);
+}
+
+bool NetTask::requestPoll(const ServerConfig& server) {
+    if (isPolling()) return false;
+
+    ServerConfig* request = new ServerConfig(server);
+    xEventGroupSetBits(_events, NET_POLLING);
+    if (xQueueSend(_requests, &request, 0) != pdTRUE) {
+        xEventGroupClearBits(_events, NET_POLLING);
+        delete request;
+        return false;
+    }
+    return true;
+}
+
+bool NetTask::isPolling() const {
+    return xEventGroupGetBits(_events) & NET_POLLING;
+}
+
+std::unique_ptr<PollResult> NetTask::takeResult() {
+    PollResult* result = nullptr;
+    if (xQueueReceive(_results, &result, 0) != pdTRUE) return nullptr;
+    xEventGroupClearBits(_events, NET_POLLING);
+    return std::unique_ptr<PollResult>(result);
+}
+
+void NetTask::taskEntry(void* arg) {
+    static_cast<NetTask*>(arg)->run();
+}
+
+void NetTask::run() {
+    for (;;) {
+        ServerConfig* request = nullptr;
+        xQueueReceive(_requests, &request, portMAX_DELAY);
+        netLatency.beginIteration(NET_DASHBOARD);
+        PollResult* result = poll(*request);
+        netLatency.endIteration();
+        delete request;
+
+        // Never blocks: a result is only produced per request, and the
+        // next request waits until this one has been taken
+        xQueueSend(_results, &result, portMAX_DELAY);
+    }
+}
+
+PollResult* NetTask::poll(const ServerConfig& server) {
+    PollResult* r = new PollResult();
+    r->aborted = true;
+
+    // Check the link between requests: no point in waiting out timeouts
+    // for the rest of the round once WiFi is gone
+    _api->beginPoll(server);
+    if (!linkUp()) return r;
+    r->dashboard = _api->fetchDashboard();
+    if (!linkUp()) return r;
+    netLatency.enter(NET_JOBS);
+    r->jobs = _api->fetchActiveJobs();
+    if (!linkUp()) return r;
+    netLatency.enter(NET_DRIVES);
+    r->drives = _api->fetchDrives();
+    if (!linkUp()) return r;
+    netLatency.enter(NET_EVENTS);
+    r->tapeChanges = _api->fetchTapeChanges();
+    if (!linkUp()) return r;
+    netLatency.enter(NET_LTFS);
+    r->ltfs = _api->fetchLTFSFormatStatus();
+
+    r->aborted = false;
+    r->connected = _api->isConnected();
+    r->error = _api->getLastError();
+    return r;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/event_groups.h>
+#include "api_client.h"
+
+#define NET_TASK_STACK     8192   // Same as loopTask, which ran the polls before
+#define NET_TASK_PRIORITY  1
+#define NET_TASK_CORE      0      // With the WiFi stack; loop() and touch have core 1
+
+// Event group bits
+#define NET_LINK_UP   BIT0        // Set by loop() while WiFi is connected
+#define NET_POLLING   BIT1        // From requestPoll() until the result is taken
+
+// Everything one poll round fetched
+struct PollResult {
+    DashboardData dashboard;
+    std::vector<ActiveJobData> jobs;
+    std::vector<DriveData> drives;
+    std::vector<TapeChangeData> tapeChanges;
+    LTFSFormatStatus ltfs;
+    bool connected;
+    String error;
+    bool aborted;         // WiFi dropped mid-round: the data is incomplete
+};
+
+// Polls TapeBackarr in its own task, so however long the server or the
+// link takes to answer, loop() keeps handling touch and drawing.
+//
+// loop() hands over one request at a time through a one-slot queue and
+// picks the result up from another; the WiFi state reaches the task
+// through an event group, so a round stops early when the link drops.
+class NetTask {
+public:
+    void begin(APIClient& api);
+
+    // Call from loop()
+    void setLinkUp(bool up);
+
+    // Start a poll round. False if one is still in flight.
+    bool requestPoll(const ServerConfig& server);
+    bool isPolling() const;
+
+    // The finished round, or nullptr
+    std::unique_ptr<PollResult> takeResult();
+
+private:
+    APIClient* _api = nullptr;
+    TaskHandle_t _task = nullptr;
+    QueueHandle_t _requests = nullptr;    // ServerConfig*
+    QueueHandle_t _results = nullptr;     // PollResult*
+    EventGroupHandle_t _events = nullptr;
+    bool _linkUp = false;
+
+    static void taskEntry(void* arg);
+    void run();
+    PollResult* poll(const ServerConfig& server);
+    bool linkUp() const { return xEventGroupGetBits(_events) & NET_LINK_UP; }
+};
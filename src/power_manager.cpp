@@ -0,0 +1,185 @@
+#include "power_manager.h"
+#include "display.h"
+#include <WiFi.h>
+
+#include "touch_input.h"
+
+#ifdef CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#endif
+
+#define DIM_BRIGHTNESS     10    // % while dimmed
+#define FADE_DIM_MS        1000
+#define FADE_OFF_MS        2000
+#define FADE_WAKE_MS       150
+
+#define CPU_ACTIVE_MHZ     240
+#define CPU_IDLE_MHZ       80
+
+// Rough supply-current model for the CYD2USB (bench estimates), used to
+// turn the time spent in each state into an average
+#define CURRENT_BOARD_MA       10    // Regulator, USB-UART, touch controller
+#define CURRENT_CPU_ACTIVE_MA  50    // 240 MHz, WiFi min modem sleep
+#define CURRENT_CPU_IDLE_MA    25    // 80 MHz, WiFi max modem sleep
+#define CURRENT_BACKLIGHT_MA   55    // Backlight at 100 %
+
+void PowerManager::begin(SettingsManager& settings, Display& display,
+                         TouchInput& touch) {
+    _settings = &settings;
+    _display = &display;
+    _touch = &touch;
+    _lastActivity = millis();
+    _lastSample = millis();
+
+#ifdef CONFIG_PM_ENABLE
+    // Frequency scaling from the start; light sleep only in low power
+    esp_sleep_enable_gpio_wakeup();
+    configureSleep(false);
+#endif
+
+    setState(POWER_ACTIVE);
+}
+
+void PowerManager::update() {
+    accumulate();
+
+    const AppSettings& s = _settings->get();
+    // Activity first: a wake() after it cannot make idleMs wrap
+    unsigned long lastActivity = _lastActivity;
+    unsigned long idleMs = millis() - lastActivity;
+    unsigned long dimMs = (unsigned long)s.idleDimMin * 60000UL;
+    unsigned long offMs = (unsigned long)s.idleOffMin * 60000UL;
+
+    PowerState target = POWER_ACTIVE;
+    if (s.idleOffMin > 0 && idleMs >= offMs) {
+        target = POWER_SCREEN_OFF;
+    } else if (s.idleDimMin > 0 && idleMs >= dimMs) {
+        target = POWER_DIMMED;
+    }
+    if (target != _state) setState(target);
+
+    setLowPower(s.powerSave && _state != POWER_ACTIVE && !_polling);
+}
+
+bool PowerManager::wake() {
+    _lastActivity = millis();
+    return _state == POWER_SCREEN_OFF;
+}
+
+void PowerManager::beginPoll() {
+    _polling = true;
+    setLowPower(false);
+}
+
+void PowerManager::endPoll() {
+    _polling = false;
+}
+
+void PowerManager::applySettings() {
+    _display->setBrightness(backlightFor(_state));
+}
+
+const char* PowerManager::getStateName() const {
+    switch (_state) {
+        case POWER_ACTIVE:     return "active";
+        case POWER_DIMMED:     return "dimmed";
+        case POWER_SCREEN_OFF: return "screen_off";
+    }
+    return "unknown";
+}
+
+float PowerManager::getBacklightDuty() const {
+    if (_totalMs == 0) return 1.0f;
+    return (float)((double)_backlightPctMs / 100.0 / (double)_totalMs);
+}
+
+float PowerManager::getIdleFraction() const {
+    if (_totalMs == 0) return 0.0f;
+    return (float)((double)_lowPowerMs / (double)_totalMs);
+}
+
+float PowerManager::getAverageCurrentMa() const {
+    float idle = getIdleFraction();
+    return CURRENT_BOARD_MA +
+           CURRENT_CPU_ACTIVE_MA * (1.0f - idle) +
+           CURRENT_CPU_IDLE_MA * idle +
+           CURRENT_BACKLIGHT_MA * getBacklightDuty();
+}
+
+void PowerManager::setState(PowerState state) {
+    accumulate();
+    PowerState was = _state;
+    _state = state;
+
+    uint16_t fade = FADE_WAKE_MS;
+    if (state == POWER_DIMMED) fade = FADE_DIM_MS;
+    else if (state == POWER_SCREEN_OFF) fade = FADE_OFF_MS;
+    _display->fadeBrightness(backlightFor(state), fade);
+
+    if (was != state) {
+        Serial.printf("Power: %s (backlight duty %.0f%%, ~%.0f mA avg)\n",
+                      getStateName(), getBacklightDuty() * 100.0f,
+                      getAverageCurrentMa());
+    }
+}
+
+void PowerManager::setLowPower(bool on) {
+    if (on == _lowPower) return;
+    accumulate();
+    _lowPower = on;
+
+    // Modem sleep needs STA-only mode; in AP mode the radio stays awake
+    if (WiFi.getMode() == WIFI_STA) {
+        WiFi.setSleep(on ? WIFI_PS_MAX_MODEM : WIFI_PS_MIN_MODEM);
+    }
+#ifdef CONFIG_PM_ENABLE
+    // FreeRTOS idle drops into light sleep; a pen-down wakes it. The wake
+    // is armed before sleep is allowed and disarmed after it is not.
+    if (on) {
+        _touch->setSleepWake(true);
+        if (!configureSleep(true)) _touch->setSleepWake(false);
+    } else {
+        configureSleep(false);
+        _touch->setSleepWake(false);
+    }
+#else
+    setCpuFrequencyMhz(on ? CPU_IDLE_MHZ : CPU_ACTIVE_MHZ);
+#endif
+}
+
+#ifdef CONFIG_PM_ENABLE
+// Returns false (and logs) if the power management driver refuses
+bool PowerManager::configureSleep(bool lightSleep) {
+    esp_pm_config_esp32_t pm = {};
+    pm.max_freq_mhz = CPU_ACTIVE_MHZ;
+    pm.min_freq_mhz = CPU_IDLE_MHZ;
+    pm.light_sleep_enable = lightSleep;
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err != ESP_OK) {
+        Serial.printf("Power: esp_pm_configure failed (%s)\n", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+#endif
+
+void PowerManager::accumulate() {
+    unsigned long now = millis();
+    unsigned long dt = now - _lastSample;
+    _lastSample = now;
+
+    _totalMs += dt;
+    _backlightPctMs += (uint64_t)backlightFor(_state) * dt;
+    if (_lowPower) _lowPowerMs += dt;
+}
+
+uint8_t PowerManager::backlightFor(PowerState state) const {
+    uint8_t full = _settings->get().brightness;
+    switch (state) {
+        case POWER_ACTIVE:     return full;
+        case POWER_DIMMED:     return min(full, (uint8_t)DIM_BRIGHTNESS);
+        case POWER_SCREEN_OFF: return 0;
+    }
+    return full;
+}
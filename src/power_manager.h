@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "settings.h"
+
+class Display;
+class TouchInput;
+
+enum PowerState {
+    POWER_ACTIVE,       // Backlight at configured brightness
+    POWER_DIMMED,       // Backlight dimmed after idleDim minutes
+    POWER_SCREEN_OFF    // Backlight off after idleOff minutes
+};
+
+// Idle policy for an unattended monitor.
+//
+// Without touch input the backlight dims and then switches off. While the
+// screen is not active the CPU drops to 80 MHz and the radio uses maximum
+// modem sleep between polls (automatic light sleep where the SDK was built
+// with power management, only then and only with power save on). Touch or
+// a tape alert wakes everything at once.
+// All state changes happen in update() on the loop task.
+//
+// Time spent in each state is integrated to report backlight duty and an
+// estimated average supply current.
+class PowerManager {
+public:
+    void begin(SettingsManager& settings, Display& display, TouchInput& touch);
+    void update();
+
+    // Any task: records activity, which the next update() on the loop
+    // task acts on. Returns true if the screen is off, i.e. the touch that
+    // wakes it should not also act as a tap.
+    bool wake();
+
+    // Keep the radio responsive while a poll cycle is in flight
+    void beginPoll();
+    void endPoll();
+
+    // Re-apply brightness after a settings change
+    void applySettings();
+
+    PowerState getState() const { return _state; }
+    const char* getStateName() const;
+
+    float getBacklightDuty() const;     // Mean backlight level, 0-1
+    float getIdleFraction() const;      // Share of time in low-power mode
+    float getAverageCurrentMa() const;  // Estimated board supply current
+
+private:
+    SettingsManager* _settings = nullptr;
+    Display* _display = nullptr;
+    TouchInput* _touch = nullptr;
+    std::atomic<PowerState> _state{POWER_ACTIVE};
+    std::atomic<unsigned long> _lastActivity{0};   // Written by wake()
+    bool _lowPower = false;
+    bool _polling = false;
+
+    // Integrated since boot
+    unsigned long _lastSample = 0;
+    uint64_t _totalMs = 0;
+    uint64_t _backlightPctMs = 0;
+    uint64_t _lowPowerMs = 0;
+
+    void setState(PowerState state);
+    void setLowPower(bool on);
+#ifdef CONFIG_PM_ENABLE
+    bool configureSleep(bool lightSleep);
+#endif
+    void accumulate();
+    uint8_t backlightFor(PowerState state) const;
+};
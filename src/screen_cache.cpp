@@ -0,0 +1,142 @@
+#include "screen_cache.h"
+
+// RLE format, one code per run of equal pixels:
+//   byte = (n << 4) | index
+//   n < 15  : run of n + 1 pixels
+//   n == 15 : run of 16 + varint (LEB128) pixels
+#define RLE_SHORT_MAX  15
+
+bool ScreenCache::begin(int width, int height, const uint16_t* palette,
+                        uint8_t count) {
+    _paletteCount = count > 16 ? 16 : count;
+    memcpy(_palette, palette, _paletteCount * sizeof(uint16_t));
+
+    _canvas.setColorDepth(4);
+    if (!_canvas.createSprite(width, height)) {
+        Serial.println("Screen cache disabled: not enough memory");
+        _enabled = false;
+        return false;
+    }
+    _canvas.createPalette(_palette, _paletteCount);
+    _scratch.reserve(SCREEN_CACHE_MAX_SLOT);
+    _enabled = true;
+    return true;
+}
+
+uint8_t ScreenCache::paletteIndex(uint16_t color) const {
+    for (uint8_t i = 0; i < _paletteCount; i++) {
+        if (_palette[i] == color) return i;
+    }
+    return 0;
+}
+
+bool ScreenCache::has(int slot) const {
+    return _enabled && slot >= 0 && slot < SCREEN_CACHE_SLOTS &&
+           !_slots[slot].empty();
+}
+
+bool ScreenCache::store(int slot) {
+    if (!_enabled || slot < 0 || slot >= SCREEN_CACHE_SLOTS) return true;
+
+    _scratch.clear();
+    encode(_scratch);
+
+    if (_scratch.size() > SCREEN_CACHE_MAX_SLOT) {
+        // Too busy to be worth caching — drop the stale copy
+        bool had = !_slots[slot].empty();
+        std::vector<uint8_t>().swap(_slots[slot]);
+        if (had) _serial[slot]++;
+        return true;
+    }
+
+    if (_scratch == _slots[slot]) return false;
+
+    _slots[slot].assign(_scratch.begin(), _scratch.end());
+    _slots[slot].shrink_to_fit();
+    _serial[slot]++;
+    return true;
+}
+
+bool ScreenCache::blit(int slot, lgfx::LovyanGFX* dst) {
+    if (!has(slot)) return false;
+    if (!decode(_slots[slot])) return false;
+    _canvas.pushSprite(dst, 0, 0);
+    return true;
+}
+
+void ScreenCache::encode(std::vector<uint8_t>& out) {
+    const uint8_t* buf = (const uint8_t*)_canvas.getBuffer();
+    const size_t total = (size_t)_canvas.width() * _canvas.height();
+
+    // Two pixels per byte, first pixel in the high nibble
+    auto px = [buf](size_t i) -> uint8_t {
+        uint8_t b = buf[i >> 1];
+        return (i & 1) ? (b & 0x0F) : (b >> 4);
+    };
+
+    size_t i = 0;
+    while (i < total) {
+        uint8_t c = px(i);
+        size_t run = 1;
+        while (i + run < total && px(i + run) == c) run++;
+
+        if (run <= RLE_SHORT_MAX) {
+            out.push_back(((run - 1) << 4) | c);
+        } else {
+            out.push_back((RLE_SHORT_MAX << 4) | c);
+            size_t extra = run - (RLE_SHORT_MAX + 1);
+            do {
+                uint8_t b = extra & 0x7F;
+                extra >>= 7;
+                out.push_back(extra ? (b | 0x80) : b);
+            } while (extra);
+        }
+        i += run;
+
+        if (out.size() > SCREEN_CACHE_MAX_SLOT) return;  // Caller rejects
+    }
+}
+
+bool ScreenCache::decode(const std::vector<uint8_t>& in) {
+    uint8_t* buf = (uint8_t*)_canvas.getBuffer();
+    const size_t total = (size_t)_canvas.width() * _canvas.height();
+
+    size_t i = 0;
+    size_t p = 0;
+    while (p < in.size() && i < total) {
+        uint8_t code = in[p++];
+        uint8_t c = code & 0x0F;
+        size_t run = (code >> 4) + 1;
+        if ((code >> 4) == RLE_SHORT_MAX) {
+            size_t extra = 0;
+            int shift = 0;
+            uint8_t b;
+            do {
+                if (p >= in.size()) return false;
+                b = in[p++];
+                extra |= (size_t)(b & 0x7F) << shift;
+                shift += 7;
+            } while (b & 0x80);
+            run = RLE_SHORT_MAX + 1 + extra;
+        }
+        if (i + run > total) return false;
+
+        // Odd leading pixel, whole bytes, odd trailing pixel
+        if (i & 1) {
+            buf[i >> 1] = (buf[i >> 1] & 0xF0) | c;
+            i++;
+            run--;
+        }
+        size_t bytes = run >> 1;
+        if (bytes) {
+            memset(&buf[i >> 1], (c << 4) | c, bytes);
+            i += bytes * 2;
+            run -= bytes * 2;
+        }
+        if (run) {
+            buf[i >> 1] = (buf[i >> 1] & 0x0F) | (c << 4);
+            i++;
+        }
+    }
+    return i == total;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+#include "LGFX_Config.h"
+
+#define SCREEN_CACHE_SLOTS     3       // Dashboard, Jobs, Drives
+#define SCREEN_CACHE_MAX_SLOT  16384   // bytes per compressed screen
+
+// Off-screen copies of the tab screens.
+//
+// Screens are drawn into one shared 4-bit palette canvas (38 KB for
+// 320x240), then run-length encoded into a small per-slot buffer. Showing
+// a slot decodes it back into the canvas and pushes it with a single
+// pushSprite, so a tab switch never wipes or repaints the panel piecemeal.
+class ScreenCache {
+public:
+    // Allocates the canvas. Returns false (and stays disabled) if there is
+    // not enough contiguous heap; callers then draw straight to the panel.
+    bool begin(int width, int height, const uint16_t* palette, uint8_t count);
+
+    bool isEnabled() const { return _enabled; }
+    lgfx::LGFX_Sprite* canvas() { return _enabled ? &_canvas : nullptr; }
+
+    // Palette index for an RGB565 colour (nearest entry 0 if unknown)
+    uint8_t paletteIndex(uint16_t color) const;
+
+    // Compress the canvas into a slot. Returns true if the slot content
+    // changed (or could not be stored and was invalidated).
+    bool store(int slot);
+
+    // Decode a slot into the canvas and push it to dst at (0, 0).
+    bool blit(int slot, lgfx::LovyanGFX* dst);
+
+    bool has(int slot) const;
+    uint32_t serial(int slot) const { return _serial[slot]; }
+    size_t slotBytes(int slot) const { return _slots[slot].size(); }
+
+private:
+    lgfx::LGFX_Sprite _canvas;
+    bool _enabled = false;
+    uint16_t _palette[16] = {};
+    uint8_t _paletteCount = 0;
+    std::vector<uint8_t> _slots[SCREEN_CACHE_SLOTS];
+    uint32_t _serial[SCREEN_CACHE_SLOTS] = {};
+    std::vector<uint8_t> _scratch;   // Encoder output, reused
+
+    void encode(std::vector<uint8_t>& out);
+    bool decode(const std::vector<uint8_t>& in);
+};
@@ -1,4 +1,79 @@
 #include "settings.h"
+#include <esp_rom_crc.h>
+
+#define SETTINGS_KEY    "settings"
+#define SETTINGS_MAGIC  0x43594453   // "SDYC"
+
+struct SettingsHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;     // Record bytes after the header
+    uint32_t crc;        // CRC32 of the records
+};
+
+// Record: tag, 16-bit length, value. Numbers are little-endian in as few
+// bytes as they need, so a field can be widened later. Never renumber or
+// reuse a tag.
+enum SettingsTag : uint8_t {
+    TAG_WIFI_SSID = 1,
+    TAG_WIFI_PASS,
+    TAG_IP_ADDR,
+    TAG_IP_GW,
+    TAG_IP_MASK,
+    TAG_IP_DNS,
+    TAG_SRV_HOST,
+    TAG_SRV_PORT,
+    TAG_API_KEY,
+    TAG_USE_HTTPS,
+    TAG_BRIGHTNESS,
+    TAG_POLL_INT,
+    TAG_DIM_MIN,
+    TAG_OFF_MIN,
+    TAG_PWR_SAVE,
+    TAG_DEV_NAME,
+};
+
+// One key per field, as written before the settings blob
+static const char* const LEGACY_KEYS[] = {
+    "wifi_ssid", "wifi_pass", "ip_addr", "ip_gw", "ip_mask", "ip_dns",
+    "srv_host", "srv_port", "api_key", "use_https", "brightness", "poll_int",
+    "dim_min", "off_min", "pwr_save", "dev_name",
+};
+
+static void putRecord(std::vector<uint8_t>& out, uint8_t tag,
+                      const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    out.push_back(tag);
+    out.push_back(len & 0xFF);
+    out.push_back(len >> 8);
+    out.insert(out.end(), p, p + len);
+}
+
+static void putString(std::vector<uint8_t>& out, uint8_t tag, const String& value) {
+    putRecord(out, tag, value.c_str(), value.length());
+}
+
+static void putUInt(std::vector<uint8_t>& out, uint8_t tag, uint32_t value) {
+    uint8_t buf[4];
+    size_t n = 0;
+    do {
+        buf[n++] = value & 0xFF;
+        value >>= 8;
+    } while (value);
+    putRecord(out, tag, buf, n);
+}
+
+static uint32_t readUInt(const uint8_t* p, size_t len) {
+    uint32_t value = 0;
+    for (size_t i = min(len, (size_t)4); i-- > 0; ) value = (value << 8) | p[i];
+    return value;
+}
+
+static String readString(const uint8_t* p, size_t len) {
+    String s;
+    s.concat((const char*)p, len);
+    return s;
+}
 
 void SettingsManager::begin() {
     _prefs.begin("tapebackarr", false);
@@ -6,27 +81,164 @@ void SettingsManager::begin() {
 }
 
 void SettingsManager::load() {
+    if (!loadBlob()) {
+        setDefaults();
+        _stored.clear();
+        if (_prefs.isKey("wifi_ssid")) {
+            // First boot after the update: move the per-key settings over
+            loadLegacy();
+            save();
+            for (const char* key : LEGACY_KEYS) _prefs.remove(key);
+            Serial.println("Settings migrated to blob storage");
+        }
+    }
+
+    memset(&_link, 0, sizeof(_link));
+    if (_prefs.getBytesLength("wifi_link") == sizeof(_link)) {
+        _prefs.getBytes("wifi_link", &_link, sizeof(_link));
+    }
+}
+
+void SettingsManager::setDefaults() {
+    _settings.wifiSSID       = "";
+    _settings.wifiPassword   = "";
+    _settings.staticIP       = "";
+    _settings.gateway        = "";
+    _settings.subnet         = "";
+    _settings.dns            = "";
+    _settings.serverHost     = DEFAULT_SERVER_HOST;
+    _settings.serverPort     = DEFAULT_SERVER_PORT;
+    _settings.apiKey         = DEFAULT_API_KEY;
+    _settings.useHTTPS       = false;
+    _settings.brightness     = DEFAULT_BRIGHTNESS;
+    _settings.pollInterval   = DEFAULT_POLL_INTERVAL;
+    _settings.idleDimMin     = DEFAULT_IDLE_DIM_MIN;
+    _settings.idleOffMin     = DEFAULT_IDLE_OFF_MIN;
+    _settings.powerSave      = true;
+    _settings.deviceName     = DEFAULT_DEVICE_NAME;
+}
+
+bool SettingsManager::loadBlob() {
+    std::vector<uint8_t> blob(SETTINGS_BLOB_MAX);
+    size_t len = _prefs.getBytes(SETTINGS_KEY, blob.data(), blob.size());
+    if (!len) return false;
+    blob.resize(len);
+
+    if (!deserialize(blob.data(), blob.size())) {
+        Serial.println("Settings blob invalid, using defaults");
+        return false;
+    }
+    _stored.swap(blob);
+    return true;
+}
+
+void SettingsManager::loadLegacy() {
     _settings.wifiSSID       = _prefs.getString("wifi_ssid", "");
     _settings.wifiPassword   = _prefs.getString("wifi_pass", "");
+    _settings.staticIP       = _prefs.getString("ip_addr", "");
+    _settings.gateway        = _prefs.getString("ip_gw", "");
+    _settings.subnet         = _prefs.getString("ip_mask", "");
+    _settings.dns            = _prefs.getString("ip_dns", "");
     _settings.serverHost     = _prefs.getString("srv_host", DEFAULT_SERVER_HOST);
     _settings.serverPort     = _prefs.getUShort("srv_port", DEFAULT_SERVER_PORT);
     _settings.apiKey         = _prefs.getString("api_key", DEFAULT_API_KEY);
     _settings.useHTTPS       = _prefs.getBool("use_https", false);
     _settings.brightness     = _prefs.getUChar("brightness", DEFAULT_BRIGHTNESS);
     _settings.pollInterval   = _prefs.getUShort("poll_int", DEFAULT_POLL_INTERVAL);
+    _settings.idleDimMin     = _prefs.getUShort("dim_min", DEFAULT_IDLE_DIM_MIN);
+    _settings.idleOffMin     = _prefs.getUShort("off_min", DEFAULT_IDLE_OFF_MIN);
+    _settings.powerSave      = _prefs.getBool("pwr_save", true);
     _settings.deviceName     = _prefs.getString("dev_name", DEFAULT_DEVICE_NAME);
 }
 
+std::vector<uint8_t> SettingsManager::serialize() const {
+    std::vector<uint8_t> out(sizeof(SettingsHeader));
+    putString(out, TAG_WIFI_SSID,  _settings.wifiSSID);
+    putString(out, TAG_WIFI_PASS,  _settings.wifiPassword);
+    putString(out, TAG_IP_ADDR,    _settings.staticIP);
+    putString(out, TAG_IP_GW,      _settings.gateway);
+    putString(out, TAG_IP_MASK,    _settings.subnet);
+    putString(out, TAG_IP_DNS,     _settings.dns);
+    putString(out, TAG_SRV_HOST,   _settings.serverHost);
+    putUInt(out,   TAG_SRV_PORT,   _settings.serverPort);
+    putString(out, TAG_API_KEY,    _settings.apiKey);
+    putUInt(out,   TAG_USE_HTTPS,  _settings.useHTTPS);
+    putUInt(out,   TAG_BRIGHTNESS, _settings.brightness);
+    putUInt(out,   TAG_POLL_INT,   _settings.pollInterval);
+    putUInt(out,   TAG_DIM_MIN,    _settings.idleDimMin);
+    putUInt(out,   TAG_OFF_MIN,    _settings.idleOffMin);
+    putUInt(out,   TAG_PWR_SAVE,   _settings.powerSave);
+    putString(out, TAG_DEV_NAME,   _settings.deviceName);
+
+    SettingsHeader hdr;
+    hdr.magic   = SETTINGS_MAGIC;
+    hdr.version = SETTINGS_VERSION;
+    hdr.length  = out.size() - sizeof(hdr);
+    hdr.crc     = esp_rom_crc32_le(0, out.data() + sizeof(hdr), hdr.length);
+    memcpy(out.data(), &hdr, sizeof(hdr));
+    return out;
+}
+
+bool SettingsManager::deserialize(const uint8_t* data, size_t len) {
+    SettingsHeader hdr;
+    if (len < sizeof(hdr)) return false;
+    memcpy(&hdr, data, sizeof(hdr));
+    if (hdr.magic != SETTINGS_MAGIC || hdr.length != len - sizeof(hdr)) return false;
+    if (hdr.version > SETTINGS_VERSION) {
+        Serial.printf("Settings version %u is newer than this firmware\n", hdr.version);
+        return false;
+    }
+    const uint8_t* p = data + sizeof(hdr);
+    const uint8_t* end = p + hdr.length;
+    if (esp_rom_crc32_le(0, p, hdr.length) != hdr.crc) return false;
+
+    // Later layout versions: migrate older blobs here
+
+    setDefaults();
+    while (end - p >= 3) {
+        uint8_t tag = p[0];
+        size_t n = p[1] | (p[2] << 8);
+        p += 3;
+        if ((size_t)(end - p) < n) return false;
+
+        switch (tag) {
+            case TAG_WIFI_SSID:  _settings.wifiSSID     = readString(p, n); break;
+            case TAG_WIFI_PASS:  _settings.wifiPassword = readString(p, n); break;
+            case TAG_IP_ADDR:    _settings.staticIP     = readString(p, n); break;
+            case TAG_IP_GW:      _settings.gateway      = readString(p, n); break;
+            case TAG_IP_MASK:    _settings.subnet       = readString(p, n); break;
+            case TAG_IP_DNS:     _settings.dns          = readString(p, n); break;
+            case TAG_SRV_HOST:   _settings.serverHost   = readString(p, n); break;
+            case TAG_SRV_PORT:   _settings.serverPort   = readUInt(p, n); break;
+            case TAG_API_KEY:    _settings.apiKey       = readString(p, n); break;
+            case TAG_USE_HTTPS:  _settings.useHTTPS     = readUInt(p, n) != 0; break;
+            case TAG_BRIGHTNESS: _settings.brightness   = readUInt(p, n); break;
+            case TAG_POLL_INT:   _settings.pollInterval = readUInt(p, n); break;
+            case TAG_DIM_MIN:    _settings.idleDimMin   = readUInt(p, n); break;
+            case TAG_OFF_MIN:    _settings.idleOffMin   = readUInt(p, n); break;
+            case TAG_PWR_SAVE:   _settings.powerSave    = readUInt(p, n) != 0; break;
+            case TAG_DEV_NAME:   _settings.deviceName   = readString(p, n); break;
+            default: break;      // Written by newer firmware
+        }
+        p += n;
+    }
+    return p == end;
+}
+
 void SettingsManager::save() {
-    _prefs.putString("wifi_ssid", _settings.wifiSSID);
-    _prefs.putString("wifi_pass", _settings.wifiPassword);
-    _prefs.putString("srv_host", _settings.serverHost);
-    _prefs.putUShort("srv_port", _settings.serverPort);
-    _prefs.putString("api_key", _settings.apiKey);
-    _prefs.putBool("use_https", _settings.useHTTPS);
-    _prefs.putUChar("brightness", _settings.brightness);
-    _prefs.putUShort("poll_int", _settings.pollInterval);
-    _prefs.putString("dev_name", _settings.deviceName);
+    std::vector<uint8_t> blob = serialize();
+    if (blob == _stored) return;
+
+    if (blob.size() > SETTINGS_BLOB_MAX ||
+        _prefs.putBytes(SETTINGS_KEY, blob.data(), blob.size()) != blob.size()) {
+        Serial.println("Settings save failed");
+        return;
+    }
+    _stored.swap(blob);
+}
+
+void SettingsManager::saveLinkCache() {
+    _prefs.putBytes("wifi_link", &_link, sizeof(_link));
 }
 
 void SettingsManager::reset() {
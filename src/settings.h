@@ -2,6 +2,7 @@
 
 #include <Arduino.h>
 #include <Preferences.h>
+#include <vector>
 
 // Default values
 #define DEFAULT_DEVICE_NAME    "TapeBackarr-CYD"
@@ -10,12 +11,29 @@
 #define DEFAULT_API_KEY        ""
 #define DEFAULT_POLL_INTERVAL  5
 #define DEFAULT_BRIGHTNESS     100
+#define DEFAULT_IDLE_DIM_MIN   5
+#define DEFAULT_IDLE_OFF_MIN   30
+
+// Longest values the web UI accepts
+#define SSID_MAX_LEN           32
+#define WIFI_PASS_MAX_LEN      64
+#define IP_TEXT_MAX_LEN        15    // Dotted IPv4
+#define SERVER_HOST_MAX_LEN    128
+#define API_KEY_MAX_LEN        128
+#define DEVICE_NAME_MAX_LEN    32
+#define SETTING_TEXT_MAX       128   // Longest of the above that is shown
 
 struct AppSettings {
     // WiFi
     String wifiSSID;
     String wifiPassword;
 
+    // Static IPv4 configuration, DHCP if staticIP is empty
+    String staticIP;
+    String gateway;
+    String subnet;
+    String dns;
+
     // TapeBackarr server
     String serverHost;
     uint16_t serverPort;
@@ -26,22 +44,57 @@ struct AppSettings {
     uint8_t brightness;
     uint16_t pollInterval; // seconds
 
+    // Power
+    uint16_t idleDimMin;   // minutes without touch before dimming, 0 = never
+    uint16_t idleOffMin;   // minutes without touch before screen off, 0 = never
+    bool powerSave;        // WiFi modem sleep / low CPU clock while idle
+
     // Device
     String deviceName;
 };
 
+// Last successful association, so a reconnect can go straight to the
+// access point and skip the channel scan. Written by the WiFi manager
+// rather than the user, so it is stored apart from AppSettings. No lease
+// is kept: DHCP always runs, so the server sees every renewal.
+struct WiFiLinkCache {
+    char ssid[33];         // Network the entry belongs to, "" = empty
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+
+// AppSettings are stored as a single NVS blob: a header with a layout
+// version and CRC32, then one tagged record per field. A missing tag
+// loads its default and an unknown one is skipped, so fields can be added
+// without bumping the version; the version is only for changes the tags
+// cannot express. Settings from firmware that used one NVS key per field
+// are migrated on the first boot.
+#define SETTINGS_VERSION   1
+#define SETTINGS_BLOB_MAX  1024
+
 class SettingsManager {
 public:
     void begin();
     void load();
-    void save();
+    void save();     // Writes only if something changed since load/save
     void reset();
 
     AppSettings& get() { return _settings; }
 
+    WiFiLinkCache& getLinkCache() { return _link; }
+    void saveLinkCache();
+
     bool isConfigured() const;
 
 private:
     Preferences _prefs;
     AppSettings _settings;
+    WiFiLinkCache _link;
+    std::vector<uint8_t> _stored;   // Blob as last read or written
+
+    void setDefaults();
+    bool loadBlob();
+    void loadLegacy();
+    std::vector<uint8_t> serialize() const;
+    bool deserialize(const uint8_t* data, size_t len);
 };
@@ -0,0 +1,170 @@
+#include "snapshot.h"
+#include <ArduinoJson.h>
+
+static const char* const SECTION_NAMES[SNAP_SECTION_COUNT] = {
+    "dashboard", "jobs", "drives", "tape_changes", "ltfs"
+};
+
+const char* Snapshot::sectionName(int section) {
+    return (section >= 0 && section < SNAP_SECTION_COUNT)
+           ? SECTION_NAMES[section] : "";
+}
+
+static String dashboardJson(const DashboardData& d) {
+    if (!d.valid) return "null";
+
+    JsonDocument doc;
+    doc["tapes"]        = d.totalTapes;
+    doc["active_tapes"] = d.activeTapes;
+    doc["full_tapes"]   = d.fullTapes;
+    doc["jobs"]         = d.totalJobs;
+    doc["active_jobs"]  = d.activeJobs;
+    doc["drives"]       = d.totalDrives;
+    doc["capacity"]     = d.totalCapacityBytes;
+    doc["used"]         = d.usedCapacityBytes;
+
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+static String jobsJson(const std::vector<ActiveJobData>& jobs) {
+    JsonDocument doc;
+    JsonArray arr = doc.to<JsonArray>();
+    for (const auto& j : jobs) {
+        JsonObject o = arr.add<JsonObject>();
+        o["id"]            = j.id;
+        o["name"]          = j.name;
+        o["phase"]         = j.phase;
+        o["status"]        = j.status;
+        o["files"]         = j.fileCount;
+        o["total_files"]   = j.totalFiles;
+        o["bytes"]         = j.bytesWritten;
+        o["total_bytes"]   = j.totalBytes;
+        o["speed"]         = (int64_t)j.writeSpeed;
+        o["tape"]          = j.tapeLabel;
+        o["tape_capacity"] = j.tapeCapacityBytes;
+        o["tape_used"]     = j.tapeUsedBytes;
+        o["eta"]           = (int64_t)j.estimatedSecondsRemaining;
+        o["tape_eta"]      = (int64_t)j.tapeEstimatedSecondsRemaining;
+        o["scan_files"]    = j.scanFilesFound;
+        o["scan_dirs"]     = j.scanDirsScanned;
+        o["scan_bytes"]    = j.scanBytesFound;
+    }
+
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+static String drivesJson(const std::vector<DriveData>& drives) {
+    JsonDocument doc;
+    JsonArray arr = doc.to<JsonArray>();
+    for (const auto& d : drives) {
+        JsonObject o = arr.add<JsonObject>();
+        o["id"]      = d.id;
+        o["name"]    = d.displayName;
+        o["vendor"]  = d.vendor;
+        o["model"]   = d.model;
+        o["status"]  = d.status;
+        o["tape"]    = d.currentTape;
+        o["format"]  = d.formatType;
+        o["path"]    = d.devicePath;
+        o["enabled"] = d.enabled;
+    }
+
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+static String tapeChangesJson(const std::vector<TapeChangeData>& changes) {
+    JsonDocument doc;
+    JsonArray arr = doc.to<JsonArray>();
+    for (const auto& c : changes) {
+        JsonObject o = arr.add<JsonObject>();
+        o["id"]      = c.id;
+        o["reason"]  = c.reason;
+        o["status"]  = c.status;
+        o["tape_id"] = c.currentTapeId;
+    }
+
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+static String ltfsJson(const LTFSFormatStatus& s) {
+    if (!s.valid) return "null";
+
+    JsonDocument doc;
+    doc["active"]  = s.active;
+    doc["phase"]   = s.phase;
+    doc["path"]    = s.devicePath;
+    doc["pct"]     = s.progressPct;
+    doc["elapsed"] = s.elapsedSec;
+    doc["error"]   = s.error;
+
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+std::shared_ptr<const Snapshot> Snapshot::build(
+        const Snapshot* prev, uint32_t& changed,
+        const DashboardData& dashboard,
+        const std::vector<ActiveJobData>& jobs,
+        const std::vector<DriveData>& drives,
+        const std::vector<TapeChangeData>& tapeChanges,
+        const LTFSFormatStatus& ltfs) {
+    std::shared_ptr<Snapshot> snap = std::make_shared<Snapshot>();
+    snap->takenAt = millis();
+    snap->sections[SNAP_DASHBOARD]    = dashboardJson(dashboard);
+    snap->sections[SNAP_JOBS]         = jobsJson(jobs);
+    snap->sections[SNAP_DRIVES]       = drivesJson(drives);
+    snap->sections[SNAP_TAPE_CHANGES] = tapeChangesJson(tapeChanges);
+    snap->sections[SNAP_LTFS]         = ltfsJson(ltfs);
+
+    snap->dashboard = dashboard;
+    snap->tapeChanges = tapeChanges.size();
+    snap->jobs.reserve(jobs.size());
+    for (const auto& j : jobs) {
+        snap->jobs.push_back({ j.id, j.name, j.bytesWritten, j.totalBytes, j.writeSpeed });
+    }
+    snap->drives.reserve(drives.size());
+    for (const auto& d : drives) {
+        snap->drives.push_back({ d.id, d.displayName, d.status, d.enabled });
+    }
+
+    changed = 0;
+    for (int i = 0; i < SNAP_SECTION_COUNT; i++) {
+        if (!prev || prev->sections[i] != snap->sections[i]) changed |= 1u << i;
+    }
+    snap->seq = prev ? prev->seq + (changed ? 1 : 0) : 1;
+    return snap;
+}
+
+String Snapshot::message(uint32_t mask) const {
+    size_t len = 48;
+    for (int i = 0; i < SNAP_SECTION_COUNT; i++) {
+        if (mask & (1u << i)) len += sections[i].length() + 20;
+    }
+
+    String out;
+    out.reserve(len);
+    out += "{\"seq\":";
+    out += String(seq);
+    out += ",\"age\":";
+    out += String(millis() - takenAt);
+    out += ",\"full\":";
+    out += (mask == SNAP_ALL_SECTIONS) ? "true" : "false";
+    for (int i = 0; i < SNAP_SECTION_COUNT; i++) {
+        if (!(mask & (1u << i))) continue;
+        out += ",\"";
+        out += SECTION_NAMES[i];
+        out += "\":";
+        out += sections[i];
+    }
+    out += '}';
+    return out;
+}
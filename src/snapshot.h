@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+#include "api_client.h"
+
+enum SnapshotSection {
+    SNAP_DASHBOARD,
+    SNAP_JOBS,
+    SNAP_DRIVES,
+    SNAP_TAPE_CHANGES,
+    SNAP_LTFS,
+    SNAP_SECTION_COUNT
+};
+
+#define SNAP_ALL_SECTIONS  ((1u << SNAP_SECTION_COUNT) - 1)
+
+// Per-job and per-drive values exported by /metrics
+struct SnapshotJob {
+    int id;
+    String name;
+    int64_t bytesWritten;
+    int64_t totalBytes;
+    double writeSpeed;
+};
+
+struct SnapshotDrive {
+    int id;
+    String name;
+    String status;
+    bool enabled;
+};
+
+// The last polled TapeBackarr data as compact JSON, one string per
+// section, plus the numbers /metrics needs. Never modified once built:
+// the poll loop replaces the whole snapshot, and web responses keep the
+// one they started with alive through a shared_ptr.
+struct Snapshot {
+    uint32_t seq = 0;              // Bumped whenever any section changes
+    unsigned long takenAt = 0;     // millis() of the poll
+    String sections[SNAP_SECTION_COUNT];
+
+    DashboardData dashboard = {};
+    std::vector<SnapshotJob> jobs;
+    std::vector<SnapshotDrive> drives;
+    size_t tapeChanges = 0;        // Pending tape change requests
+
+    static const char* sectionName(int section);
+
+    // Build from a poll. 'changed' receives the sections that differ from
+    // 'prev' (all of them if there is no previous snapshot).
+    static std::shared_ptr<const Snapshot> build(
+        const Snapshot* prev, uint32_t& changed,
+        const DashboardData& dashboard,
+        const std::vector<ActiveJobData>& jobs,
+        const std::vector<DriveData>& drives,
+        const std::vector<TapeChangeData>& tapeChanges,
+        const LTFSFormatStatus& ltfs);
+
+    // {"seq":N,"age":ms,"full":bool,"<section>":...} with only the
+    // sections in mask
+    String message(uint32_t mask) const;
+};
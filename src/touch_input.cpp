@@ -0,0 +1,199 @@
+#include "touch_input.h"
+#include "display.h"
+
+#ifdef CONFIG_PM_ENABLE
+#include <driver/gpio.h>
+#include <hal/gpio_ll.h>
+#endif
+
+#define TOUCH_QUEUE_LEN        16
+#define TOUCH_FILTER_SAMPLES   3     // Reads per sample (median)
+#define TOUCH_MAX_SPREAD       20    // px, reject noisy samples
+#define TOUCH_SAMPLE_MS        10    // Sampling period while pressed
+#define TOUCH_RELEASE_SAMPLES  3     // Consecutive misses = pen up
+#define TOUCH_LAND_SAMPLES     5     // Retries while a press builds pressure
+#define TOUCH_SLOP             12    // px of movement before a press "moves"
+#define TOUCH_DRAG_STEP        2     // px, minimum drag delta reported
+#define TOUCH_LONG_PRESS_MS    700
+#define TOUCH_SWIPE_MIN        60    // px horizontal travel for a swipe
+#define TOUCH_SWIPE_MAX_MS     800
+
+void TouchInput::begin(Display& display) {
+    _display = &display;
+    _queue = xQueueCreate(TOUCH_QUEUE_LEN, sizeof(TouchEvent));
+
+    // Same core as loop() so the bus is never touched from two cores,
+    // but at a higher priority so sampling preempts long redraws
+    xTaskCreatePinnedToCore(taskEntry, "touch", 3072, this, 2, &_task, 1);
+
+    pinMode(TOUCH_IRQ_PIN, INPUT);
+    attachInterruptArg(digitalPinToInterrupt(TOUCH_IRQ_PIN), onPenIRQ,
+                       this, FALLING);
+}
+
+bool TouchInput::poll(TouchEvent& ev) {
+    if (!_queue) return false;
+    return xQueueReceive(_queue, &ev, 0) == pdTRUE;
+}
+
+void IRAM_ATTR TouchInput::onPenIRQ(void* arg) {
+    TouchInput* self = static_cast<TouchInput*>(arg);
+#ifdef CONFIG_PM_ENABLE
+    if (self->_sleepWake) {
+        gpio_ll_set_intr_type(&GPIO, (gpio_num_t)TOUCH_IRQ_PIN, GPIO_INTR_NEGEDGE);
+        self->_sleepWake = false;
+    }
+#endif
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->_task, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+void TouchInput::taskEntry(void* arg) {
+    static_cast<TouchInput*>(arg)->run();
+}
+
+void TouchInput::run() {
+    for (;;) {
+        // Sleep until the pen goes down
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // A pen still landing is below the pressure threshold; no new
+        // edge comes while it stays down, so keep sampling for a moment
+        uint16_t x = 0, y = 0;
+        bool down = sample(x, y);
+        for (int i = 0; !down && i < TOUCH_LAND_SAMPLES &&
+                        digitalRead(TOUCH_IRQ_PIN) == LOW; i++) {
+            vTaskDelay(pdMS_TO_TICKS(TOUCH_SAMPLE_MS));
+            down = sample(x, y);
+        }
+        if (!down) {
+            ulTaskNotifyTake(pdTRUE, 0);
+            continue;  // IRQ glitch or too light a press
+        }
+
+        // A press that only wakes the screen is tracked to release but
+        // produces no gestures
+        _suppress = _wakeHandler && _wakeHandler(_wakeCtx);
+
+        unsigned long downAt = millis();
+        uint16_t startX = x, startY = y;
+        uint16_t lastX = x, lastY = y;
+        uint16_t dragY = y;
+        bool moved = false;
+        bool dragging = false;
+        bool longPressed = false;
+        int misses = 0;
+
+        while (misses < TOUCH_RELEASE_SAMPLES) {
+            vTaskDelay(pdMS_TO_TICKS(TOUCH_SAMPLE_MS));
+            if (!sample(x, y)) {
+                misses++;
+                continue;
+            }
+            misses = 0;
+            lastX = x;
+            lastY = y;
+
+            int dx = (int)x - startX;
+            int dy = (int)y - startY;
+            if (!moved && (abs(dx) > TOUCH_SLOP || abs(dy) > TOUCH_SLOP)) {
+                moved = true;
+                dragging = !longPressed && abs(dy) > abs(dx);
+            }
+
+            if (dragging && abs((int)y - (int)dragY) >= TOUCH_DRAG_STEP) {
+                push(TOUCH_DRAG, startX, startY, 0, (int)y - (int)dragY);
+                dragY = y;
+            }
+
+            if (!moved && !longPressed &&
+                millis() - downAt >= TOUCH_LONG_PRESS_MS) {
+                longPressed = true;
+                push(TOUCH_LONG_PRESS, startX, startY, 0, 0);
+            }
+        }
+
+        // Pen up — classify what happened
+        int dx = (int)lastX - startX;
+        int dy = (int)lastY - startY;
+        if (!moved && !longPressed) {
+            push(TOUCH_TAP, startX, startY, 0, 0);
+        } else if (moved && !dragging && !longPressed &&
+                   abs(dx) >= TOUCH_SWIPE_MIN &&
+                   millis() - downAt <= TOUCH_SWIPE_MAX_MS) {
+            push(dx < 0 ? TOUCH_SWIPE_LEFT : TOUCH_SWIPE_RIGHT,
+                 startX, startY, dx, dy);
+        }
+
+        // Conversions toggle PENIRQ, so drop edges raised while sampling
+        ulTaskNotifyTake(pdTRUE, 0);
+    }
+}
+
+bool TouchInput::sample(uint16_t& x, uint16_t& y) {
+    uint16_t xs[TOUCH_FILTER_SAMPLES];
+    uint16_t ys[TOUCH_FILTER_SAMPLES];
+
+    // The controller only reports contact above its pressure threshold.
+    // Every read must see contact; a partial set means the pen is landing
+    // or lifting and the coordinates are unreliable.
+    for (int i = 0; i < TOUCH_FILTER_SAMPLES; i++) {
+        if (!_display->readTouch(xs[i], ys[i])) return false;
+    }
+
+    // Insertion sort — three elements
+    for (int i = 1; i < TOUCH_FILTER_SAMPLES; i++) {
+        for (int j = i; j > 0 && xs[j] < xs[j - 1]; j--) {
+            uint16_t t = xs[j]; xs[j] = xs[j - 1]; xs[j - 1] = t;
+        }
+        for (int j = i; j > 0 && ys[j] < ys[j - 1]; j--) {
+            uint16_t t = ys[j]; ys[j] = ys[j - 1]; ys[j - 1] = t;
+        }
+    }
+
+    if (xs[TOUCH_FILTER_SAMPLES - 1] - xs[0] > TOUCH_MAX_SPREAD ||
+        ys[TOUCH_FILTER_SAMPLES - 1] - ys[0] > TOUCH_MAX_SPREAD) {
+        return false;
+    }
+
+    x = xs[TOUCH_FILTER_SAMPLES / 2];
+    y = ys[TOUCH_FILTER_SAMPLES / 2];
+    return true;
+}
+
+void TouchInput::setWakeHandler(bool (*handler)(void*), void* ctx) {
+    _wakeCtx = ctx;
+    _wakeHandler = handler;
+}
+
+void TouchInput::setSleepWake(bool on) {
+#ifdef CONFIG_PM_ENABLE
+    if (on) {
+        _sleepWake = true;
+        gpio_wakeup_enable((gpio_num_t)TOUCH_IRQ_PIN, GPIO_INTR_LOW_LEVEL);
+    } else {
+        gpio_wakeup_disable((gpio_num_t)TOUCH_IRQ_PIN);
+        gpio_set_intr_type((gpio_num_t)TOUCH_IRQ_PIN, GPIO_INTR_NEGEDGE);
+        _sleepWake = false;
+    }
+#else
+    (void)on;
+#endif
+}
+
+void TouchInput::push(TouchGesture gesture, uint16_t x, uint16_t y,
+                      int16_t dx, int16_t dy) {
+    if (_suppress) return;
+
+    TouchEvent ev;
+    ev.gesture = gesture;
+    ev.x = x;
+    ev.y = y;
+    ev.dx = dx;
+    ev.dy = dy;
+    ev.timestamp = millis();
+    if (xQueueSend(_queue, &ev, 0) != pdTRUE) {
+        _dropped++;
+    }
+}
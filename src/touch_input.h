@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+class Display;
+
+// XPT2046 PENIRQ line (active LOW while the panel is pressed)
+#define TOUCH_IRQ_PIN 36
+
+enum TouchGesture {
+    TOUCH_TAP,
+    TOUCH_LONG_PRESS,
+    TOUCH_SWIPE_LEFT,
+    TOUCH_SWIPE_RIGHT,
+    TOUCH_DRAG            // Vertical drag, dy = movement since last event
+};
+
+struct TouchEvent {
+    TouchGesture gesture;
+    uint16_t x;           // Point where the gesture started
+    uint16_t y;
+    int16_t dx;
+    int16_t dy;
+    unsigned long timestamp;  // millis() when the gesture was recognised
+};
+
+// Interrupt-driven touch sampling and gesture recognition.
+//
+// The PENIRQ interrupt wakes a small sampling task, which only talks to the
+// touch controller while the panel is actually pressed. Each sample is the
+// median of several reads; gestures are queued with timestamps and drained
+// from loop() with poll(), so touches are not lost while loop() is busy.
+class TouchInput {
+public:
+    void begin(Display& display);
+
+    // Pop the next queued gesture. Returns false when the queue is empty.
+    bool poll(TouchEvent& ev);
+
+    uint32_t getDroppedEvents() const { return _dropped; }
+
+    // Called from the touch task on every pen-down. If it returns true the
+    // press is consumed (e.g. it woke the screen) and no gesture is queued.
+    void setWakeHandler(bool (*handler)(void*), void* ctx);
+
+    // Let a pen-down wake the chip from automatic light sleep. That needs
+    // a level-low interrupt on PENIRQ; the first pen-down turns it back
+    // into the falling edge so a held pen does not keep interrupting.
+    // Only with CONFIG_PM_ENABLE.
+    void setSleepWake(bool on);
+
+private:
+    Display* _display = nullptr;
+    QueueHandle_t _queue = nullptr;
+    TaskHandle_t _task = nullptr;
+    volatile uint32_t _dropped = 0;
+    bool (*_wakeHandler)(void*) = nullptr;
+    void* _wakeCtx = nullptr;
+    bool _suppress = false;
+    volatile bool _sleepWake = false;
+
+    static void IRAM_ATTR onPenIRQ(void* arg);
+    static void taskEntry(void* arg);
+    void run();
+
+    bool sample(uint16_t& x, uint16_t& y);
+    void push(TouchGesture gesture, uint16_t x, uint16_t y,
+              int16_t dx, int16_t dy);
+};
@@ -0,0 +1,235 @@
+#include "warm_start.h"
+#include <esp_rom_crc.h>
+
+#define WARM_KEY      "snapshot"
+#define WARM_MAGIC    0x5752534Du   // "MSRW"
+#define WARM_VERSION  1             // Bump on any layout change; old blobs are dropped
+#define WARM_STR_MAX  63            // Longer strings are cut
+
+struct WarmHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;     // Payload bytes after the header
+    uint32_t crc;        // CRC32 of the payload
+};
+
+// Little-endian fields in a fixed order
+class WarmWriter {
+public:
+    std::vector<uint8_t> buf;
+
+    void u8(uint8_t v) { buf.push_back(v); }
+    void u32(uint32_t v) {
+        for (int i = 0; i < 4; i++) buf.push_back(v >> (8 * i));
+    }
+    void i64(int64_t v) {
+        for (int i = 0; i < 8; i++) buf.push_back((uint64_t)v >> (8 * i));
+    }
+    void f32(double v) {
+        float f = v;
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        u32(bits);
+    }
+    void str(const String& s) {
+        size_t n = min(s.length(), (unsigned int)WARM_STR_MAX);
+        u8(n);
+        buf.insert(buf.end(), s.c_str(), s.c_str() + n);
+    }
+};
+
+class WarmReader {
+public:
+    WarmReader(const uint8_t* p, size_t len) : _p(p), _end(p + len) {}
+
+    bool ok() const { return _ok; }
+    bool done() const { return _p == _end; }
+
+    uint8_t u8() { return take(1) ? _p[-1] : 0; }
+    uint32_t u32() {
+        if (!take(4)) return 0;
+        return _p[-4] | (_p[-3] << 8) | (_p[-2] << 16) | ((uint32_t)_p[-1] << 24);
+    }
+    int64_t i64() {
+        uint64_t lo = u32();
+        uint64_t hi = u32();
+        return (int64_t)(lo | (hi << 32));
+    }
+    double f32() {
+        uint32_t bits = u32();
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+    String str() {
+        size_t n = u8();
+        String s;
+        if (take(n)) s.concat((const char*)_p - n, n);
+        return s;
+    }
+
+private:
+    const uint8_t* _p;
+    const uint8_t* _end;
+    bool _ok = true;
+
+    bool take(size_t n) {
+        if (!_ok || (size_t)(_end - _p) < n) {
+            _ok = false;
+            return false;
+        }
+        _p += n;
+        return true;
+    }
+};
+
+void WarmStart::begin() {
+    _prefs.begin("warm_start", false);
+}
+
+bool WarmStart::load(DashboardData& dashboard, std::vector<ActiveJobData>& jobs,
+                     std::vector<DriveData>& drives) {
+    std::vector<uint8_t> blob(WARM_START_BLOB_MAX);
+    size_t len = _prefs.getBytes(WARM_KEY, blob.data(), blob.size());
+
+    WarmHeader hdr;
+    if (len < sizeof(hdr)) return false;
+    memcpy(&hdr, blob.data(), sizeof(hdr));
+    const uint8_t* payload = blob.data() + sizeof(hdr);
+    if (hdr.magic != WARM_MAGIC || hdr.version != WARM_VERSION ||
+        hdr.length != len - sizeof(hdr) ||
+        esp_rom_crc32_le(0, payload, hdr.length) != hdr.crc) {
+        Serial.println("Warm start: no usable snapshot");
+        return false;
+    }
+
+    WarmReader in(payload, hdr.length);
+    DashboardData d = {};
+    d.totalTapes         = in.u32();
+    d.activeTapes        = in.u32();
+    d.fullTapes          = in.u32();
+    d.totalJobs          = in.u32();
+    d.activeJobs         = in.u32();
+    d.totalDrives        = in.u32();
+    d.totalCapacityBytes = in.i64();
+    d.usedCapacityBytes  = in.i64();
+    d.valid              = true;
+
+    std::vector<ActiveJobData> j(in.u8());
+    for (auto& job : j) {
+        job.id                = in.u32();
+        job.name              = in.str();
+        job.phase             = in.str();
+        job.status            = in.str();
+        job.fileCount         = in.i64();
+        job.totalFiles        = in.i64();
+        job.totalBytes        = in.i64();
+        job.bytesWritten      = in.i64();
+        job.writeSpeed        = in.f32();
+        job.tapeLabel         = in.str();
+        job.tapeCapacityBytes = in.i64();
+        job.tapeUsedBytes     = in.i64();
+        job.estimatedSecondsRemaining     = in.f32();
+        job.tapeEstimatedSecondsRemaining = in.f32();
+        job.scanFilesFound    = in.i64();
+        job.scanDirsScanned   = in.i64();
+        job.scanBytesFound    = in.i64();
+        job.valid             = true;
+    }
+
+    std::vector<DriveData> dr(in.u8());
+    for (auto& drive : dr) {
+        drive.id          = in.u32();
+        drive.displayName = in.str();
+        drive.vendor      = in.str();
+        drive.model       = in.str();
+        drive.status      = in.str();
+        drive.currentTape = in.str();
+        drive.formatType  = in.str();
+        drive.devicePath  = in.str();
+        drive.enabled     = in.u8() != 0;
+        drive.valid       = true;
+    }
+    if (!in.ok() || !in.done()) return false;
+
+    dashboard = d;
+    jobs.swap(j);
+    drives.swap(dr);
+    _storedCrc = hdr.crc;
+    Serial.printf("Warm start: %d job(s), %d drive(s) restored\n",
+                  (int)jobs.size(), (int)drives.size());
+    return true;
+}
+
+void WarmStart::save(const DashboardData& dashboard,
+                     const std::vector<ActiveJobData>& jobs,
+                     const std::vector<DriveData>& drives) {
+    if (!dashboard.valid) return;
+    if (_saved && millis() - _savedAt < WARM_START_SAVE_MS) return;
+
+    WarmWriter out;
+    out.buf.resize(sizeof(WarmHeader));
+    out.u32(dashboard.totalTapes);
+    out.u32(dashboard.activeTapes);
+    out.u32(dashboard.fullTapes);
+    out.u32(dashboard.totalJobs);
+    out.u32(dashboard.activeJobs);
+    out.u32(dashboard.totalDrives);
+    out.i64(dashboard.totalCapacityBytes);
+    out.i64(dashboard.usedCapacityBytes);
+
+    size_t jobCount = min(jobs.size(), (size_t)WARM_START_MAX_ROWS);
+    out.u8(jobCount);
+    for (size_t i = 0; i < jobCount; i++) {
+        const ActiveJobData& job = jobs[i];
+        out.u32(job.id);
+        out.str(job.name);
+        out.str(job.phase);
+        out.str(job.status);
+        out.i64(job.fileCount);
+        out.i64(job.totalFiles);
+        out.i64(job.totalBytes);
+        out.i64(job.bytesWritten);
+        out.f32(job.writeSpeed);
+        out.str(job.tapeLabel);
+        out.i64(job.tapeCapacityBytes);
+        out.i64(job.tapeUsedBytes);
+        out.f32(job.estimatedSecondsRemaining);
+        out.f32(job.tapeEstimatedSecondsRemaining);
+        out.i64(job.scanFilesFound);
+        out.i64(job.scanDirsScanned);
+        out.i64(job.scanBytesFound);
+    }
+
+    size_t driveCount = min(drives.size(), (size_t)WARM_START_MAX_ROWS);
+    out.u8(driveCount);
+    for (size_t i = 0; i < driveCount; i++) {
+        const DriveData& drive = drives[i];
+        out.u32(drive.id);
+        out.str(drive.displayName);
+        out.str(drive.vendor);
+        out.str(drive.model);
+        out.str(drive.status);
+        out.str(drive.currentTape);
+        out.str(drive.formatType);
+        out.str(drive.devicePath);
+        out.u8(drive.enabled);
+    }
+
+    WarmHeader hdr;
+    hdr.magic   = WARM_MAGIC;
+    hdr.version = WARM_VERSION;
+    hdr.length  = out.buf.size() - sizeof(hdr);
+    hdr.crc     = esp_rom_crc32_le(0, out.buf.data() + sizeof(hdr), hdr.length);
+    if (hdr.crc == _storedCrc) return;   // Nothing new since the last write
+    memcpy(out.buf.data(), &hdr, sizeof(hdr));
+
+    if (out.buf.size() > WARM_START_BLOB_MAX ||
+        _prefs.putBytes(WARM_KEY, out.buf.data(), out.buf.size()) != out.buf.size()) {
+        Serial.println("Warm start: save failed");
+        return;
+    }
+    _storedCrc = hdr.crc;
+    _savedAt = millis();
+    _saved = true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <vector>
+#include "api_client.h"
+
+#define WARM_START_SAVE_MS   300000  // At most one flash write per 5 min
+#define WARM_START_MAX_ROWS  4       // Jobs / drives kept
+#define WARM_START_BLOB_MAX  4000    // Fits one NVS page even with long names
+
+// Last good poll kept in NVS, so the tabs can be drawn right after a
+// power cycle instead of after the WiFi connect and first poll. Only what
+// the tabs show is kept; tape alerts and LTFS progress are never restored.
+class WarmStart {
+public:
+    void begin();
+
+    bool load(DashboardData& dashboard, std::vector<ActiveJobData>& jobs,
+              std::vector<DriveData>& drives);
+
+    // Call after each successful poll. Writes only if the data changed and
+    // the last write is at least WARM_START_SAVE_MS old.
+    void save(const DashboardData& dashboard,
+              const std::vector<ActiveJobData>& jobs,
+              const std::vector<DriveData>& drives);
+
+private:
+    Preferences _prefs;
+    uint32_t _storedCrc = 0;
+    unsigned long _savedAt = 0;
+    bool _saved = false;       // Written since boot
+};
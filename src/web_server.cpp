@@ -1,5 +1,7 @@
 #include "web_server.h"
 #include <WiFi.h>
+#include <SPIFFS.h>
+#include <memory>
 
 // ── Static HTML stored in flash (PROGMEM) ──────────────────────────────
 
@@ -54,88 +56,80 @@ button{padding:10px 20px;border:none;border-radius:4px;cursor:pointer;font-size:
 static const char PAGE_SAVED_ALERT[] PROGMEM =
     "<div class='alert'>Settings saved! Reboot to apply WiFi changes.</div>";
 
-static const char PAGE_STATUS_OPEN[] PROGMEM =
-    "<div class='card'><h2>Status</h2><div class='status'>"
-    "<div class='item'><div class='val'>";
-
 static const char PAGE_WIFI_CONNECTED[] PROGMEM =
     "<span class='dot green'></span>Connected";
 static const char PAGE_WIFI_DISCONNECTED[] PROGMEM =
     "<span class='dot red'></span>Disconnected";
 
-static const char PAGE_STATUS_MID1[] PROGMEM =
-    "</div><div class='lbl'>WiFi</div></div>"
-    "<div class='item'><div class='val'>";
-
-static const char PAGE_STATUS_MID2[] PROGMEM =
-    "</div><div class='lbl'>IP Address</div></div>"
-    "<div class='item'><div class='val'>";
-
 static const char PAGE_API_OK[] PROGMEM =
     "<span class='dot green'></span>OK";
 static const char PAGE_API_NA[] PROGMEM =
     "<span class='dot red'></span>N/A";
 
-static const char PAGE_STATUS_MID3[] PROGMEM =
-    "</div><div class='lbl'>API</div></div>"
-    "<div class='item'><div class='val'>";
-
-static const char PAGE_STATUS_CLOSE[] PROGMEM =
-    " KB</div><div class='lbl'>Free Heap</div></div>"
-    "</div></div>";
-
-static const char PAGE_WIFI_FORM[] PROGMEM =
+// Built-in page, used when the filesystem image with the web UI (web/,
+// see tools/build_web.py) has not been uploaded.
+// %KEY% placeholders are filled in by fillRoot().
+static const char PAGE_ROOT[] PROGMEM =
+    "%HEAD%"
+    "%SAVED%"
+    "<div class='card'><h2>Status</h2><div class='status'>"
+    "<div class='item'><div class='val'>%WIFI%</div><div class='lbl'>WiFi</div></div>"
+    "<div class='item'><div class='val'>%IP%</div><div class='lbl'>IP Address</div></div>"
+    "<div class='item'><div class='val'>%API%</div><div class='lbl'>API</div></div>"
+    "<div class='item'><div class='val'>%HEAP_KB% KB</div><div class='lbl'>Free Heap</div></div>"
+    "<div class='item'><div class='val'>%BLOCK_KB% KB</div><div class='lbl'>Largest Block</div></div>"
+    "<div class='item'><div class='val'>%CURRENT_MA% mA</div><div class='lbl'>Avg Current (est.)</div></div>"
+    "</div></div>"
     "<form method='POST' action='/save'>"
     "<div class='card'><h2>WiFi Settings</h2>"
     "<button type='button' class='scan-btn' onclick='scanWiFi()'>Scan Networks</button>"
     "<div id='networks'></div>"
     "<label>SSID</label>"
-    "<input type='text' name='wifi_ssid' id='wifi_ssid' value='";
-
-static const char PAGE_WIFI_PASS[] PROGMEM =
-    "'><label>Password</label>"
-    "<input type='password' name='wifi_pass' placeholder='Leave empty to keep current'>"
+    "<input type='text' name='wifi_ssid' maxlength='32' id='wifi_ssid' value='%SSID%'>"
+    "<label>Password</label>"
+    "<input type='password' name='wifi_pass' maxlength='64' placeholder='Leave empty to keep current'>"
+    "<div class='row'><div><label>Static IP</label>"
+    "<input type='text' name='ip_addr' maxlength='15' value='%IP_ADDR%' placeholder='DHCP'></div>"
+    "<div><label>Gateway</label>"
+    "<input type='text' name='ip_gw' maxlength='15' value='%IP_GW%'></div></div>"
+    "<div class='row'><div><label>Subnet Mask</label>"
+    "<input type='text' name='ip_mask' maxlength='15' value='%IP_MASK%' placeholder='255.255.255.0'></div>"
+    "<div><label>DNS</label>"
+    "<input type='text' name='ip_dns' maxlength='15' value='%IP_DNS%' placeholder='Gateway'></div></div>"
     "</div>"
     "<div class='card'><h2>TapeBackarr Server</h2>"
+    "<button type='button' class='scan-btn' onclick='findServers()'>Find Servers</button>"
+    "<div id='servers'></div>"
     "<label>Server Host / IP</label>"
-    "<input type='text' name='srv_host' value='";
-
-static const char PAGE_SRV_PORT[] PROGMEM =
-    "' placeholder='192.168.1.100'>"
+    "<input type='text' name='srv_host' maxlength='128' id='srv_host' value='%HOST%' placeholder='192.168.1.100'>"
     "<div class='row'><div>"
     "<label>Port</label>"
-    "<input type='number' name='srv_port' value='";
-
-static const char PAGE_POLL_INT[] PROGMEM =
-    "'></div><div>"
+    "<input type='number' name='srv_port' id='srv_port' value='%PORT%'>"
+    "</div><div>"
     "<label>Poll Interval (s)</label>"
-    "<input type='number' name='poll_int' value='";
-
-static const char PAGE_API_KEY[] PROGMEM =
-    "' min='1' max='300'>"
+    "<input type='number' name='poll_int' value='%POLL%' min='1' max='300'>"
     "</div></div>"
     "<label>API Key</label>"
-    "<input type='password' name='api_key' value='";
-
-static const char PAGE_HTTPS_PRE[] PROGMEM =
-    "' placeholder='Enter your API key'>"
-    "<div class='checkbox'><input type='checkbox' name='use_https' id='use_https'";
-
-static const char PAGE_HTTPS_POST[] PROGMEM =
-    "><label for='use_https'>Use HTTPS</label></div></div>"
+    "<input type='password' name='api_key' maxlength='128' value='%API_KEY%' placeholder='Enter your API key'>"
+    "<div class='checkbox'><input type='checkbox' name='use_https' id='use_https'%HTTPS%>"
+    "<label for='use_https'>Use HTTPS</label></div></div>"
     "<div class='card'><h2>Display Settings</h2>"
     "<div class='row'><div>"
     "<label>Brightness (0-100)</label>"
-    "<input type='number' name='brightness' value='";
-
-static const char PAGE_DEVNAME[] PROGMEM =
-    "' min='0' max='100'>"
+    "<input type='number' name='brightness' value='%BRIGHTNESS%' min='0' max='100'>"
     "</div><div>"
     "<label>Device Name</label>"
-    "<input type='text' name='dev_name' value='";
-
-static const char PAGE_TAIL[] PROGMEM =
-    "'></div></div></div>"
+    "<input type='text' name='dev_name' maxlength='32' value='%DEV_NAME%'>"
+    "</div></div>"
+    "<div class='row'><div>"
+    "<label>Dim After (min, 0 = never)</label>"
+    "<input type='number' name='dim_min' value='%DIM_MIN%' min='0' max='1440'>"
+    "</div><div>"
+    "<label>Screen Off After (min, 0 = never)</label>"
+    "<input type='number' name='off_min' value='%OFF_MIN%' min='0' max='1440'>"
+    "</div></div>"
+    "<div class='checkbox'><input type='checkbox' name='pwr_save' id='pwr_save'%PWR_SAVE%>"
+    "<label for='pwr_save'>WiFi power save while idle</label></div></div>"
     "<button type='submit' class='btn-primary'>Save Settings</button>"
     "</form>"
     "<div class='card'><h2>System</h2><div class='btn-group'>"
@@ -143,209 +137,1601 @@ static const char PAGE_TAIL[] PROGMEM =
     "<form method='POST' action='/reset' style='flex:1'><button type='submit' class='btn-danger' style='width:100%' onclick=\"return confirm('Reset all settings?')\">Factory Reset</button></form>"
     "</div></div>"
     "<script>"
-    "function scanWiFi(){"
-    "document.getElementById('networks').innerHTML='<p style=\"color:#888\">Scanning...</p>';"
-    "fetch('/scan').then(r=>r.json()).then(nets=>{"
-    "let h='';"
+    "function scanWiFi(t){"
+    "t=t||0;"
+    "let l=document.getElementById('networks');"
+    "if(!t)l.innerHTML='<p style=\"color:#888\">Scanning...</p>';"
+    "fetch('/scan').then(r=>r.json()).then(res=>{"
+    "let nets=res.networks;"
+    "l.textContent='';"
     "nets.forEach(n=>{"
-    "let bars=n.rssi>-50?'Strong':n.rssi>-70?'Good':'Weak';"
-    "h+='<div class=\"net-item\" onclick=\"document.getElementById(\\'wifi_ssid\\').value=\\''+n.ssid+'\\'\">'+"
-    "'<span>'+n.ssid+(n.secure?' &#x1F512;':'')+'</span>'+"
-    "'<span style=\"color:#888\">'+bars+' ('+n.rssi+')</span></div>';"
+    "let d=document.createElement('div'),a=document.createElement('span'),b=document.createElement('span');"
+    "d.className='net-item';"
+    "a.textContent=n.ssid+(n.secure?' \\u{1F512}':'');"
+    "b.style.color='#888';"
+    "b.textContent=(n.rssi>-50?'Strong':n.rssi>-70?'Good':'Weak')+' ('+n.rssi+')';"
+    "d.append(a,b);"
+    "d.onclick=()=>{document.getElementById('wifi_ssid').value=n.ssid};"
+    "l.append(d);"
     "});"
-    "if(!nets.length)h='<p style=\"color:#888\">No networks found</p>';"
-    "document.getElementById('networks').innerHTML=h;"
+    "if(res.scanning&&t<15){"
+    "l.insertAdjacentHTML('afterbegin','<p style=\"color:#888\">Scanning...</p>');"
+    "setTimeout(()=>scanWiFi(t+1),1000);"
+    "}else if(!nets.length)l.innerHTML='<p style=\"color:#888\">No networks found</p>';"
     "}).catch(()=>{"
-    "document.getElementById('networks').innerHTML='<p style=\"color:#f44\">Scan failed</p>';"
+    "l.innerHTML='<p style=\"color:#f44\">Scan failed</p>';"
+    "});"
+    "}"
+    "function findServers(t){"
+    "t=t||0;"
+    "let l=document.getElementById('servers');"
+    "if(!t)l.innerHTML='<p style=\"color:#888\">Searching...</p>';"
+    "fetch('/servers').then(r=>r.json()).then(res=>{"
+    "let srvs=res.servers;"
+    "l.textContent='';"
+    "srvs.forEach(s=>{"
+    "let d=document.createElement('div'),a=document.createElement('span'),b=document.createElement('span');"
+    "d.className='net-item';"
+    "a.textContent=s.name||s.host||s.ip;"
+    "b.style.color='#888';"
+    "b.textContent=(s.host||s.ip)+':'+s.port;"
+    "d.append(a,b);"
+    "d.onclick=()=>{document.getElementById('srv_host').value=s.host||s.ip;document.getElementById('srv_port').value=s.port};"
+    "l.append(d);"
+    "});"
+    "if(res.browsing&&t<15){"
+    "l.insertAdjacentHTML('afterbegin','<p style=\"color:#888\">Searching...</p>');"
+    "setTimeout(()=>findServers(t+1),1000);"
+    "}else if(!srvs.length)l.innerHTML='<p style=\"color:#888\">No servers found</p>';"
+    "}).catch(()=>{"
+    "l.innerHTML='<p style=\"color:#f44\">Search failed</p>';"
     "});"
     "}"
     "</script></body></html>";
 
+static const char STATUS_JSON[] PROGMEM =
+    "{\"wifi_state\":%WIFI_STATE%,"
+    "\"wifi_ip\":\"%IP%\","
+    "\"api_connected\":%API_CONNECTED%,"
+    "\"api_error\":\"%API_ERROR%\","
+    "\"heap\":%HEAP%,"
+    "\"heap_largest\":%HEAP_LARGEST%,"
+    "\"heap_min\":%HEAP_MIN%,"
+    "\"power_state\":\"%POWER_STATE%\","
+    "\"backlight_duty\":%BACKLIGHT_DUTY%,"
+    "\"idle_fraction\":%IDLE_FRACTION%,"
+    "\"avg_current_ma\":%AVG_CURRENT_MA%,"
+    "\"capture\":{%CAPTURE%},"
+    "\"boot\":[%BOOT%],"
+    "\"uptime\":%UPTIME%}";
+
+static const char CONFIG_JSON[] PROGMEM =
+    "{\"wifi_ssid\":\"%SSID%\","
+    "\"ip_addr\":\"%IP_ADDR%\","
+    "\"ip_gw\":\"%IP_GW%\","
+    "\"ip_mask\":\"%IP_MASK%\","
+    "\"ip_dns\":\"%IP_DNS%\","
+    "\"srv_host\":\"%HOST%\","
+    "\"srv_port\":%PORT%,"
+    "\"poll_int\":%POLL%,"
+    "\"api_key\":\"%API_KEY%\","
+    "\"use_https\":%HTTPS%,"
+    "\"brightness\":%BRIGHTNESS%,"
+    "\"dev_name\":\"%DEV_NAME%\","
+    "\"dim_min\":%DIM_MIN%,"
+    "\"off_min\":%OFF_MIN%,"
+    "\"pwr_save\":%PWR_SAVE%}";
+
+static const char SCAN_JSON[] PROGMEM =
+    "{\"scanning\":%SCANNING%,\"age\":%AGE%,\"networks\":[%NETWORKS%]}";
+
+static const char SERVERS_JSON[] PROGMEM =
+    "{\"browsing\":%BROWSING%,\"age\":%AGE%,\"servers\":[%SERVERS%]}";
+
+// Heap telemetry. "alloc" in a history row is bytes requested since the
+// previous row, in "subsystems" order.
+static const char HEAP_JSON[] PROGMEM =
+    "{\"free\":%FREE%,"
+    "\"largest\":%LARGEST%,"
+    "\"min_free\":%MIN_FREE%,"
+    "\"interval_s\":%INTERVAL%,"
+    "\"subsystems\":[%SUBSYSTEMS%],"
+    "\"stacks\":[%STACKS%],"
+    "\"history\":[%HISTORY%]}";
+
+static const char LATENCY_JSON[] PROGMEM = "{\"tasks\":[%TASKS%]}";
+
+// Same layout as Snapshot::message() with every section
+static const char SNAPSHOT_JSON[] PROGMEM =
+    "{\"seq\":%SEQ%,"
+    "\"age\":%AGE%,"
+    "\"full\":true,"
+    "\"dashboard\":%DASHBOARD%,"
+    "\"jobs\":%JOBS%,"
+    "\"drives\":%DRIVES%,"
+    "\"tape_changes\":%TAPE_CHANGES%,"
+    "\"ltfs\":%LTFS%}";
+
+// Prometheus text exposition format. Per-endpoint, per-tab and per-job
+// placeholders are filled one line at a time.
+static const char METRICS_TEXT[] PROGMEM = R"rawliteral(# HELP cyd_uptime_seconds Time since boot
+# TYPE cyd_uptime_seconds gauge
+cyd_uptime_seconds %UPTIME%
+# HELP cyd_heap_free_bytes Free heap
+# TYPE cyd_heap_free_bytes gauge
+cyd_heap_free_bytes %HEAP_FREE%
+# HELP cyd_heap_largest_block_bytes Largest block that can be allocated
+# TYPE cyd_heap_largest_block_bytes gauge
+cyd_heap_largest_block_bytes %HEAP_LARGEST%
+# HELP cyd_heap_min_free_bytes Lowest free heap since boot
+# TYPE cyd_heap_min_free_bytes gauge
+cyd_heap_min_free_bytes %HEAP_MIN%
+# HELP cyd_heap_allocations_total malloc calls per subsystem
+# TYPE cyd_heap_allocations_total counter
+%HEAP_ALLOCS%# HELP cyd_heap_allocated_bytes_total Bytes requested per subsystem
+# TYPE cyd_heap_allocated_bytes_total counter
+%HEAP_BYTES%# HELP cyd_heap_allocation_failures_total Allocations that returned NULL
+# TYPE cyd_heap_allocation_failures_total counter
+%HEAP_FAILURES%# HELP cyd_task_stack_free_bytes Least free stack a task has had
+# TYPE cyd_task_stack_free_bytes gauge
+%STACK_FREE%# HELP cyd_wifi_connected 1 while connected to the configured network
+# TYPE cyd_wifi_connected gauge
+cyd_wifi_connected %WIFI_CONNECTED%
+# HELP cyd_wifi_rssi_dbm Signal strength of the access point
+# TYPE cyd_wifi_rssi_dbm gauge
+cyd_wifi_rssi_dbm %RSSI%
+# HELP cyd_wifi_disconnects_total Times the WiFi link was lost
+# TYPE cyd_wifi_disconnects_total counter
+cyd_wifi_disconnects_total %WIFI_DISCONNECTS%
+# HELP cyd_wifi_reconnects_total Times the WiFi link came back after a loss
+# TYPE cyd_wifi_reconnects_total counter
+cyd_wifi_reconnects_total %WIFI_RECONNECTS%
+# HELP cyd_wifi_downtime_seconds_total Time without WiFi since the first connection
+# TYPE cyd_wifi_downtime_seconds_total counter
+cyd_wifi_downtime_seconds_total %WIFI_DOWNTIME%
+# HELP cyd_api_up 1 if the last TapeBackarr request succeeded
+# TYPE cyd_api_up gauge
+cyd_api_up %API_UP%
+# HELP cyd_backlight_duty_ratio Average backlight level since boot
+# TYPE cyd_backlight_duty_ratio gauge
+cyd_backlight_duty_ratio %BACKLIGHT_DUTY%
+# HELP cyd_estimated_current_milliamps Modelled average supply current
+# TYPE cyd_estimated_current_milliamps gauge
+cyd_estimated_current_milliamps %AVG_CURRENT_MA%
+# HELP cyd_poll_requests_total Requests made to TapeBackarr
+# TYPE cyd_poll_requests_total counter
+%POLL_REQUESTS%# HELP cyd_poll_errors_total Failed requests (transport, HTTP status or JSON)
+# TYPE cyd_poll_errors_total counter
+%POLL_ERRORS%# HELP cyd_poll_retries_total Requests retried after a transport error
+# TYPE cyd_poll_retries_total counter
+%POLL_RETRIES%# HELP cyd_poll_rtt_p99_seconds 99th percentile of recent request times
+# TYPE cyd_poll_rtt_p99_seconds gauge
+cyd_poll_rtt_p99_seconds %RTT_P99%
+# HELP cyd_poll_timeout_seconds Current request timeout, derived from RTT and RSSI
+# TYPE cyd_poll_timeout_seconds gauge
+cyd_poll_timeout_seconds %POLL_TIMEOUT%
+# HELP cyd_poll_duration_seconds TapeBackarr request latency
+# TYPE cyd_poll_duration_seconds summary
+%POLL_DURATION%# HELP cyd_poll_last_duration_seconds Latency of the most recent request
+# TYPE cyd_poll_last_duration_seconds gauge
+%POLL_LAST%# HELP cyd_render_duration_seconds Time to draw a tab off-screen
+# TYPE cyd_render_duration_seconds summary
+%RENDER_DURATION%# HELP cyd_blit_duration_seconds Time to push a cached tab to the panel
+# TYPE cyd_blit_duration_seconds summary
+%BLIT_DURATION%# HELP cyd_task_iteration_seconds Time per loop() pass / poll round
+# TYPE cyd_task_iteration_seconds histogram
+%TASK_ITERATION%# HELP cyd_task_stalls_total Iterations over the task's stall threshold
+# TYPE cyd_task_stalls_total counter
+%TASK_STALLS%# HELP cyd_task_max_iteration_seconds Longest iteration, labelled with its slowest phase
+# TYPE cyd_task_max_iteration_seconds gauge
+%TASK_MAX%%TAPEBACKARR%)rawliteral";
+
+// Mirrored from the last poll; left out until one has succeeded
+static const char METRICS_TAPEBACKARR[] PROGMEM = R"rawliteral(# HELP tapebackarr_snapshot_age_seconds Time since these values were polled
+# TYPE tapebackarr_snapshot_age_seconds gauge
+tapebackarr_snapshot_age_seconds %SNAP_AGE%
+%DASHBOARD%# HELP tapebackarr_tape_changes_pending Outstanding tape change requests
+# TYPE tapebackarr_tape_changes_pending gauge
+tapebackarr_tape_changes_pending %TAPE_CHANGES%
+# HELP tapebackarr_job_bytes_written Bytes written by a running job
+# TYPE tapebackarr_job_bytes_written gauge
+%JOB_BYTES%# HELP tapebackarr_job_total_bytes Bytes a running job will write
+# TYPE tapebackarr_job_total_bytes gauge
+%JOB_TOTAL%# HELP tapebackarr_job_write_speed_bytes_per_second Current write speed of a running job
+# TYPE tapebackarr_job_write_speed_bytes_per_second gauge
+%JOB_SPEED%# HELP tapebackarr_drive_status Drive status, 1 for the current one
+# TYPE tapebackarr_drive_status gauge
+%DRIVE_STATUS%# HELP tapebackarr_drive_enabled 1 if the drive is enabled
+# TYPE tapebackarr_drive_enabled gauge
+%DRIVE_ENABLED%)rawliteral";
+
+static const char METRICS_DASHBOARD[] PROGMEM = R"rawliteral(# HELP tapebackarr_tapes Tapes known to TapeBackarr
+# TYPE tapebackarr_tapes gauge
+tapebackarr_tapes %TAPES%
+# HELP tapebackarr_tapes_active Tapes in active use
+# TYPE tapebackarr_tapes_active gauge
+tapebackarr_tapes_active %ACTIVE_TAPES%
+# HELP tapebackarr_jobs Configured backup jobs
+# TYPE tapebackarr_jobs gauge
+tapebackarr_jobs %JOBS%
+# HELP tapebackarr_jobs_running Jobs currently running
+# TYPE tapebackarr_jobs_running gauge
+tapebackarr_jobs_running %RUNNING_JOBS%
+# HELP tapebackarr_capacity_bytes Total capacity of all pools
+# TYPE tapebackarr_capacity_bytes gauge
+tapebackarr_capacity_bytes %CAPACITY%
+# HELP tapebackarr_used_bytes Bytes used across all pools
+# TYPE tapebackarr_used_bytes gauge
+tapebackarr_used_bytes %USED%
+)rawliteral";
+
+static const char PAGE_REBOOT[] PROGMEM =
+    "<html><body><h2>Rebooting...</h2>"
+    "<p>Device will restart in a few seconds.</p>"
+    "<script>setTimeout(()=>window.location='/',10000)</script>"
+    "</body></html>";
+
+static const char PAGE_RESET[] PROGMEM =
+    "<html><body><h2>Settings Reset</h2>"
+    "<p>All settings cleared. Device will restart.</p>"
+    "<script>setTimeout(()=>window.location='/',10000)</script>"
+    "</body></html>";
+
+#define REBOOT_DELAY_MS 500   // Let the response reach the browser first
+
+#define WEB_ROOT          "/www"
+#define CACHE_REVALIDATE  "no-cache"                             // HTML pages
+#define CACHE_IMMUTABLE   "public, max-age=31536000, immutable"  // Hashed assets
+
+#define METRICS_CONTENT_TYPE  "text/plain; version=0.0.4"
+#define METRICS_LABEL_MAX     64    // Keeps each metric line within a chunk
+
+// ── Chunked response writer ────────────────────────────────────────────
+
+ChunkWriter::ChunkWriter(PGM_P tpl, FillFn fill) : _fill(fill) {
+    _stack[0] = tpl;
+    _literal[0] = false;
+    _depth = 1;
+}
+
+size_t ChunkWriter::read(uint8_t* buf, size_t maxLen) {
+    _out = buf;
+    _outLen = 0;
+    _outMax = maxLen;
+
+    // Overflow from the previous chunk goes out first
+    size_t n = min(_pendingLen, maxLen);
+    memcpy(buf, _pending, n);
+    memmove(_pending, _pending + n, _pendingLen - n);
+    _pendingLen -= n;
+    _outLen = n;
+
+    char key[TEMPLATE_KEY_MAX + 1];
+    while (_outLen < _outMax && _pendingLen == 0) {
+        if (_repeatKey[0]) {
+            if (!_fill(*this, _repeatKey)) _repeatKey[0] = '\0';
+            continue;
+        }
+        if (_depth == 0) break;
+
+        char c = pgm_read_byte(_stack[_depth - 1]);
+        if (c == '\0') {
+            _depth--;
+            continue;
+        }
+        if (c == '%' && !_literal[_depth - 1] && nextKey(key)) {
+            if (_fill(*this, key)) strcpy(_repeatKey, key);
+            continue;
+        }
+        _stack[_depth - 1]++;
+        write(c);
+    }
+
+    _out = nullptr;
+    if (_overflow) {
+        // Dropping this chunk leaves the client an incomplete document
+        Serial.println("Web: response value too long, aborted");
+        _pendingLen = 0;
+        _depth = 0;
+        _repeatKey[0] = '\0';
+        return 0;
+    }
+    return _outLen;
+}
+
+// At a '%': if it opens a %[A-Z0-9_]+% placeholder, consume it into key.
+// Anything else (e.g. "width:100%") is left to be copied through.
+bool ChunkWriter::nextKey(char* key) {
+    PGM_P p = _stack[_depth - 1] + 1;
+    size_t n = 0;
+    char k;
+    while (n < TEMPLATE_KEY_MAX && (k = pgm_read_byte(p + n)) != 0 &&
+           (isupper(k) || isdigit(k) || k == '_')) {
+        key[n++] = k;
+    }
+    if (n == 0 || pgm_read_byte(p + n) != '%') return false;
+
+    key[n] = '\0';
+    _stack[_depth - 1] = p + n + 1;
+    return true;
+}
+
+void ChunkWriter::write(char c) {
+    if (_outLen < _outMax) {
+        _out[_outLen++] = c;
+    } else if (_pendingLen < sizeof(_pending)) {
+        _pending[_pendingLen++] = c;
+    } else {
+        _overflow = true;
+    }
+}
+
+void ChunkWriter::write(const char* str) {
+    while (*str) write(*str++);
+}
+
+void ChunkWriter::write(long value) {
+    char tmp[12];
+    snprintf(tmp, sizeof(tmp), "%ld", value);
+    write(tmp);
+}
+
+void ChunkWriter::write(long long value) {
+    char tmp[24];
+    snprintf(tmp, sizeof(tmp), "%lld", value);
+    write(tmp);
+}
+
+void ChunkWriter::write(float value, int decimals) {
+    char tmp[24];
+    snprintf(tmp, sizeof(tmp), "%.*f", decimals, value);
+    write(tmp);
+}
+
+void ChunkWriter::writeEscaped(const char* str) {
+    for (; *str; str++) {
+        switch (*str) {
+            case '&':  write("&amp;");  break;
+            case '<':  write("&lt;");   break;
+            case '>':  write("&gt;");   break;
+            case '"':  write("&quot;"); break;
+            case '\'': write("&#39;");  break;
+            default:   write(*str);     break;
+        }
+    }
+}
+
+void ChunkWriter::writeJson(const char* str) {
+    for (; *str; str++) {
+        unsigned char c = *str;
+        if (c == '"' || c == '\\') {
+            write('\\');
+            write((char)c);
+        } else if (c < 0x20) {
+            char tmp[8];
+            snprintf(tmp, sizeof(tmp), "\\u%04x", c);
+            write(tmp);
+        } else {
+            write((char)c);
+        }
+    }
+}
+
+void ChunkWriter::writeLabel(const char* str, size_t maxLen) {
+    for (size_t n = 0; *str && n < maxLen; str++, n++) {
+        switch (*str) {
+            case '\\': write("\\\\"); break;
+            case '"':  write("\\\""); break;
+            case '\n': write("\\n");  break;
+            default:   write(*str);   break;
+        }
+    }
+}
+
+void ChunkWriter::include(PGM_P tpl) {
+    if (_depth == TEMPLATE_DEPTH) return;
+    _literal[_depth] = false;
+    _stack[_depth++] = tpl;
+}
+
+void ChunkWriter::includeText(const char* text) {
+    if (_depth == TEMPLATE_DEPTH) return;
+    _literal[_depth] = true;
+    _stack[_depth++] = text;
+}
+
 // ── Implementation ─────────────────────────────────────────────────────
 
 void ConfigWebServer::begin(SettingsManager& settings, WiFiManager& wifi,
-                             APIClient& api) {
+                             APIClient& api, PowerManager& power,
+                             Display& display, ServerDiscovery& discovery,
+                             BootProfile& boot, ApiCapture& capture) {
     _settings = &settings;
     _wifi = &wifi;
     _api = &api;
+    _power = &power;
+    _display = &display;
+    _discovery = &discovery;
+    _boot = &boot;
+    _capture = &capture;
+    _lock = xSemaphoreCreateMutex();
+    publishStatus();
+    loadAssets();
+
+    _server.on("/", HTTP_GET, [this](AsyncWebServerRequest* r) { handleRoot(r); });
+    _server.on("/save", HTTP_POST, [this](AsyncWebServerRequest* r) { handleSave(r); });
+    _server.on("/config", HTTP_GET, [this](AsyncWebServerRequest* r) { handleConfig(r); });
+    _server.on("/status", HTTP_GET, [this](AsyncWebServerRequest* r) { handleStatus(r); });
+    _server.on("/reboot", HTTP_POST, [this](AsyncWebServerRequest* r) { handleReboot(r); });
+    _server.on("/reset", HTTP_POST, [this](AsyncWebServerRequest* r) { handleReset(r); });
+    _server.on("/scan", HTTP_GET, [this](AsyncWebServerRequest* r) { handleScan(r); });
+    _server.on("/servers", HTTP_GET, [this](AsyncWebServerRequest* r) { handleServers(r); });
+    _server.on("/snapshot", HTTP_GET, [this](AsyncWebServerRequest* r) { handleSnapshot(r); });
+    _server.on("/metrics", HTTP_GET, [this](AsyncWebServerRequest* r) { handleMetrics(r); });
+    _server.on("/latency", HTTP_GET, [this](AsyncWebServerRequest* r) { handleLatency(r); });
+    _server.on("/heap", HTTP_GET, [this](AsyncWebServerRequest* r) { handleHeap(r); });
 
-    _server.on("/", HTTP_GET, [this]() { handleRoot(); });
-    _server.on("/save", HTTP_POST, [this]() { handleSave(); });
-    _server.on("/status", HTTP_GET, [this]() { handleStatus(); });
-    _server.on("/reboot", HTTP_POST, [this]() { handleReboot(); });
-    _server.on("/reset", HTTP_POST, [this]() { handleReset(); });
-    _server.on("/scan", HTTP_GET, [this]() { handleScan(); });
-
-    // Redirect all unknown URLs to root (captive-portal support)
-    _server.onNotFound([this]() {
-        _server.sendHeader("Location", "/", true);
-        _server.send(302, "text/plain", "");
+    // API record and replay
+    _server.on("/capture", HTTP_GET, [this](AsyncWebServerRequest* r) { handleCapture(r); });
+    _server.on("/capture/start", HTTP_POST, [this](AsyncWebServerRequest* r) {
+        handleCaptureAction(r, CAPTURE_START);
+    });
+    _server.on("/capture/stop", HTTP_POST, [this](AsyncWebServerRequest* r) {
+        handleCaptureAction(r, CAPTURE_STOP);
+    });
+    _server.on("/replay/start", HTTP_POST, [this](AsyncWebServerRequest* r) {
+        handleCaptureAction(r, REPLAY_ARM);
+    });
+    _server.on("/replay/stop", HTTP_POST, [this](AsyncWebServerRequest* r) {
+        handleCaptureAction(r, REPLAY_DISARM);
     });
 
-    // Start DNS server — resolve ALL hostnames to our AP IP (captive portal)
-    _dns.start(53, "*", WiFi.softAPIP());
+    // Live view: full snapshot on connect, then changed sections only
+    _ws.onEvent([this](AsyncWebSocket*, AsyncWebSocketClient* client,
+                       AwsEventType type, void*, uint8_t*, size_t) {
+        if (type != WS_EVT_CONNECT) return;
+        std::shared_ptr<const Snapshot> snap = currentSnapshot();
+        if (snap) client->text(snap->message(SNAP_ALL_SECTIONS));
+    });
+    _server.addHandler(&_ws);
+
+    // Web UI assets; anything else redirects to root (captive-portal support)
+    _server.onNotFound([this](AsyncWebServerRequest* r) {
+        const WebAsset* asset = findAsset(r->url());
+        if (asset) {
+            sendAsset(r, *asset);
+        } else {
+            r->redirect("/");
+        }
+    });
 
     _server.begin();
     Serial.println("Web server started on port 80");
 }
 
-void ConfigWebServer::handleClient() {
-    _dns.processNextRequest();
-    _server.handleClient();
+void ConfigWebServer::update() {
+    // Captive portal while the setup AP is up: resolve ALL hostnames to us
+    bool apMode = _wifi->getState() == WIFI_STATE_AP_MODE;
+    if (apMode != _dnsRunning) {
+        if (apMode) _dns.start(53, "*", WiFi.softAPIP());
+        else _dns.stop();
+        _dnsRunning = apMode;
+    }
+    if (_dnsRunning) _dns.processNextRequest();
+
+    // Apply a save queued by /save
+    bool save = false;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (_savePending) {
+        _settings->get() = _pending;
+        _savePending = false;
+        save = true;
+    }
+    if (_resetPending) {
+        _settings->reset();
+        _resetPending = false;
+    }
+    // Capture action queued by /capture/* or /replay/*
+    CaptureAction action = _captureAction;
+    _captureAction = CAPTURE_NONE;
+    xSemaphoreGive(_lock);
+
+    if (save) {
+        _settings->save();
+        _power->applySettings();
+        Serial.println("Settings saved");
+    }
+
+    // Carry out the queued capture action outside the lock
+    switch (action) {
+        case CAPTURE_START: _capture->start(); break;
+        case CAPTURE_STOP:  _capture->stop(); break;
+        case REPLAY_ARM:
+            if (!_capture->armReplay()) Serial.println("Replay: no capture to arm");
+            break;
+        case REPLAY_DISARM: _capture->disarmReplay(); break;
+        case CAPTURE_NONE:  break;
+    }
+
+    if (millis() - _lastStatus >= STATUS_REFRESH_MS) {
+        publishStatus();
+        _ws.cleanupClients();
+    }
+
+    if (_rebootAt && (long)(millis() - _rebootAt) >= 0) {
+        ESP.restart();
+    }
 }
 
-void ConfigWebServer::handleRoot() {
-    auto& s = _settings->get();
+void ConfigWebServer::publishStatus() {
+    _lastStatus = millis();
 
-    // Build the full page in a String to avoid chunked transfer issues
-    String html;
-    html.reserve(4096);
+    WebStatus st;
+    st.wifiState = _wifi->getState();
+    strlcpy(st.ip, _wifi->getIP().c_str(), sizeof(st.ip));
+    st.rssi = _wifi->isConnected() ? WiFi.RSSI() : 0;
+    st.wifiDisconnects = _wifi->getDisconnects();
+    st.wifiReconnects = _wifi->getReconnects();
+    st.wifiDowntimeMs = _wifi->getDowntimeMs();
+    st.apiConnected = _api->isConnected();
+    strlcpy(st.apiError, _api->getLastError().c_str(), sizeof(st.apiError));
+    st.powerState = _power->getStateName();
+    st.backlightDuty = _power->getBacklightDuty();
+    st.idleFraction = _power->getIdleFraction();
+    st.avgCurrentMa = _power->getAverageCurrentMa();
+    for (int i = 0; i < API_ENDPOINT_COUNT; i++) st.api[i] = _api->getStats(i);
+    st.apiTimeoutMs = _api->getTimeoutMs();
+    st.apiRttP99Ms = _api->getRttP99Ms();
+    for (int i = 0; i < SCREEN_CACHE_SLOTS; i++) st.render[i] = _display->getRenderTiming(i);
+    st.capture = _capture->getStatus();
+    st.bootPhases = _boot->count();
+    for (size_t i = 0; i < st.bootPhases; i++) st.boot[i] = _boot->get(i);
 
-    // Head + CSS
-    html += FPSTR(PAGE_HEAD);
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _status = st;
+    xSemaphoreGive(_lock);
+}
 
-    // Saved alert
-    if (_server.hasArg("saved")) {
-        html += FPSTR(PAGE_SAVED_ALERT);
+// Settings as they will be once a queued save is applied. Caller holds _lock.
+const AppSettings& ConfigWebServer::shownSettings() const {
+    return _savePending ? _pending : _settings->get();
+}
+
+void ConfigWebServer::sendTemplate(AsyncWebServerRequest* request,
+                                   const char* contentType, PGM_P tpl,
+                                   ChunkWriter::FillFn fill) {
+    // Owned by the filler, freed with the response
+    auto writer = std::make_shared<ChunkWriter>(tpl, fill);
+    request->send(request->beginChunkedResponse(contentType,
+        [writer](uint8_t* buf, size_t maxLen, size_t) -> size_t {
+            return writer->read(buf, maxLen);
+        }));
+}
+
+void ConfigWebServer::handleRoot(AsyncWebServerRequest* request) {
+    const WebAsset* index = findAsset("/index.html");
+    if (index) {
+        sendAsset(request, *index);
+        return;
     }
 
-    // Status card
-    html += FPSTR(PAGE_STATUS_OPEN);
-    html += (_wifi->getState() == WIFI_STATE_CONNECTED)
-            ? FPSTR(PAGE_WIFI_CONNECTED) : FPSTR(PAGE_WIFI_DISCONNECTED);
-    html += FPSTR(PAGE_STATUS_MID1);
-    html += _wifi->getIP();
-    html += FPSTR(PAGE_STATUS_MID2);
-    html += _api->isConnected() ? FPSTR(PAGE_API_OK) : FPSTR(PAGE_API_NA);
-    html += FPSTR(PAGE_STATUS_MID3);
-    html += String(ESP.getFreeHeap() / 1024);
-    html += FPSTR(PAGE_STATUS_CLOSE);
+    bool saved = request->hasArg("saved");
+    sendTemplate(request, "text/html", PAGE_ROOT,
+        [this, saved](ChunkWriter& out, const char* key) {
+            return fillRoot(out, key, saved);
+        });
+}
 
-    // WiFi form — SSID value
-    html += FPSTR(PAGE_WIFI_FORM);
-    html += htmlEscape(s.wifiSSID);
+bool ConfigWebServer::fillRoot(ChunkWriter& out, const char* key, bool saved) {
+    if (!strcmp(key, "HEAD")) {
+        out.include(PAGE_HEAD);
+        return false;
+    }
+    if (!strcmp(key, "SAVED")) {
+        if (saved) out.include(PAGE_SAVED_ALERT);
+        return false;
+    }
 
-    // Server host value
-    html += FPSTR(PAGE_WIFI_PASS);
-    html += htmlEscape(s.serverHost);
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    const AppSettings& s = shownSettings();
 
-    // Port value
-    html += FPSTR(PAGE_SRV_PORT);
-    html += String(s.serverPort);
+    if (!strcmp(key, "WIFI")) {
+        out.include(_status.wifiState == WIFI_STATE_CONNECTED
+                    ? PAGE_WIFI_CONNECTED : PAGE_WIFI_DISCONNECTED);
+    } else if (!strcmp(key, "IP")) {
+        out.write(_status.ip);
+    } else if (!strcmp(key, "API")) {
+        out.include(_status.apiConnected ? PAGE_API_OK : PAGE_API_NA);
+    } else if (!strcmp(key, "HEAP_KB")) {
+        out.write((long)(ESP.getFreeHeap() / 1024));
+    } else if (!strcmp(key, "BLOCK_KB")) {
+        out.write((long)(ESP.getMaxAllocHeap() / 1024));
+    } else if (!strcmp(key, "CURRENT_MA")) {
+        out.write((long)_status.avgCurrentMa);
+    } else if (!strcmp(key, "SSID")) {
+        out.writeEscaped(s.wifiSSID);
+    } else if (!strcmp(key, "IP_ADDR")) {
+        out.writeEscaped(s.staticIP);
+    } else if (!strcmp(key, "IP_GW")) {
+        out.writeEscaped(s.gateway);
+    } else if (!strcmp(key, "IP_MASK")) {
+        out.writeEscaped(s.subnet);
+    } else if (!strcmp(key, "IP_DNS")) {
+        out.writeEscaped(s.dns);
+    } else if (!strcmp(key, "HOST")) {
+        out.writeEscaped(s.serverHost);
+    } else if (!strcmp(key, "PORT")) {
+        out.write((long)s.serverPort);
+    } else if (!strcmp(key, "POLL")) {
+        out.write((long)s.pollInterval);
+    } else if (!strcmp(key, "API_KEY")) {
+        out.writeEscaped(s.apiKey);
+    } else if (!strcmp(key, "HTTPS")) {
+        if (s.useHTTPS) out.write(" checked");
+    } else if (!strcmp(key, "BRIGHTNESS")) {
+        out.write((long)s.brightness);
+    } else if (!strcmp(key, "DEV_NAME")) {
+        out.writeEscaped(s.deviceName);
+    } else if (!strcmp(key, "DIM_MIN")) {
+        out.write((long)s.idleDimMin);
+    } else if (!strcmp(key, "OFF_MIN")) {
+        out.write((long)s.idleOffMin);
+    } else if (!strcmp(key, "PWR_SAVE")) {
+        if (s.powerSave) out.write(" checked");
+    }
+
+    xSemaphoreGive(_lock);
+    return false;
+}
 
-    // Poll interval value
-    html += FPSTR(PAGE_POLL_INT);
-    html += String(s.pollInterval);
+void ConfigWebServer::handleConfig(AsyncWebServerRequest* request) {
+    sendTemplate(request, "application/json", CONFIG_JSON,
+        [this](ChunkWriter& out, const char* key) {
+            return fillConfig(out, key);
+        });
+}
+
+bool ConfigWebServer::fillConfig(ChunkWriter& out, const char* key) {
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    const AppSettings& s = shownSettings();
+
+    if (!strcmp(key, "SSID")) {
+        out.writeJson(s.wifiSSID.c_str());
+    } else if (!strcmp(key, "IP_ADDR")) {
+        out.writeJson(s.staticIP.c_str());
+    } else if (!strcmp(key, "IP_GW")) {
+        out.writeJson(s.gateway.c_str());
+    } else if (!strcmp(key, "IP_MASK")) {
+        out.writeJson(s.subnet.c_str());
+    } else if (!strcmp(key, "IP_DNS")) {
+        out.writeJson(s.dns.c_str());
+    } else if (!strcmp(key, "HOST")) {
+        out.writeJson(s.serverHost.c_str());
+    } else if (!strcmp(key, "PORT")) {
+        out.write((long)s.serverPort);
+    } else if (!strcmp(key, "POLL")) {
+        out.write((long)s.pollInterval);
+    } else if (!strcmp(key, "API_KEY")) {
+        out.writeJson(s.apiKey.c_str());
+    } else if (!strcmp(key, "HTTPS")) {
+        out.write(s.useHTTPS ? "true" : "false");
+    } else if (!strcmp(key, "BRIGHTNESS")) {
+        out.write((long)s.brightness);
+    } else if (!strcmp(key, "DEV_NAME")) {
+        out.writeJson(s.deviceName.c_str());
+    } else if (!strcmp(key, "DIM_MIN")) {
+        out.write((long)s.idleDimMin);
+    } else if (!strcmp(key, "OFF_MIN")) {
+        out.write((long)s.idleOffMin);
+    } else if (!strcmp(key, "PWR_SAVE")) {
+        out.write(s.powerSave ? "true" : "false");
+    }
 
-    // API key value
-    html += FPSTR(PAGE_API_KEY);
-    html += htmlEscape(s.apiKey);
+    xSemaphoreGive(_lock);
+    return false;
+}
 
-    // HTTPS checkbox
-    html += FPSTR(PAGE_HTTPS_PRE);
-    if (s.useHTTPS) html += " checked";
+struct FieldLimit {
+    const char* name;
+    size_t maxLen;
+};
 
-    // Brightness value
-    html += FPSTR(PAGE_HTTPS_POST);
-    html += String(s.brightness);
+static const FieldLimit SAVE_LIMITS[] = {
+    { "wifi_ssid", SSID_MAX_LEN },
+    { "wifi_pass", WIFI_PASS_MAX_LEN },
+    { "ip_addr",   IP_TEXT_MAX_LEN },
+    { "ip_gw",     IP_TEXT_MAX_LEN },
+    { "ip_mask",   IP_TEXT_MAX_LEN },
+    { "ip_dns",    IP_TEXT_MAX_LEN },
+    { "srv_host",  SERVER_HOST_MAX_LEN },
+    { "api_key",   API_KEY_MAX_LEN },
+    { "dev_name",  DEVICE_NAME_MAX_LEN },
+};
 
-    // Device name value
-    html += FPSTR(PAGE_DEVNAME);
-    html += htmlEscape(s.deviceName);
+void ConfigWebServer::handleSave(AsyncWebServerRequest* request) {
+    // Nothing is taken if any field is too long to be shown back intact
+    for (const FieldLimit& f : SAVE_LIMITS) {
+        if (request->hasArg(f.name) && request->arg(f.name).length() > f.maxLen) {
+            request->send(400, "text/plain",
+                          String(f.name) + " is longer than " + String((unsigned)f.maxLen));
+            return;
+        }
+    }
 
-    // Tail
-    html += FPSTR(PAGE_TAIL);
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (!_savePending) _pending = _settings->get();
+    AppSettings& s = _pending;
 
-    _server.send(200, "text/html", html);
+    if (request->hasArg("wifi_ssid")) {
+        s.wifiSSID = request->arg("wifi_ssid");
+    }
+    if (request->hasArg("wifi_pass") && request->arg("wifi_pass").length() > 0) {
+        s.wifiPassword = request->arg("wifi_pass");
+    }
+    if (request->hasArg("ip_addr")) {
+        s.staticIP = request->arg("ip_addr");
+        s.staticIP.trim();
+    }
+    if (request->hasArg("ip_gw")) {
+        s.gateway = request->arg("ip_gw");
+        s.gateway.trim();
+    }
+    if (request->hasArg("ip_mask")) {
+        s.subnet = request->arg("ip_mask");
+        s.subnet.trim();
+    }
+    if (request->hasArg("ip_dns")) {
+        s.dns = request->arg("ip_dns");
+        s.dns.trim();
+    }
+    if (request->hasArg("srv_host")) {
+        s.serverHost = request->arg("srv_host");
+    }
+    if (request->hasArg("srv_port")) {
+        s.serverPort = request->arg("srv_port").toInt();
+    }
+    if (request->hasArg("api_key")) {
+        s.apiKey = request->arg("api_key");
+    }
+    s.useHTTPS = request->hasArg("use_https");
+
+    if (request->hasArg("brightness")) {
+        s.brightness = request->arg("brightness").toInt();
+    }
+    if (request->hasArg("poll_int")) {
+        s.pollInterval = request->arg("poll_int").toInt();
+    }
+    if (request->hasArg("dev_name") && request->arg("dev_name").length() > 0) {
+        s.deviceName = request->arg("dev_name");
+    }
+    if (request->hasArg("dim_min")) {
+        s.idleDimMin = request->arg("dim_min").toInt();
+    }
+    if (request->hasArg("off_min")) {
+        s.idleOffMin = request->arg("off_min").toInt();
+    }
+    s.powerSave = request->hasArg("pwr_save");
+
+    // Written to NVS by update() on the main loop
+    _savePending = true;
+    xSemaphoreGive(_lock);
+
+    request->redirect("/?saved=1");
 }
 
-void ConfigWebServer::handleSave() {
-    if (_server.hasArg("wifi_ssid")) {
-        _settings->get().wifiSSID = _server.arg("wifi_ssid");
+void ConfigWebServer::handleStatus(AsyncWebServerRequest* request) {
+    auto bootRow = std::make_shared<size_t>(0);
+    sendTemplate(request, "application/json", STATUS_JSON,
+        [this, bootRow](ChunkWriter& out, const char* key) {
+            return fillStatus(out, key, *bootRow);
+        });
+}
+
+bool ConfigWebServer::fillStatus(ChunkWriter& out, const char* key,
+                                 size_t& bootRow) {
+    bool more = false;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (!strcmp(key, "WIFI_STATE")) {
+        out.write((long)_status.wifiState);
+    } else if (!strcmp(key, "IP")) {
+        out.write(_status.ip);
+    } else if (!strcmp(key, "API_CONNECTED")) {
+        out.write(_status.apiConnected ? "true" : "false");
+    } else if (!strcmp(key, "API_ERROR")) {
+        out.writeJson(_status.apiError);
+    } else if (!strcmp(key, "HEAP")) {
+        out.write((long)ESP.getFreeHeap());
+    } else if (!strcmp(key, "HEAP_LARGEST")) {
+        out.write((long)ESP.getMaxAllocHeap());
+    } else if (!strcmp(key, "HEAP_MIN")) {
+        out.write((long)ESP.getMinFreeHeap());
+    } else if (!strcmp(key, "POWER_STATE")) {
+        out.write(_status.powerState);
+    } else if (!strcmp(key, "BACKLIGHT_DUTY")) {
+        out.write(_status.backlightDuty, 3);
+    } else if (!strcmp(key, "IDLE_FRACTION")) {
+        out.write(_status.idleFraction, 3);
+    } else if (!strcmp(key, "AVG_CURRENT_MA")) {
+        out.write(_status.avgCurrentMa, 1);
+    } else if (!strcmp(key, "CAPTURE")) {
+        const CaptureStatus& c = _status.capture;
+        out.write("\"active\":");
+        out.write(c.active ? "true" : "false");
+        out.write(",\"full\":");
+        out.write(c.full ? "true" : "false");
+        out.write(",\"records\":");
+        out.write((long)c.records);
+        out.write(",\"bytes\":");
+        out.write((long)c.bytes);
+        out.write(",\"replaying\":");
+        out.write(c.replaying ? "true" : "false");
+        out.write(",\"replay_done\":");
+        out.write(c.replayDone ? "true" : "false");
+    } else if (!strcmp(key, "BOOT") && bootRow < _status.bootPhases) {
+        // One phase per call
+        const BootPhase& p = _status.boot[bootRow];
+        if (bootRow++ > 0) out.write(',');
+        out.write("{\"phase\":\"");
+        out.write(p.name);
+        out.write("\",\"at_ms\":");
+        out.write((long)p.atMs);
+        out.write(",\"took_ms\":");
+        out.write((long)p.tookMs);
+        out.write('}');
+        more = true;
+    } else if (!strcmp(key, "UPTIME")) {
+        out.write((long)(millis() / 1000));
+    }
+    xSemaphoreGive(_lock);
+    return more;
+}
+
+void ConfigWebServer::publishSnapshot(const DashboardData& dashboard,
+                                      const std::vector<ActiveJobData>& jobs,
+                                      const std::vector<DriveData>& drives,
+                                      const std::vector<TapeChangeData>& tapeChanges,
+                                      const LTFSFormatStatus& ltfs) {
+    // Only loop() replaces _snapshot, so it can be read here unlocked
+    uint32_t changed = 0;
+    std::shared_ptr<const Snapshot> snap = Snapshot::build(
+        _snapshot.get(), changed, dashboard, jobs, drives, tapeChanges, ltfs);
+    if (!changed) return;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _snapshot = snap;
+    xSemaphoreGive(_lock);
+
+    // One message buffer, shared by every connected viewer
+    if (_ws.count() > 0) _ws.textAll(snap->message(changed));
+}
+
+std::shared_ptr<const Snapshot> ConfigWebServer::currentSnapshot() {
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    std::shared_ptr<const Snapshot> snap = _snapshot;
+    xSemaphoreGive(_lock);
+    return snap;
+}
+
+void ConfigWebServer::handleSnapshot(AsyncWebServerRequest* request) {
+    std::shared_ptr<const Snapshot> snap = currentSnapshot();
+    if (!snap) {
+        request->send(503, "application/json", "{\"seq\":0}");
+        return;
+    }
+
+    // The response holds its own reference, so a poll finishing mid-send
+    // cannot free the sections being streamed
+    sendTemplate(request, "application/json", SNAPSHOT_JSON,
+        [snap](ChunkWriter& out, const char* key) {
+            if (!strcmp(key, "SEQ")) {
+                out.write((long)snap->seq);
+            } else if (!strcmp(key, "AGE")) {
+                out.write((long)(millis() - snap->takenAt));
+            } else if (!strcmp(key, "DASHBOARD")) {
+                out.includeText(snap->sections[SNAP_DASHBOARD].c_str());
+            } else if (!strcmp(key, "JOBS")) {
+                out.includeText(snap->sections[SNAP_JOBS].c_str());
+            } else if (!strcmp(key, "DRIVES")) {
+                out.includeText(snap->sections[SNAP_DRIVES].c_str());
+            } else if (!strcmp(key, "TAPE_CHANGES")) {
+                out.includeText(snap->sections[SNAP_TAPE_CHANGES].c_str());
+            } else if (!strcmp(key, "LTFS")) {
+                out.includeText(snap->sections[SNAP_LTFS].c_str());
+            }
+            return false;
+        });
+}
+
+static const char* const TAB_NAMES[SCREEN_CACHE_SLOTS] = {
+    "dashboard", "jobs", "drives"
+};
+
+// Everything /metrics reports, copied when the request arrives so the
+// response never holds the lock while it is sent
+#define LATENCY_ROWS  (LATENCY_BUCKETS + 2)   // Buckets, _sum, _count
+
+struct MetricsReply {
+    WebStatus status;
+    std::shared_ptr<const Snapshot> snap;
+    LatencyStats latency[LATENCY_MAX_TRACKERS];
+    size_t latencyCount;
+    uint32_t heapFree;
+    uint32_t heapLargest;
+    uint32_t heapMin;
+    HeapTagStats heapTags[HEAP_TAG_COUNT];
+    HeapTaskStack stacks[HEAP_MAX_TASKS];
+    size_t stackCount;
+    size_t next;    // Row of the list being written
+};
+
+// value / perSecond with a fixed number of decimals, without going
+// through float (the sums outgrow its precision)
+static void writeSeconds(ChunkWriter& out, uint64_t value,
+                         uint32_t perSecond, int decimals) {
+    char tmp[32];
+    snprintf(tmp, sizeof(tmp), "%llu.%0*lu",
+             (unsigned long long)(value / perSecond), decimals,
+             (unsigned long)(value % perSecond));
+    out.write(tmp);
+}
+
+static void writeLabels(ChunkWriter& out, const char* idName, long id,
+                        const char* nameName, const String& name) {
+    out.write('{');
+    out.write(idName);
+    out.write("=\"");
+    out.write(id);
+    out.write("\",");
+    out.write(nameName);
+    out.write("=\"");
+    out.writeLabel(name.c_str(), METRICS_LABEL_MAX);
+    out.write('"');
+}
+
+// name_sum and name_count lines of a summary with one label
+static void writeSummary(ChunkWriter& out, const char* name, const char* label,
+                         const char* value, uint64_t totalUs, uint32_t count) {
+    for (int line = 0; line < 2; line++) {
+        out.write(name);
+        out.write(line == 0 ? "_sum{" : "_count{");
+        out.write(label);
+        out.write("=\"");
+        out.write(value);
+        out.write("\"} ");
+        if (line == 0) writeSeconds(out, totalUs, 1000000, 6);
+        else           out.write((long)count);
+        out.write('\n');
     }
-    if (_server.hasArg("wifi_pass") && _server.arg("wifi_pass").length() > 0) {
-        _settings->get().wifiPassword = _server.arg("wifi_pass");
+}
+
+// Move to the next row of a list; false (and rewound) after the last
+static bool nextRow(MetricsReply& m, size_t count) {
+    if (++m.next < count) return true;
+    m.next = 0;
+    return false;
+}
+
+static bool fillMetrics(ChunkWriter& out, const char* key, MetricsReply& m) {
+    const WebStatus& st = m.status;
+
+    if (!strcmp(key, "UPTIME")) {
+        out.write((long)(millis() / 1000));
+    } else if (!strcmp(key, "HEAP_FREE")) {
+        out.write((long)m.heapFree);
+    } else if (!strcmp(key, "HEAP_LARGEST")) {
+        out.write((long)m.heapLargest);
+    } else if (!strcmp(key, "HEAP_MIN")) {
+        out.write((long)m.heapMin);
+    } else if (!strcmp(key, "WIFI_CONNECTED")) {
+        out.write(st.wifiState == WIFI_STATE_CONNECTED ? '1' : '0');
+    } else if (!strcmp(key, "RSSI")) {
+        out.write((long)st.rssi);
+    } else if (!strcmp(key, "WIFI_DISCONNECTS")) {
+        out.write((long)st.wifiDisconnects);
+    } else if (!strcmp(key, "WIFI_RECONNECTS")) {
+        out.write((long)st.wifiReconnects);
+    } else if (!strcmp(key, "WIFI_DOWNTIME")) {
+        writeSeconds(out, st.wifiDowntimeMs, 1000, 3);
+    } else if (!strcmp(key, "API_UP")) {
+        out.write(st.apiConnected ? '1' : '0');
+    } else if (!strcmp(key, "BACKLIGHT_DUTY")) {
+        out.write(st.backlightDuty, 3);
+    } else if (!strcmp(key, "AVG_CURRENT_MA")) {
+        out.write(st.avgCurrentMa, 1);
+
+    // Per endpoint
+    } else if (!strcmp(key, "POLL_REQUESTS")) {
+        out.write("cyd_poll_requests_total{endpoint=\"");
+        out.write(APIClient::endpointName(m.next));
+        out.write("\"} ");
+        out.write((long)st.api[m.next].requests);
+        out.write('\n');
+        return nextRow(m, API_ENDPOINT_COUNT);
+    } else if (!strcmp(key, "POLL_ERRORS")) {
+        out.write("cyd_poll_errors_total{endpoint=\"");
+        out.write(APIClient::endpointName(m.next));
+        out.write("\"} ");
+        out.write((long)st.api[m.next].errors);
+        out.write('\n');
+        return nextRow(m, API_ENDPOINT_COUNT);
+    } else if (!strcmp(key, "POLL_RETRIES")) {
+        out.write("cyd_poll_retries_total{endpoint=\"");
+        out.write(APIClient::endpointName(m.next));
+        out.write("\"} ");
+        out.write((long)st.api[m.next].retries);
+        out.write('\n');
+        return nextRow(m, API_ENDPOINT_COUNT);
+    } else if (!strcmp(key, "RTT_P99")) {
+        writeSeconds(out, st.apiRttP99Ms, 1000, 3);
+    } else if (!strcmp(key, "POLL_TIMEOUT")) {
+        writeSeconds(out, st.apiTimeoutMs, 1000, 3);
+    } else if (!strcmp(key, "POLL_LAST")) {
+        out.write("cyd_poll_last_duration_seconds{endpoint=\"");
+        out.write(APIClient::endpointName(m.next));
+        out.write("\"} ");
+        writeSeconds(out, st.api[m.next].lastMs, 1000, 3);
+        out.write('\n');
+        return nextRow(m, API_ENDPOINT_COUNT);
+    } else if (!strcmp(key, "POLL_DURATION")) {
+        const EndpointStats& e = st.api[m.next];
+        writeSummary(out, "cyd_poll_duration_seconds", "endpoint",
+                     APIClient::endpointName(m.next), e.totalMs * 1000, e.requests);
+        return nextRow(m, API_ENDPOINT_COUNT);
+
+    // Per tab
+    } else if (!strcmp(key, "RENDER_DURATION")) {
+        const RenderTiming& t = st.render[m.next];
+        writeSummary(out, "cyd_render_duration_seconds", "tab", TAB_NAMES[m.next],
+                     t.renderTotalUs, t.renders);
+        return nextRow(m, SCREEN_CACHE_SLOTS);
+    } else if (!strcmp(key, "BLIT_DURATION")) {
+        const RenderTiming& t = st.render[m.next];
+        writeSummary(out, "cyd_blit_duration_seconds", "tab", TAB_NAMES[m.next],
+                     t.blitTotalUs, t.blits);
+        return nextRow(m, SCREEN_CACHE_SLOTS);
+
+    // Per subsystem
+    } else if (!strcmp(key, "HEAP_ALLOCS") || !strcmp(key, "HEAP_BYTES") ||
+               !strcmp(key, "HEAP_FAILURES")) {
+        const HeapTagStats& t = m.heapTags[m.next];
+        long long value = t.allocs;
+        const char* name = "cyd_heap_allocations_total";
+        if (!strcmp(key, "HEAP_BYTES")) {
+            value = t.bytes;
+            name = "cyd_heap_allocated_bytes_total";
+        } else if (!strcmp(key, "HEAP_FAILURES")) {
+            value = t.failures;
+            name = "cyd_heap_allocation_failures_total";
+        }
+        out.write(name);
+        out.write("{subsystem=\"");
+        out.write(HeapMonitor::tagName(m.next));
+        out.write("\"} ");
+        out.write(value);
+        out.write('\n');
+        return nextRow(m, HEAP_TAG_COUNT);
+
+    // Per task
+    } else if (!strcmp(key, "STACK_FREE")) {
+        if (m.stackCount == 0) return false;
+        out.write("cyd_task_stack_free_bytes{task=\"");
+        out.write(m.stacks[m.next].name);
+        out.write("\"} ");
+        out.write((long)m.stacks[m.next].freeBytes);
+        out.write('\n');
+        return nextRow(m, m.stackCount);
+    } else if (!strcmp(key, "TASK_ITERATION")) {
+        if (m.latencyCount == 0) return false;
+        const LatencyStats& t = m.latency[m.next / LATENCY_ROWS];
+        int row = m.next % LATENCY_ROWS;
+        out.write("cyd_task_iteration_seconds");
+        if (row < LATENCY_BUCKETS) {
+            uint32_t count = 0;
+            for (int i = 0; i <= row; i++) count += t.histogram[i];
+            out.write("_bucket{task=\"");
+            out.write(t.task);
+            out.write("\",le=\"");
+            if (row < LATENCY_BUCKETS - 1) writeSeconds(out, 1UL << row, 1000, 3);
+            else                           out.write("+Inf");
+            out.write("\"} ");
+            out.write((long)count);
+        } else if (row == LATENCY_BUCKETS) {
+            out.write("_sum{task=\"");
+            out.write(t.task);
+            out.write("\"} ");
+            writeSeconds(out, t.totalUs, 1000000, 6);
+        } else {
+            out.write("_count{task=\"");
+            out.write(t.task);
+            out.write("\"} ");
+            out.write((long)t.iterations);
+        }
+        out.write('\n');
+        return nextRow(m, m.latencyCount * LATENCY_ROWS);
+    } else if (!strcmp(key, "TASK_STALLS")) {
+        if (m.latencyCount == 0) return false;
+        const LatencyStats& t = m.latency[m.next];
+        out.write("cyd_task_stalls_total{task=\"");
+        out.write(t.task);
+        out.write("\"} ");
+        out.write((long)t.stalls);
+        out.write('\n');
+        return nextRow(m, m.latencyCount);
+    } else if (!strcmp(key, "TASK_MAX")) {
+        if (m.latencyCount == 0) return false;
+        const LatencyStats& t = m.latency[m.next];
+        out.write("cyd_task_max_iteration_seconds{task=\"");
+        out.write(t.task);
+        out.write("\",phase=\"");
+        out.write(t.phaseNames[t.maxPhase]);
+        out.write("\"} ");
+        writeSeconds(out, t.maxMs, 1000, 3);
+        out.write('\n');
+        return nextRow(m, m.latencyCount);
+
+    // Mirrored TapeBackarr values
+    } else if (!strcmp(key, "TAPEBACKARR")) {
+        if (m.snap) out.include(METRICS_TAPEBACKARR);
+    } else if (!strcmp(key, "SNAP_AGE")) {
+        writeSeconds(out, millis() - m.snap->takenAt, 1000, 3);
+    } else if (!strcmp(key, "DASHBOARD")) {
+        if (m.snap->dashboard.valid) out.include(METRICS_DASHBOARD);
+    } else if (!strcmp(key, "TAPES")) {
+        out.write((long)m.snap->dashboard.totalTapes);
+    } else if (!strcmp(key, "ACTIVE_TAPES")) {
+        out.write((long)m.snap->dashboard.activeTapes);
+    } else if (!strcmp(key, "JOBS")) {
+        out.write((long)m.snap->dashboard.totalJobs);
+    } else if (!strcmp(key, "RUNNING_JOBS")) {
+        out.write((long)m.snap->dashboard.activeJobs);
+    } else if (!strcmp(key, "CAPACITY")) {
+        out.write((long long)m.snap->dashboard.totalCapacityBytes);
+    } else if (!strcmp(key, "USED")) {
+        out.write((long long)m.snap->dashboard.usedCapacityBytes);
+    } else if (!strcmp(key, "TAPE_CHANGES")) {
+        out.write((long)m.snap->tapeChanges);
+
+    // Per job
+    } else if (!strcmp(key, "JOB_BYTES") || !strcmp(key, "JOB_TOTAL") ||
+               !strcmp(key, "JOB_SPEED")) {
+        const std::vector<SnapshotJob>& jobs = m.snap->jobs;
+        if (jobs.empty()) return false;
+
+        const SnapshotJob& j = jobs[m.next];
+        long long value = (long long)j.writeSpeed;
+        const char* name = "tapebackarr_job_write_speed_bytes_per_second";
+        if (!strcmp(key, "JOB_BYTES")) {
+            value = j.bytesWritten;
+            name = "tapebackarr_job_bytes_written";
+        } else if (!strcmp(key, "JOB_TOTAL")) {
+            value = j.totalBytes;
+            name = "tapebackarr_job_total_bytes";
+        }
+        out.write(name);
+        writeLabels(out, "job_id", j.id, "job", j.name);
+        out.write("} ");
+        out.write(value);
+        out.write('\n');
+        return nextRow(m, jobs.size());
+
+    // Per drive
+    } else if (!strcmp(key, "DRIVE_STATUS")) {
+        if (m.snap->drives.empty()) return false;
+        const SnapshotDrive& d = m.snap->drives[m.next];
+        out.write("tapebackarr_drive_status");
+        writeLabels(out, "drive_id", d.id, "drive", d.name);
+        out.write(",status=\"");
+        out.writeLabel(d.status.c_str(), METRICS_LABEL_MAX);
+        out.write("\"} 1\n");
+        return nextRow(m, m.snap->drives.size());
+    } else if (!strcmp(key, "DRIVE_ENABLED")) {
+        if (m.snap->drives.empty()) return false;
+        const SnapshotDrive& d = m.snap->drives[m.next];
+        out.write("tapebackarr_drive_enabled");
+        writeLabels(out, "drive_id", d.id, "drive", d.name);
+        out.write(d.enabled ? "} 1\n" : "} 0\n");
+        return nextRow(m, m.snap->drives.size());
     }
-    if (_server.hasArg("srv_host")) {
-        _settings->get().serverHost = _server.arg("srv_host");
+    return false;
+}
+
+void ConfigWebServer::handleMetrics(AsyncWebServerRequest* request) {
+    auto reply = std::make_shared<MetricsReply>();
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    reply->status = _status;
+    reply->snap = _snapshot;
+    xSemaphoreGive(_lock);
+    reply->heapFree = ESP.getFreeHeap();
+    reply->heapLargest = ESP.getMaxAllocHeap();
+    reply->heapMin = ESP.getMinFreeHeap();
+    for (int i = 0; i < HEAP_TAG_COUNT; i++) {
+        reply->heapTags[i] = HeapMonitor::getTagStats(i);
     }
-    if (_server.hasArg("srv_port")) {
-        _settings->get().serverPort = _server.arg("srv_port").toInt();
+    reply->stackCount = HeapMonitor::getStacks(reply->stacks, HEAP_MAX_TASKS);
+    reply->latencyCount = LatencyTracker::count();
+    for (size_t i = 0; i < reply->latencyCount; i++) {
+        reply->latency[i] = LatencyTracker::get(i)->getStats();
     }
-    if (_server.hasArg("api_key")) {
-        _settings->get().apiKey = _server.arg("api_key");
+    reply->next = 0;
+
+    sendTemplate(request, METRICS_CONTENT_TYPE, METRICS_TEXT,
+        [reply](ChunkWriter& out, const char* key) {
+            return fillMetrics(out, key, *reply);
+        });
+}
+
+// Copied when the request arrives. Each task is written over several
+// calls (header and histogram, one recent stall each, close) so every
+// piece fits the chunk overflow.
+struct LatencyReply {
+    LatencyStats tasks[LATENCY_MAX_TRACKERS];
+    size_t count;
+    unsigned long now;
+    size_t task;
+    int part;
+};
+
+static bool fillLatency(ChunkWriter& out, const char* key, LatencyReply& r) {
+    if (strcmp(key, "TASKS") || r.task >= r.count) return false;
+    const LatencyStats& t = r.tasks[r.task];
+
+    if (r.part == 0) {
+        if (r.task > 0) out.write(',');
+        out.write("{\"task\":\"");
+        out.writeJson(t.task);
+        out.write("\",\"iterations\":");
+        out.write((long)t.iterations);
+        out.write(",\"avg_us\":");
+        out.write((long)(t.iterations ? t.totalUs / t.iterations : 0));
+        out.write(",\"max_ms\":");
+        out.write((long)t.maxMs);
+        out.write(",\"max_phase\":\"");
+        out.write(t.phaseNames[t.maxPhase]);
+        out.write("\",\"max_age_s\":");
+        out.write((long)(t.maxAtMs ? (r.now - t.maxAtMs) / 1000 : 0));
+        out.write(",\"stalls\":");
+        out.write((long)t.stalls);
+        if (t.running) {
+            out.write(",\"phase\":\"");
+            out.write(t.phaseNames[t.phase]);
+            out.write("\",\"running_ms\":");
+            out.write((long)t.runningMs);
+        }
+        // Count per bucket; bucket i holds iterations up to 2^i ms
+        out.write(",\"histogram\":[");
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            if (b > 0) out.write(',');
+            out.write((long)t.histogram[b]);
+        }
+        out.write("],\"recent_stalls\":[");
+    } else if (r.part <= t.recentCount) {
+        const LatencyStall& s = t.recent[r.part - 1];
+        if (r.part > 1) out.write(',');
+        out.write("{\"phase\":\"");
+        out.write(t.phaseNames[s.phase]);
+        out.write("\",\"ms\":");
+        out.write((long)s.ms);
+        out.write(",\"age_s\":");
+        out.write((long)((r.now - s.atMs) / 1000));
+        out.write('}');
     }
-    _settings->get().useHTTPS = _server.hasArg("use_https");
 
-    if (_server.hasArg("brightness")) {
-        _settings->get().brightness = _server.arg("brightness").toInt();
+    if (r.part++ <= t.recentCount) return true;
+    out.write("]}");
+    r.part = 0;
+    return ++r.task < r.count;
+}
+
+// Loop and poll task timings, readable while loop() is stuck: "phase"
+// and "running_ms" show where it is right now
+void ConfigWebServer::handleLatency(AsyncWebServerRequest* request) {
+    auto reply = std::make_shared<LatencyReply>();
+    reply->count = LatencyTracker::count();
+    for (size_t i = 0; i < reply->count; i++) {
+        reply->tasks[i] = LatencyTracker::get(i)->getStats();
     }
-    if (_server.hasArg("poll_int")) {
-        _settings->get().pollInterval = _server.arg("poll_int").toInt();
+    reply->now = millis();
+    reply->task = 0;
+    reply->part = 0;
+
+    sendTemplate(request, "application/json", LATENCY_JSON,
+        [reply](ChunkWriter& out, const char* key) {
+            return fillLatency(out, key, *reply);
+        });
+}
+
+// Copied when the request arrives; the history is written one row per call
+struct HeapReply {
+    uint32_t free;
+    uint32_t largest;
+    uint32_t minFree;
+    HeapTagStats tags[HEAP_TAG_COUNT];
+    HeapTaskStack stacks[HEAP_MAX_TASKS];
+    size_t stackCount;
+    HeapSample history[HEAP_HISTORY];
+    size_t samples;
+    size_t next;
+};
+
+static bool fillHeap(ChunkWriter& out, const char* key, HeapReply& h) {
+    if (!strcmp(key, "FREE")) {
+        out.write((long)h.free);
+    } else if (!strcmp(key, "LARGEST")) {
+        out.write((long)h.largest);
+    } else if (!strcmp(key, "MIN_FREE")) {
+        out.write((long)h.minFree);
+    } else if (!strcmp(key, "INTERVAL")) {
+        out.write((long)(HEAP_SAMPLE_MS / 1000));
+    } else if (!strcmp(key, "SUBSYSTEMS")) {
+        const HeapTagStats& t = h.tags[h.next];
+        if (h.next > 0) out.write(',');
+        out.write("{\"name\":\"");
+        out.write(HeapMonitor::tagName(h.next));
+        out.write("\",\"allocs\":");
+        out.write((long)t.allocs);
+        out.write(",\"bytes\":");
+        out.write((long long)t.bytes);
+        out.write(",\"failures\":");
+        out.write((long)t.failures);
+        out.write('}');
+        if (++h.next < HEAP_TAG_COUNT) return true;
+        h.next = 0;
+    } else if (!strcmp(key, "STACKS") && h.next < h.stackCount) {
+        const HeapTaskStack& t = h.stacks[h.next];
+        if (h.next > 0) out.write(',');
+        out.write("{\"task\":\"");
+        out.writeJson(t.name);
+        out.write("\",\"free\":");
+        out.write((long)t.freeBytes);
+        out.write('}');
+        if (++h.next < h.stackCount) return true;
+        h.next = 0;
+    } else if (!strcmp(key, "HISTORY") && h.next < h.samples) {
+        const HeapSample& s = h.history[h.next];
+        if (h.next > 0) out.write(',');
+        out.write("{\"t\":");
+        out.write((long)s.uptimeS);
+        out.write(",\"free\":");
+        out.write((long)s.freeBytes);
+        out.write(",\"largest\":");
+        out.write((long)s.largestBlock);
+        out.write(",\"min_free\":");
+        out.write((long)s.minFree);
+        out.write(",\"alloc\":[");
+        for (int i = 0; i < HEAP_TAG_COUNT; i++) {
+            if (i > 0) out.write(',');
+            out.write((long)s.allocBytes[i]);
+        }
+        out.write("]}");
+        if (++h.next < h.samples) return true;
+        h.next = 0;
     }
-    if (_server.hasArg("dev_name") && _server.arg("dev_name").length() > 0) {
-        _settings->get().deviceName = _server.arg("dev_name");
+    return false;
+}
+
+// Heap history for spotting leaks and fragmentation, plus allocation
+// totals per subsystem and stack high-water marks
+void ConfigWebServer::handleHeap(AsyncWebServerRequest* request) {
+    auto reply = std::make_shared<HeapReply>();
+    reply->free = ESP.getFreeHeap();
+    reply->largest = ESP.getMaxAllocHeap();
+    reply->minFree = ESP.getMinFreeHeap();
+    for (int i = 0; i < HEAP_TAG_COUNT; i++) {
+        reply->tags[i] = HeapMonitor::getTagStats(i);
     }
+    reply->stackCount = HeapMonitor::getStacks(reply->stacks, HEAP_MAX_TASKS);
+    reply->samples = HeapMonitor::getHistory(reply->history, HEAP_HISTORY);
+    reply->next = 0;
 
-    _settings->save();
+    sendTemplate(request, "application/json", HEAP_JSON,
+        [reply](ChunkWriter& out, const char* key) {
+            return fillHeap(out, key, *reply);
+        });
+}
 
-    _server.sendHeader("Location", "/?saved=1");
-    _server.send(302, "text/plain", "Settings saved. Redirecting...");
+void ConfigWebServer::handleReboot(AsyncWebServerRequest* request) {
+    request->send(200, "text/html", PAGE_REBOOT);
+    _rebootAt = millis() + REBOOT_DELAY_MS;
 }
 
-void ConfigWebServer::handleStatus() {
-    String json = "{";
-    json += "\"wifi_state\":" + String(_wifi->getState()) + ",";
-    json += "\"wifi_ip\":\"" + _wifi->getIP() + "\",";
-    json += "\"api_connected\":" + String(_api->isConnected() ? "true" : "false") + ",";
-    json += "\"api_error\":\"" + htmlEscape(_api->getLastError()) + "\",";
-    json += "\"heap\":" + String(ESP.getFreeHeap()) + ",";
-    json += "\"uptime\":" + String(millis() / 1000);
-    json += "}";
-    _server.send(200, "application/json", json);
+void ConfigWebServer::handleReset(AsyncWebServerRequest* request) {
+    request->send(200, "text/html", PAGE_RESET);
+    _resetPending = true;
+    _rebootAt = millis() + REBOOT_DELAY_MS;
 }
 
-void ConfigWebServer::handleReboot() {
-    _server.send(200, "text/html",
-        "<html><body><h2>Rebooting...</h2>"
-        "<p>Device will restart in a few seconds.</p>"
-        "<script>setTimeout(()=>window.location='/',10000)</script>"
-        "</body></html>");
-    delay(500);
-    ESP.restart();
+// The capture file as recorded so far; it is flushed after every answer
+void ConfigWebServer::handleCapture(AsyncWebServerRequest* request) {
+    if (!SPIFFS.exists(CAPTURE_FILE)) {
+        request->send(404, "text/plain", "No capture");
+        return;
+    }
+    request->send(request->beginResponse(SPIFFS, CAPTURE_FILE,
+                                         "application/octet-stream", true));
 }
 
-void ConfigWebServer::handleReset() {
-    _settings->reset();
-    _server.send(200, "text/html",
-        "<html><body><h2>Settings Reset</h2>"
-        "<p>All settings cleared. Device will restart.</p>"
-        "<script>setTimeout(()=>window.location='/',10000)</script>"
-        "</body></html>");
-    delay(500);
-    ESP.restart();
+// Carried out by update(). Replay is chosen at boot, before the first
+// poll, so arming or disarming it reboots.
+void ConfigWebServer::handleCaptureAction(AsyncWebServerRequest* request,
+                                          CaptureAction action) {
+    if (action == REPLAY_ARM && !SPIFFS.exists(CAPTURE_FILE)) {
+        request->send(409, "text/plain", "No capture to replay");
+        return;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    bool busy = _captureAction != CAPTURE_NONE;
+    if (!busy) _captureAction = action;
+    xSemaphoreGive(_lock);
+    if (busy) {
+        request->send(409, "text/plain", "Capture action still pending");
+        return;
+    }
+    if (action == REPLAY_ARM || action == REPLAY_DISARM) {
+        request->send(200, "text/html", PAGE_REBOOT);
+        _rebootAt = millis() + REBOOT_DELAY_MS;
+    } else {
+        request->redirect("/");
+    }
+}
+
+struct ScanReply {
+    ScanNetwork networks[SCAN_MAX_RESULTS];
+    size_t count;
+    size_t next;
+    long ageMs;
+    bool scanning;
+};
+
+void ConfigWebServer::handleScan(AsyncWebServerRequest* request) {
+    // Answer from the cache straight away; the browser polls again while
+    // a fresh scan is running
+    _wifi->requestScan();
+
+    auto reply = std::make_shared<ScanReply>();
+    reply->count = _wifi->getScanResults(reply->networks, SCAN_MAX_RESULTS,
+                                         reply->ageMs, reply->scanning);
+    reply->next = 0;
+
+    sendTemplate(request, "application/json", SCAN_JSON,
+        [reply](ChunkWriter& out, const char* key) {
+            if (!strcmp(key, "SCANNING")) {
+                out.write(reply->scanning ? "true" : "false");
+                return false;
+            }
+            if (!strcmp(key, "AGE")) {
+                out.write(reply->ageMs);
+                return false;
+            }
+            if (strcmp(key, "NETWORKS") || reply->next >= reply->count) return false;
+
+            // One network per call
+            const ScanNetwork& n = reply->networks[reply->next];
+            if (reply->next++ > 0) out.write(',');
+            out.write("{\"ssid\":\"");
+            out.writeJson(n.ssid);
+            out.write("\",\"rssi\":");
+            out.write((long)n.rssi);
+            out.write(",\"secure\":");
+            out.write(n.secure ? "true" : "false");
+            out.write('}');
+            return true;
+        });
+}
+
+struct ServersReply {
+    DiscoveredServer servers[DISCOVERY_MAX_SERVERS];
+    size_t count;
+    size_t next;
+    long ageMs;
+    bool browsing;
+};
+
+void ConfigWebServer::handleServers(AsyncWebServerRequest* request) {
+    // Same pattern as /scan: cached results now, poll while browsing
+    _discovery->requestBrowse();
+
+    auto reply = std::make_shared<ServersReply>();
+    reply->count = _discovery->getServers(reply->servers, DISCOVERY_MAX_SERVERS,
+                                          reply->ageMs, reply->browsing);
+    reply->next = 0;
+
+    sendTemplate(request, "application/json", SERVERS_JSON,
+        [reply](ChunkWriter& out, const char* key) {
+            if (!strcmp(key, "BROWSING")) {
+                out.write(reply->browsing ? "true" : "false");
+                return false;
+            }
+            if (!strcmp(key, "AGE")) {
+                out.write(reply->ageMs);
+                return false;
+            }
+            if (strcmp(key, "SERVERS") || reply->next >= reply->count) return false;
+
+            // One server per call
+            const DiscoveredServer& d = reply->servers[reply->next];
+            if (reply->next++ > 0) out.write(',');
+            out.write("{\"name\":\"");
+            out.writeJson(d.name);
+            out.write("\",\"host\":\"");
+            out.writeJson(d.host);
+            out.write("\",\"ip\":\"");
+            out.write(IPAddress(d.ip).toString());
+            out.write("\",\"port\":");
+            out.write((long)d.port);
+            out.write('}');
+            return true;
+        });
 }
 
-void ConfigWebServer::handleScan() {
-    int n = WiFi.scanNetworks();
-    String json = "[";
-    for (int i = 0; i < n; i++) {
-        if (i > 0) json += ",";
-        json += "{\"ssid\":\"" + htmlEscape(WiFi.SSID(i)) + "\",";
-        json += "\"rssi\":" + String(WiFi.RSSI(i)) + ",";
-        json += "\"secure\":" + String(WiFi.encryptionType(i) != WIFI_AUTH_OPEN ? "true" : "false") + "}";
+// ── Static web UI (SPIFFS) ─────────────────────────────────────────────
+
+// Index the gzipped assets once at boot. The ETag is a hash of the stored
+// bytes, so it changes exactly when a new filesystem image is uploaded.
+void ConfigWebServer::loadAssets() {
+    if (!SPIFFS.begin(false)) {
+        Serial.println("SPIFFS not mounted, using built-in page");
+        return;
     }
-    json += "]";
-    WiFi.scanDelete();
-    _server.send(200, "application/json", json);
+
+    File dir = SPIFFS.open(WEB_ROOT);
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        String path = f.path();
+        if (!path.startsWith(WEB_ROOT "/") || !path.endsWith(".gz")) continue;
+
+        // FNV-1a
+        uint32_t hash = 2166136261u;
+        uint8_t buf[128];
+        size_t n;
+        while ((n = f.read(buf, sizeof(buf))) > 0) {
+            for (size_t i = 0; i < n; i++) hash = (hash ^ buf[i]) * 16777619u;
+        }
+
+        WebAsset asset;
+        asset.file = path;
+        asset.url = path.substring(strlen(WEB_ROOT), path.length() - 3);
+        char etag[12];
+        snprintf(etag, sizeof(etag), "\"%08x\"", hash);
+        asset.etag = etag;
+        _assets.push_back(asset);
+    }
+
+    Serial.printf("Web UI: %u files in SPIFFS\n", (unsigned)_assets.size());
 }
 
-String ConfigWebServer::htmlEscape(const String& str) {
-    String out = str;
-    out.replace("&", "&amp;");
-    out.replace("<", "&lt;");
-    out.replace(">", "&gt;");
-    out.replace("\"", "&quot;");
-    out.replace("'", "&#39;");
-    return out;
+const WebAsset* ConfigWebServer::findAsset(const String& url) const {
+    for (const WebAsset& a : _assets) {
+        if (a.url == url) return &a;
+    }
+    return nullptr;
+}
+
+static const char* contentTypeFor(const String& url) {
+    if (url.endsWith(".html")) return "text/html";
+    if (url.endsWith(".css"))  return "text/css";
+    if (url.endsWith(".js"))   return "application/javascript";
+    if (url.endsWith(".json")) return "application/json";
+    if (url.endsWith(".svg"))  return "image/svg+xml";
+    if (url.endsWith(".png"))  return "image/png";
+    if (url.endsWith(".ico"))  return "image/x-icon";
+    return "application/octet-stream";
+}
+
+void ConfigWebServer::sendAsset(AsyncWebServerRequest* request,
+                                const WebAsset& asset) {
+    // Pages keep fixed URLs and must revalidate; everything they load is
+    // content-hashed by the build and never changes
+    const char* cacheControl = asset.url.endsWith(".html")
+                               ? CACHE_REVALIDATE : CACHE_IMMUTABLE;
+
+    AsyncWebServerResponse* response;
+    if (request->hasHeader("If-None-Match") &&
+        request->getHeader("If-None-Match")->value() == asset.etag) {
+        response = request->beginResponse(304);
+    } else {
+        response = request->beginResponse(SPIFFS, asset.file, contentTypeFor(asset.url));
+        response->addHeader("Content-Encoding", "gzip");
+    }
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
 }
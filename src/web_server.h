@@ -1,31 +1,210 @@
 #pragma once
 
 #include <Arduino.h>
-#include <WebServer.h>
+#include <functional>
+#include <vector>
+#include <ESPAsyncWebServer.h>
 #include <DNSServer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "settings.h"
 #include "wifi_manager.h"
 #include "api_client.h"
+#include "api_capture.h"
+#include "power_manager.h"
+#include "display.h"
+#include "discovery.h"
+#include "boot_profile.h"
+#include "latency.h"
+#include "heap_monitor.h"
+#include "snapshot.h"
 
+// Overflow held between chunks: one settings value escaped at its worst
+// (&quot; in HTML, \u00XX in JSON: 6 bytes per character)
+#define CHUNK_BUFFER_SIZE  (SETTING_TEXT_MAX * 6)
+#define TEMPLATE_KEY_MAX   16    // Longest %KEY% placeholder
+#define TEMPLATE_DEPTH     3     // Nested include() levels
+#define STATUS_REFRESH_MS  500   // How often loop() republishes /status values
+
+// Renders a PROGMEM template into an AsyncWebServer chunked response.
+//
+// The server pulls the body in pieces with read(); each call copies the
+// template from flash and calls fill() for %KEY% placeholders. Whatever a
+// fill writes past the end of the current chunk waits in a small fixed
+// buffer, so a response never needs more heap than that however long the
+// page is. A fill that does not fit ends the response rather than sending
+// a cut-off value.
+class ChunkWriter {
+public:
+    // Return true to be called again for the same key in the next pass
+    // (used to emit lists one element at a time)
+    typedef std::function<bool(ChunkWriter& out, const char* key)> FillFn;
+
+    ChunkWriter(PGM_P tpl, FillFn fill);
+
+    // Chunk filler: up to maxLen bytes, 0 once the template is done
+    size_t read(uint8_t* buf, size_t maxLen);
+
+    // For fill functions
+    void write(char c);
+    void write(const char* str);
+    void write(const String& str) { write(str.c_str()); }
+    void write(long value);
+    void write(long long value);
+    void write(float value, int decimals);
+    void writeEscaped(const char* str);
+    void writeEscaped(const String& str) { writeEscaped(str.c_str()); }
+    void writeJson(const char* str);   // Escaped for a JSON string
+    void writeJson(const String& str) { writeJson(str.c_str()); }
+    void writeLabel(const char* str, size_t maxLen);  // Prometheus label value
+    void include(PGM_P tpl);    // Continue with another PROGMEM template
+
+    // Continue with text copied verbatim (no placeholders), for values
+    // longer than the overflow buffer. Must stay valid until the response
+    // is finished.
+    void includeText(const char* text);
+
+private:
+    PGM_P _stack[TEMPLATE_DEPTH];
+    bool _literal[TEMPLATE_DEPTH];
+    int _depth = 0;
+    FillFn _fill;
+    char _repeatKey[TEMPLATE_KEY_MAX + 1] = "";
+
+    uint8_t* _out = nullptr;
+    size_t _outLen = 0;
+    size_t _outMax = 0;
+    char _pending[CHUNK_BUFFER_SIZE];
+    size_t _pendingLen = 0;
+    bool _overflow = false;
+
+    bool nextKey(char* key);
+};
+
+// Values shown by /status, /metrics and the page's status card. Published
+// from loop() so request handlers never read other modules' Strings or
+// counters while they are being changed.
+struct WebStatus {
+    int wifiState;
+    char ip[16];
+    int rssi;
+    uint32_t wifiDisconnects;
+    uint32_t wifiReconnects;
+    unsigned long wifiDowntimeMs;
+    bool apiConnected;
+    char apiError[64];
+    const char* powerState;
+    float backlightDuty;
+    float idleFraction;
+    float avgCurrentMa;
+    CaptureStatus capture;
+    EndpointStats api[API_ENDPOINT_COUNT];
+    uint16_t apiTimeoutMs;
+    uint16_t apiRttP99Ms;
+    RenderTiming render[SCREEN_CACHE_SLOTS];
+    BootPhase boot[BOOT_PHASE_MAX];
+    size_t bootPhases;
+};
+
+// Gzipped web UI file in SPIFFS, built from web/ by tools/build_web.py
+struct WebAsset {
+    String url;     // e.g. "/app.1a2b3c4d.js"
+    String file;    // e.g. "/www/app.1a2b3c4d.js.gz"
+    String etag;
+};
+
+// Queued by the capture and replay pages for update(): their SPIFFS work
+// waits on the poll task, which must not happen on the async_tcp task
+enum CaptureAction : uint8_t {
+    CAPTURE_NONE,
+    CAPTURE_START,
+    CAPTURE_STOP,
+    REPLAY_ARM,
+    REPLAY_DISARM
+};
+
+// Configuration interface on ESPAsyncWebServer.
+//
+// Requests are handled in the AsyncTCP task, several at a time, so they
+// are answered while loop() is blocked in an API poll. Anything that must
+// run on the main loop (saving settings, reboot, factory reset) is queued
+// here and carried out by update().
+//
+// The page itself is served from SPIFFS, pre-compressed and cacheable,
+// and fetches its values from /config and /status. A built-in page is
+// used if the filesystem image has not been uploaded.
 class ConfigWebServer {
 public:
     void begin(SettingsManager& settings, WiFiManager& wifi,
-               APIClient& api);
-    void handleClient();
+               APIClient& api, PowerManager& power, Display& display,
+               ServerDiscovery& discovery, BootProfile& boot,
+               ApiCapture& capture);
+
+    // Call from loop(): captive-portal DNS (in AP mode), status values,
+    // queued actions
+    void update();
+
+    // Call from loop() after each poll. Serves the data at /snapshot and
+    // pushes the sections that changed to /ws viewers.
+    void publishSnapshot(const DashboardData& dashboard,
+                         const std::vector<ActiveJobData>& jobs,
+                         const std::vector<DriveData>& drives,
+                         const std::vector<TapeChangeData>& tapeChanges,
+                         const LTFSFormatStatus& ltfs);
 
 private:
-    WebServer _server{80};
+    AsyncWebServer _server{80};
+    AsyncWebSocket _ws{"/ws"};
     DNSServer _dns;
+    bool _dnsRunning = false;
     SettingsManager* _settings = nullptr;
     WiFiManager* _wifi = nullptr;
     APIClient* _api = nullptr;
+    PowerManager* _power = nullptr;
+    Display* _display = nullptr;
+    ServerDiscovery* _discovery = nullptr;
+    BootProfile* _boot = nullptr;
+    ApiCapture* _capture = nullptr;
+
+    // Guards _status, _pending, _captureAction, _snapshot and reads of the
+    // live settings
+    SemaphoreHandle_t _lock = nullptr;
+    WebStatus _status = {};
+    unsigned long _lastStatus = 0;
+    AppSettings _pending;
+    bool _savePending = false;
+    volatile bool _resetPending = false;
+    volatile unsigned long _rebootAt = 0;
+    CaptureAction _captureAction = CAPTURE_NONE;
+    std::vector<WebAsset> _assets;
+    std::shared_ptr<const Snapshot> _snapshot;
+
+    void handleRoot(AsyncWebServerRequest* request);
+    void handleConfig(AsyncWebServerRequest* request);
+    void handleSave(AsyncWebServerRequest* request);
+    void handleStatus(AsyncWebServerRequest* request);
+    void handleReboot(AsyncWebServerRequest* request);
+    void handleReset(AsyncWebServerRequest* request);
+    void handleScan(AsyncWebServerRequest* request);
+    void handleServers(AsyncWebServerRequest* request);
+    void handleSnapshot(AsyncWebServerRequest* request);
+    void handleMetrics(AsyncWebServerRequest* request);
+    void handleLatency(AsyncWebServerRequest* request);
+    void handleHeap(AsyncWebServerRequest* request);
+    void handleCapture(AsyncWebServerRequest* request);
+    void handleCaptureAction(AsyncWebServerRequest* request, CaptureAction action);
+    std::shared_ptr<const Snapshot> currentSnapshot();
+
+    void sendTemplate(AsyncWebServerRequest* request, const char* contentType,
+                      PGM_P tpl, ChunkWriter::FillFn fill);
+    bool fillRoot(ChunkWriter& out, const char* key, bool saved);
+    bool fillConfig(ChunkWriter& out, const char* key);
+    bool fillStatus(ChunkWriter& out, const char* key, size_t& bootRow);
 
-    void handleRoot();
-    void handleSave();
-    void handleStatus();
-    void handleReboot();
-    void handleReset();
-    void handleScan();
+    void loadAssets();
+    const WebAsset* findAsset(const String& url) const;
+    void sendAsset(AsyncWebServerRequest* request, const WebAsset& asset);
 
-    String htmlEscape(const String& str);
+    void publishStatus();
+    const AppSettings& shownSettings() const;
 };
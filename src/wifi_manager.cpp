@@ -8,6 +8,11 @@ void WiFiManager::begin(SettingsManager& settings) {
     }
 
     WiFi.setHostname(_apName.c_str());
+    WiFi.persistent(false);       // Credentials live in our settings; skip the SDK's flash writes
+    WiFi.setAutoReconnect(false); // update() owns retries
+    WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info) {
+        onEvent(event, info);
+    });
 
     if (settings.get().wifiSSID.length() > 0) {
         startSTA();
@@ -16,22 +21,117 @@ void WiFiManager::begin(SettingsManager& settings) {
     }
 }
 
+// WiFi task: just note what happened
+void WiFiManager::onEvent(arduino_event_id_t event, arduino_event_info_t info) {
+    portENTER_CRITICAL(&_eventMux);
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+            _evAssociated = true;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            _evGotIP = true;
+            _evLost = false;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            // Our own disconnect before a new attempt, not a failure
+            if (info.wifi_sta_disconnected.reason == WIFI_REASON_ASSOC_LEAVE) break;
+            _evLost = true;
+            _evAssociated = false;
+            _evGotIP = false;
+            _evReason = info.wifi_sta_disconnected.reason;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+            _evLost = true;
+            _evGotIP = false;
+            break;
+        default:
+            break;
+    }
+    portEXIT_CRITICAL(&_eventMux);
+}
+
 void WiFiManager::update() {
-    if (_state == WIFI_STATE_CONNECTING) {
-        if (WiFi.status() == WL_CONNECTED) {
-            _state = WIFI_STATE_CONNECTED;
-            Serial.print("WiFi connected, IP: ");
-            Serial.println(WiFi.localIP());
-        } else if (millis() - _connectStart > CONNECT_TIMEOUT) {
-            Serial.println("WiFi connection timeout, starting AP");
-            startAP();
-        }
-    } else if (_state == WIFI_STATE_CONNECTED) {
-        if (WiFi.status() != WL_CONNECTED) {
-            Serial.println("WiFi disconnected, reconnecting...");
-            startSTA();
-        }
+    updateScan();
+
+    portENTER_CRITICAL(&_eventMux);
+    bool associated = _evAssociated;
+    bool gotIP = _evGotIP;
+    bool lost = _evLost;
+    uint8_t reason = _evReason;
+    _evAssociated = _evGotIP = _evLost = false;
+    portEXIT_CRITICAL(&_eventMux);
+
+    if (lost && reason) _lastReason = reason;
+
+    switch (_state) {
+        case WIFI_STATE_CONNECTING:
+            if (associated && !_associatedAt) _associatedAt = millis();
+            if (gotIP) {
+                connected();
+            } else if (_fastConnect && !_associatedAt &&
+                       (lost || millis() - _connectStart > FAST_CONNECT_TIMEOUT)) {
+                // AP moved to another channel or was replaced. Only a failed
+                // association says so; slow DHCP does not.
+                Serial.println("Cached AP not answering, scanning");
+                _settings->getLinkCache().channel = 0;
+                _settings->saveLinkCache();
+                beginConnect(false);
+            } else if (lost ||
+                       (!_associatedAt && millis() - _connectStart > CONNECT_TIMEOUT) ||
+                       (_associatedAt && millis() - _associatedAt > DHCP_TIMEOUT)) {
+                if (_associatedAt && !lost) Serial.println("WiFi: no DHCP lease");
+                connectFailed();
+            }
+            break;
+
+        case WIFI_STATE_CONNECTED:
+            if (lost) {
+                _disconnects++;
+                _downSince = millis();
+                Serial.printf("WiFi link lost (reason %u), reconnecting\n", reason);
+                // Straight back to the same AP; backoff only once that fails
+                _backoff = 0;
+                startSTA();
+            }
+            break;
+
+        case WIFI_STATE_DISCONNECTED:
+            if ((long)(millis() - _retryAt) >= 0) startSTA();
+            break;
+
+        case WIFI_STATE_AP_MODE:
+            break;
+    }
+}
+
+void WiFiManager::connected() {
+    _state = WIFI_STATE_CONNECTED;
+    _backoff = 0;
+    if (_downSince) {
+        _downtimeMs += millis() - _downSince;
+        _downSince = 0;
     }
+    if (_wasConnected) _reconnects++;
+    _wasConnected = true;
+
+    Serial.printf("WiFi connected in %lu ms%s, IP: %s\n",
+                  millis() - _connectStart,
+                  _fastConnect ? " (cached AP)" : "",
+                  WiFi.localIP().toString().c_str());
+    rememberLink();
+}
+
+void WiFiManager::connectFailed() {
+    _backoff = _backoff ? min(_backoff * 2, (unsigned long)RETRY_MAX_MS) : RETRY_MIN_MS;
+    _retryAt = millis() + _backoff;
+    _state = WIFI_STATE_DISCONNECTED;
+    if (!_downSince && _wasConnected) _downSince = millis();
+    Serial.printf("WiFi connect failed (reason %u), retry in %lu s\n",
+                  _lastReason, _backoff / 1000);
+}
+
+unsigned long WiFiManager::getDowntimeMs() const {
+    return _downtimeMs + (_downSince ? millis() - _downSince : 0);
 }
 
 String WiFiManager::getIP() const {
@@ -48,6 +148,10 @@ void WiFiManager::startAP() {
     WiFi.mode(WIFI_AP);
     WiFi.softAP(_apName.c_str());
     _state = WIFI_STATE_AP_MODE;
+    if (_downSince) {
+        _downtimeMs += millis() - _downSince;
+        _downSince = 0;
+    }
     Serial.print("AP started: ");
     Serial.println(_apName);
     Serial.print("AP IP: ");
@@ -60,18 +164,145 @@ void WiFiManager::startSTA() {
         return;
     }
 
-    WiFi.disconnect(true);
-    WiFi.mode(WIFI_AP_STA);
-    WiFi.softAP(_apName.c_str());
-    WiFi.begin(_settings->get().wifiSSID.c_str(),
-               _settings->get().wifiPassword.c_str());
-    _state = WIFI_STATE_CONNECTING;
-    _connectStart = millis();
+    // STA only: a reconnect must not bring the setup AP back up
+    if (WiFi.getMode() != WIFI_STA) WiFi.mode(WIFI_STA);
+
+    const WiFiLinkCache& link = _settings->getLinkCache();
+    beginConnect(link.channel != 0 &&
+                 _settings->get().wifiSSID == link.ssid);
     Serial.print("Connecting to WiFi: ");
     Serial.println(_settings->get().wifiSSID);
 }
 
-void WiFiManager::disconnect() {
-    WiFi.disconnect(true);
-    _state = WIFI_STATE_DISCONNECTED;
+// Fast: straight to the cached BSSID on its channel. Otherwise a full
+// scan for the SSID. Either way DHCP runs unless an address is set.
+void WiFiManager::beginConnect(bool fast) {
+    const AppSettings& s = _settings->get();
+    const WiFiLinkCache& link = _settings->getLinkCache();
+
+    _fastConnect = fast;
+    _associatedAt = 0;
+    configureIP();
+    if (fast) {
+        WiFi.begin(s.wifiSSID.c_str(), s.wifiPassword.c_str(),
+                   link.channel, link.bssid, true);
+    } else {
+        WiFi.begin(s.wifiSSID.c_str(), s.wifiPassword.c_str());
+    }
+    _state = WIFI_STATE_CONNECTING;
+    _connectStart = millis();
+}
+
+// Static address from the settings, else DHCP. Only the user's static
+// address turns DHCP off: a reused lease would never be renewed and the
+// server could hand it to another host. lwIP asks for the previous
+// address again (INIT-REBOOT), so a reconnect still keeps it.
+void WiFiManager::configureIP() {
+    const AppSettings& s = _settings->get();
+    IPAddress ip, gateway, subnet, dns;
+
+    if (!ip.fromString(s.staticIP)) {
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+        return;
+    }
+    gateway.fromString(s.gateway);
+    if (!subnet.fromString(s.subnet)) subnet = IPAddress(255, 255, 255, 0);
+    if (!dns.fromString(s.dns)) dns = gateway;
+    WiFi.config(ip, gateway, subnet, dns);
+}
+
+// Store the AP we got; NVS is only written when it changes
+void WiFiManager::rememberLink() {
+    WiFiLinkCache link = {};
+    strlcpy(link.ssid, _settings->get().wifiSSID.c_str(), sizeof(link.ssid));
+    const uint8_t* bssid = WiFi.BSSID();
+    if (bssid) memcpy(link.bssid, bssid, sizeof(link.bssid));
+    link.channel = WiFi.channel();
+
+    WiFiLinkCache& cached = _settings->getLinkCache();
+    if (memcmp(&cached, &link, sizeof(link)) != 0) {
+        cached = link;
+        _settings->saveLinkCache();
+    }
+}
+
+void WiFiManager::requestScan() {
+    if (_scanRunning || _scanRequested) return;
+    if (_scanAt && millis() - _scanAt < SCAN_FRESH_MS) return;
+    _scanRequested = true;
+}
+
+size_t WiFiManager::getScanResults(ScanNetwork* out, size_t max,
+                                   long& ageMs, bool& scanning) {
+    portENTER_CRITICAL(&_scanMux);
+    size_t n = min(max, _scanCount);
+    memcpy(out, _scanResults, n * sizeof(ScanNetwork));
+    ageMs = _scanAt ? (long)(millis() - _scanAt) : -1;
+    scanning = _scanRunning || _scanRequested;
+    portEXIT_CRITICAL(&_scanMux);
+    return n;
+}
+
+void WiFiManager::updateScan() {
+    if (_scanRunning) {
+        int16_t n = WiFi.scanComplete();
+        if (n == WIFI_SCAN_RUNNING) return;
+
+        if (n >= 0) storeScan(n);
+        WiFi.scanDelete();
+        _scanRunning = false;
+        return;
+    }
+
+    // Scanning while associating makes the connection attempt fail
+    if (!_scanRequested || _state == WIFI_STATE_CONNECTING) return;
+
+    // Async: results are collected by later update() calls
+    if (WiFi.scanNetworks(true, false, false, SCAN_MS_PER_CHANNEL) == WIFI_SCAN_FAILED) {
+        Serial.println("WiFi scan failed to start");
+    } else {
+        _scanRunning = true;
+    }
+    _scanRequested = false;
+}
+
+// Keep the strongest entry per SSID, sorted by signal
+void WiFiManager::storeScan(int count) {
+    ScanNetwork found[SCAN_MAX_RESULTS];
+    size_t n = 0;
+
+    for (int i = 0; i < count; i++) {
+        String ssid = WiFi.SSID(i);
+        if (ssid.isEmpty()) continue;  // Hidden network
+        int8_t rssi = WiFi.RSSI(i);
+
+        size_t at = n;
+        for (size_t j = 0; j < n; j++) {
+            if (strcmp(found[j].ssid, ssid.c_str()) == 0) { at = j; break; }
+        }
+        if (at < n) {
+            if (rssi <= found[at].rssi) continue;
+            // Stronger duplicate: drop the old entry, reinsert below
+            memmove(&found[at], &found[at + 1], (n - at - 1) * sizeof(ScanNetwork));
+            n--;
+        }
+
+        size_t pos = 0;
+        while (pos < n && found[pos].rssi >= rssi) pos++;
+        if (pos >= SCAN_MAX_RESULTS) continue;
+        if (n == SCAN_MAX_RESULTS) n--;
+        memmove(&found[pos + 1], &found[pos], (n - pos) * sizeof(ScanNetwork));
+        strlcpy(found[pos].ssid, ssid.c_str(), sizeof(found[pos].ssid));
+        found[pos].rssi = rssi;
+        found[pos].secure = WiFi.encryptionType(i) != WIFI_AUTH_OPEN;
+        n++;
+    }
+
+    portENTER_CRITICAL(&_scanMux);
+    memcpy(_scanResults, found, n * sizeof(ScanNetwork));
+    _scanCount = n;
+    _scanAt = millis();
+    portEXIT_CRITICAL(&_scanMux);
+
+    Serial.printf("WiFi scan: %d networks\n", (int)n);
 }
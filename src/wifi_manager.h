@@ -4,13 +4,35 @@
 #include <WiFi.h>
 #include "settings.h"
 
+#define SCAN_MAX_RESULTS     20
+#define SCAN_FRESH_MS        10000   // Reuse results this recent instead of rescanning
+#define SCAN_MS_PER_CHANNEL  120     // Keep off-channel time short while connected
+
+#define FAST_CONNECT_TIMEOUT 2000    // Cached AP must associate within this, else full scan
+#define CONNECT_TIMEOUT      15000   // Give up on an association after this
+#define DHCP_TIMEOUT         15000   // ... and on DHCP after associating
+#define RETRY_MIN_MS         1000    // Backoff between failed attempts,
+#define RETRY_MAX_MS         60000   // doubling up to this
+
+struct ScanNetwork {
+    char ssid[33];
+    int8_t rssi;
+    bool secure;
+};
+
 enum WiFiState {
-    WIFI_STATE_DISCONNECTED,
+    WIFI_STATE_DISCONNECTED,    // Waiting to retry
     WIFI_STATE_CONNECTING,
     WIFI_STATE_CONNECTED,
     WIFI_STATE_AP_MODE
 };
 
+// Station connection driven by WiFi driver events.
+//
+// The event callback only records what happened; update() acts on it on
+// the main loop. A dropped link is retried with exponential backoff and
+// never falls back to the setup AP: that is only started for a device
+// with no network configured, or when the user asks for it.
 class WiFiManager {
 public:
     void begin(SettingsManager& settings);
@@ -23,12 +45,58 @@ public:
 
     void startAP();
     void startSTA();
-    void disconnect();
+
+    // Link statistics since boot
+    uint32_t getDisconnects() const { return _disconnects; }
+    uint32_t getReconnects() const { return _reconnects; }
+    unsigned long getDowntimeMs() const;     // Including a current outage
+    uint8_t getLastDisconnectReason() const { return _lastReason; }
+
+    // Network scan, run in the background by update(). Both calls are safe
+    // from other tasks (web handlers). Requests while a scan is running, or
+    // while the last results are still fresh, are folded into that scan.
+    void requestScan();
+    size_t getScanResults(ScanNetwork* out, size_t max,
+                          long& ageMs, bool& scanning);
 
 private:
     SettingsManager* _settings = nullptr;
     WiFiState _state = WIFI_STATE_DISCONNECTED;
     String _apName;
     unsigned long _connectStart = 0;
-    static const unsigned long CONNECT_TIMEOUT = 15000;
+    bool _fastConnect = false;      // Current attempt uses the cached link
+    unsigned long _associatedAt = 0; // 0 until the attempt associates
+    unsigned long _retryAt = 0;
+    unsigned long _backoff = 0;     // 0 until an attempt has failed
+
+    // Set by the event callback (WiFi task), consumed by update()
+    portMUX_TYPE _eventMux = portMUX_INITIALIZER_UNLOCKED;
+    bool _evAssociated = false;
+    bool _evGotIP = false;
+    bool _evLost = false;
+    uint8_t _evReason = 0;
+
+    bool _wasConnected = false;     // Connected at least once since boot
+    unsigned long _downSince = 0;   // 0 while up
+    unsigned long _downtimeMs = 0;
+    uint32_t _disconnects = 0;
+    uint32_t _reconnects = 0;
+    uint8_t _lastReason = 0;
+
+    portMUX_TYPE _scanMux = portMUX_INITIALIZER_UNLOCKED;
+    ScanNetwork _scanResults[SCAN_MAX_RESULTS];
+    size_t _scanCount = 0;
+    volatile unsigned long _scanAt = 0;     // millis() of the last results, 0 = none
+    volatile bool _scanRequested = false;
+    volatile bool _scanRunning = false;
+
+    void onEvent(arduino_event_id_t event, arduino_event_info_t info);
+    void connected();
+    void connectFailed();
+    void beginConnect(bool fast);
+    void configureIP();
+    void rememberLink();
+
+    void updateScan();
+    void storeScan(int count);
 };
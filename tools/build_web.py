@@ -0,0 +1,73 @@
+"""
+Build the web UI into the SPIFFS image.
+
+Gzips every file in web/ into data/www/ (uploaded with `pio run -t uploadfs`).
+CSS and JS get a content hash in their file name and the HTML pages are
+rewritten to match, so the device can serve them with a year-long
+Cache-Control and a changed asset is always fetched under a new URL.
+
+Runs automatically as a PlatformIO pre-script; it can also be run on its own:
+
+    python tools/build_web.py
+"""
+
+import gzip
+import hashlib
+import os
+import re
+import shutil
+
+HASHED_EXTS = (".css", ".js")
+
+
+def gzip_bytes(data):
+    # mtime=0 keeps the output (and so the device's ETags) reproducible
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def build(project_dir):
+    src = os.path.join(project_dir, "web")
+    out = os.path.join(project_dir, "data", "www")
+    if not os.path.isdir(src):
+        return
+
+    shutil.rmtree(out, ignore_errors=True)
+    os.makedirs(out)
+
+    names = sorted(os.listdir(src))
+    pages = [n for n in names if n.endswith(".html")]
+
+    renames = {}
+    for name in names:
+        if name in pages:
+            continue
+        with open(os.path.join(src, name), "rb") as f:
+            data = f.read()
+
+        target = name
+        stem, ext = os.path.splitext(name)
+        if ext in HASHED_EXTS:
+            target = "%s.%s%s" % (stem, hashlib.sha1(data).hexdigest()[:8], ext)
+            renames[name] = target
+
+        with open(os.path.join(out, target + ".gz"), "wb") as f:
+            f.write(gzip_bytes(data))
+
+    for name in pages:
+        with open(os.path.join(src, name), "r", encoding="utf-8") as f:
+            html = f.read()
+        for old, new in renames.items():
+            html = re.sub(r'(["\'])%s\1' % re.escape(old), r"\g<1>%s\1" % new, html)
+        with open(os.path.join(out, name + ".gz"), "wb") as f:
+            f.write(gzip_bytes(html.encode("utf-8")))
+
+    total = sum(os.path.getsize(os.path.join(out, n)) for n in os.listdir(out))
+    print("Web UI: %d files, %d bytes gzipped -> %s" % (len(os.listdir(out)), total, out))
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    build(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        build(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
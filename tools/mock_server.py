@@ -0,0 +1,468 @@
+"""
+Local stand-in for a TapeBackarr server.
+
+Serves the endpoints the monitor polls with a simulated tape library that
+keeps changing (jobs progress, tapes fill up and ask to be changed, LTFS
+formats run), and injects latency, errors, dropped connections and cut-off
+bodies on demand. Needs only the Python standard library.
+
+    python tools/mock_server.py [--port 8080] [--api-key KEY] [options]
+    python tools/mock_server.py --scenario tools/scenarios/soak.json
+
+Point the monitor's Server Host / Port at the machine running it. With
+--scenario the settings change phase by phase as the file says; a summary
+of every phase is printed when it ends, and the run fails if a phase that
+expects the monitor to poll got no requests from it. GET /mock/status
+returns the current phase and counters as JSON.
+"""
+
+import argparse
+import json
+import random
+import socket
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+ENDPOINTS = {
+    "/api/v1/health": "health",
+    "/api/v1/dashboard": "dashboard",
+    "/api/v1/jobs/active": "jobs",
+    "/api/v1/drives": "drives",
+    "/api/v1/events": "events",
+    "/api/v1/ltfs/format/status": "ltfs_format",
+}
+
+# Settings a scenario phase may change, with their defaults
+DEFAULTS = {
+    "latency_ms": 0,       # Added to every answer
+    "jitter_ms": 0,        # Plus uniform random 0..jitter_ms
+    "error_rate": 0.0,     # Answered with HTTP 500
+    "drop_rate": 0.0,      # Connection closed without an answer
+    "truncate_rate": 0.0,  # Body cut off halfway (invalid JSON)
+    "stall_rate": 0.0,     # Held for stall_ms, longer than the monitor waits
+    "stall_ms": 15000,
+    "jobs": 2,             # Jobs running at once
+    "drives": 2,
+    "events": 20,          # Background events in the log
+    "time_scale": 60.0,    # Simulated seconds per real second
+    "expect_requests": True,
+}
+
+TAPE_CAPACITY = 18000000000000      # LTO-9
+EPOCH = 1748822400                  # Simulated time 0: 2025-06-02 00:00 UTC
+LTFS_PHASES = ["formatting", "verifying", "mounting", "labeling", "finalizing"]
+
+
+def timestamp(clock):
+    return time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime(EPOCH + clock))
+
+
+class Library:
+    """A tape library that moves on with (scaled) time."""
+
+    def __init__(self, rng):
+        self.rng = rng
+        self.clock = 0.0            # Simulated seconds
+        self.next_id = 1
+        self.next_tape = 100
+        self.jobs = []
+        self.drives = []
+        self.events = []
+        self.pending_changes = []   # (event, simulated time it gets resolved)
+        self.ltfs = None
+        self.ltfs_next = 600.0
+        self.completed_jobs = 0
+
+    def _id(self):
+        self.next_id += 1
+        return self.next_id
+
+    def _tape(self):
+        self.next_tape += 1
+        return "LTO9-%06d" % self.next_tape
+
+    def resize(self, jobs, drives, events):
+        while len(self.drives) < drives:
+            n = len(self.drives) + 1
+            self.drives.append({
+                "id": n, "display_name": "Drive %d" % n, "vendor": "IBM",
+                "model": "ULT3580-HH9", "serial_number": "10WT%06d" % n,
+                "device_path": "/dev/nst%d" % (n - 1), "status": "ready",
+                "current_tape": self._tape(), "format_type": "ltfs" if n % 2 else "raw",
+                "enabled": True, "last_cleaned": None,
+                "created_at": "2024-11-02T10:12:00Z",
+            })
+        del self.drives[drives:]
+        self.target_jobs = jobs
+        while len(self.jobs) < jobs:
+            self._start_job()
+        del self.jobs[jobs:]
+        background = [e for e in self.events if e["type"] == "job_progress"]
+        while len(background) < events:
+            e = self._event("job_progress", "info", 0, "Progress update")
+            background.append(e)
+        self.max_events = max(events, 50)
+        self._trim_events()
+
+    def _start_job(self):
+        job_id = self._id()
+        total = self.rng.randint(1, 30) * 1099511627776
+        self.jobs.append({
+            "job_id": job_id, "job_name": "backup-%d" % job_id,
+            "phase": "initializing", "status": "running", "message": "",
+            "file_count": 0, "total_files": self.rng.randint(1000, 500000),
+            "total_bytes": total, "bytes_written": 0,
+            "write_speed": 0.0, "tape_label": self._tape(),
+            "tape_capacity_bytes": TAPE_CAPACITY,
+            "tape_used_bytes": self.rng.randint(0, TAPE_CAPACITY // 2),
+            "estimated_seconds_remaining": 0.0,
+            "tape_estimated_seconds_remaining": 0.0,
+            "start_time": timestamp(self.clock),
+            "scan_files_found": 0, "scan_dirs_scanned": 0, "scan_bytes_found": 0,
+            "_phase_time": 0.0,
+            "_waiting_tape": False,
+        })
+        self._event("job_started", "info", 0, "Job %d started" % job_id)
+
+    def _event(self, kind, status, tape_id, message):
+        e = {"id": self._id(), "type": kind, "status": status, "tape_id": tape_id,
+             "message": message, "created_at": timestamp(self.clock)}
+        self.events.append(e)
+        return e
+
+    def _trim_events(self):
+        # Keep unresolved tape changes, drop the oldest of the rest
+        pending = [c[0] for c in self.pending_changes]
+        while len(self.events) > self.max_events + len(pending):
+            for i, e in enumerate(self.events):
+                if e not in pending:
+                    del self.events[i]
+                    break
+
+    def advance(self, dt):
+        self.clock += dt
+        for job in list(self.jobs):
+            self._advance_job(job, dt)
+
+        # The operator swaps the tape a while after being asked
+        for change in list(self.pending_changes):
+            event, due = change
+            if self.clock >= due:
+                self.pending_changes.remove(change)
+                self.events.remove(event)
+                for job in self.jobs:
+                    if job["_waiting_tape"]:
+                        job["_waiting_tape"] = False
+                        job["tape_label"] = self._tape()
+                        job["tape_used_bytes"] = 0
+                        break
+
+        # An LTFS format every now and then
+        if self.ltfs is None and self.clock >= self.ltfs_next:
+            device = self.rng.choice(self.drives)["device_path"] if self.drives else "/dev/nst0"
+            self.ltfs = {"started": self.clock, "device": device}
+        if self.ltfs is not None and self.clock - self.ltfs["started"] > 900:
+            self.ltfs = None
+            self.ltfs_next = self.clock + self.rng.uniform(1800, 7200)
+
+        self._trim_events()
+
+    def _advance_job(self, job, dt):
+        job["_phase_time"] += dt
+        phase = job["phase"]
+        if phase == "initializing" and job["_phase_time"] > 30:
+            self._set_phase(job, "scanning")
+        elif phase == "scanning":
+            job["scan_files_found"] = min(job["total_files"], job["scan_files_found"] + int(dt * 400))
+            job["scan_dirs_scanned"] = job["scan_files_found"] // 25
+            job["scan_bytes_found"] = job["total_bytes"] * job["scan_files_found"] // job["total_files"]
+            if job["scan_files_found"] >= job["total_files"]:
+                self._set_phase(job, "streaming")
+        elif phase == "streaming":
+            if job["_waiting_tape"]:
+                job["write_speed"] = 0.0
+                return
+            speed = self.rng.uniform(250e6, 400e6)
+            step = int(speed * dt)
+            room = job["tape_capacity_bytes"] - job["tape_used_bytes"]
+            step = min(step, room, job["total_bytes"] - job["bytes_written"])
+            job["write_speed"] = speed
+            job["bytes_written"] += step
+            job["tape_used_bytes"] += step
+            job["file_count"] = job["total_files"] * job["bytes_written"] // job["total_bytes"]
+            left = job["total_bytes"] - job["bytes_written"]
+            job["estimated_seconds_remaining"] = left / speed
+            job["tape_estimated_seconds_remaining"] = (job["tape_capacity_bytes"] - job["tape_used_bytes"]) / speed
+            if left <= 0:
+                self._set_phase(job, "cataloging")
+            elif job["tape_used_bytes"] >= job["tape_capacity_bytes"]:
+                job["_waiting_tape"] = True
+                kind = "tape_full" if self.rng.random() < 0.5 else "tape_change_required"
+                event = self._event(kind, "pending", self.next_tape,
+                                    "%s is full, insert the next tape" % job["tape_label"])
+                self.pending_changes.append((event, self.clock + self.rng.uniform(120, 900)))
+        elif phase == "cataloging" and job["_phase_time"] > 60:
+            self.jobs.remove(job)
+            self.completed_jobs += 1
+            self._event("job_completed", "info", 0, "Job %d completed" % job["job_id"])
+            if len(self.jobs) < self.target_jobs:
+                self._start_job()
+
+    def _set_phase(self, job, phase):
+        job["phase"] = phase
+        job["_phase_time"] = 0.0
+
+    def dashboard(self):
+        return {
+            "total_tapes": self.next_tape - 100,
+            "active_tapes": len(self.drives),
+            "total_jobs": len(self.jobs) + self.completed_jobs,
+            "running_jobs": len(self.jobs),
+            "drive_status": "online" if self.drives else None,
+            "pool_storage": [{
+                "pool_id": 1, "name": "Default", "tape_count": self.next_tape - 100,
+                "total_capacity_bytes": (self.next_tape - 100) * TAPE_CAPACITY,
+                "total_used_bytes": sum(j["tape_used_bytes"] for j in self.jobs)
+                                    + self.completed_jobs * TAPE_CAPACITY // 2,
+            }],
+        }
+
+    def drives_view(self):
+        busy = {}
+        for i, job in enumerate(self.jobs):
+            if job["phase"] == "streaming" and self.drives:
+                busy[i % len(self.drives)] = job["tape_label"]
+        out = []
+        for i, d in enumerate(self.drives):
+            d = dict(d)
+            if i in busy:
+                d["status"] = "busy"
+                d["current_tape"] = busy[i]
+            out.append(d)
+        return out
+
+    def ltfs_view(self):
+        if self.ltfs is None:
+            return {"active": False, "phase": "", "device_path": "", "progress_pct": 0,
+                    "elapsed_seconds": 0, "error": ""}
+        elapsed = self.clock - self.ltfs["started"]
+        pct = min(100, int(elapsed * 100 / 900))
+        return {"active": True, "phase": LTFS_PHASES[min(4, pct // 20)],
+                "device_path": self.ltfs["device"], "tape_label": "LTO9-%06d" % self.next_tape,
+                "progress_pct": pct, "elapsed_seconds": int(elapsed), "error": ""}
+
+    def body(self, endpoint):
+        if endpoint == "health":
+            return {"status": "ok"}
+        if endpoint == "dashboard":
+            return self.dashboard()
+        if endpoint == "jobs":
+            return [{k: v for k, v in j.items() if not k.startswith("_")} for j in self.jobs]
+        if endpoint == "drives":
+            return self.drives_view()
+        if endpoint == "events":
+            return self.events
+        return self.ltfs_view()
+
+
+class PhaseStats:
+    def __init__(self, name):
+        self.name = name
+        self.started = time.time()
+        self.requests = {name: 0 for name in ENDPOINTS.values()}
+        self.faults = {"error": 0, "drop": 0, "truncate": 0, "stall": 0, "unauthorized": 0}
+        self.clients = set()
+
+    def as_dict(self):
+        return {"phase": self.name, "elapsed_s": round(time.time() - self.started, 1),
+                "requests": self.requests, "faults": self.faults,
+                "clients": sorted(self.clients)}
+
+    def summary(self):
+        total = sum(self.requests.values())
+        faults = ", ".join("%s %d" % kv for kv in self.faults.items() if kv[1]) or "none"
+        return "%-12s %5.0f s  %5d requests from %d client(s)  faults: %s" % (
+            self.name, time.time() - self.started, total, len(self.clients), faults)
+
+
+class MockServer:
+    def __init__(self, settings, api_key, seed):
+        self.lock = threading.Lock()
+        self.rng = random.Random(seed)
+        self.settings = dict(DEFAULTS)
+        self.settings.update(settings)
+        self.api_key = api_key
+        self.library = Library(self.rng)
+        self.library.resize(self.settings["jobs"], self.settings["drives"], self.settings["events"])
+        self.last_tick = time.time()
+        self.stats = PhaseStats("default")
+        self.history = []
+
+    def apply(self, name, settings):
+        with self.lock:
+            self._tick()
+            self.history.append(self.stats)
+            self.stats = PhaseStats(name)
+            self.settings = dict(DEFAULTS)
+            self.settings.update(settings)
+            self.library.resize(self.settings["jobs"], self.settings["drives"], self.settings["events"])
+
+    def _tick(self):
+        now = time.time()
+        self.library.advance((now - self.last_tick) * self.settings["time_scale"])
+        self.last_tick = now
+
+    def plan(self, endpoint, client):
+        """Decide what one request gets: (fault or None, delay s, body bytes)."""
+        with self.lock:
+            self._tick()
+            s = self.settings
+            self.stats.requests[endpoint] += 1
+            self.stats.clients.add(client)
+            delay = (s["latency_ms"] + self.rng.uniform(0, s["jitter_ms"])) / 1000.0
+
+            fault = None
+            roll = self.rng.random()
+            for name in ("drop", "error", "truncate", "stall"):
+                rate = s[name + "_rate"]
+                if roll < rate:
+                    fault = name
+                    break
+                roll -= rate
+            if fault:
+                self.stats.faults[fault] += 1
+            if fault == "stall":
+                delay += s["stall_ms"] / 1000.0
+
+            body = json.dumps(self.library.body(endpoint), separators=(",", ":")).encode()
+            return fault, delay, body
+
+    def unauthorized(self):
+        with self.lock:
+            self.stats.faults["unauthorized"] += 1
+
+    def status(self):
+        with self.lock:
+            out = self.stats.as_dict()
+            out["settings"] = self.settings
+            return json.dumps(out).encode()
+
+
+def make_handler(mock, verbose):
+    class Handler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"
+
+        def log_message(self, fmt, *args):
+            if verbose:
+                sys.stderr.write("%s %s\n" % (self.address_string(), fmt % args))
+
+        def send_body(self, code, body):
+            self.send_response(code)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def do_GET(self):
+            path = self.path.split("?")[0]
+            if path == "/mock/status":
+                self.send_body(200, mock.status())
+                return
+            endpoint = ENDPOINTS.get(path)
+            if endpoint is None:
+                self.send_body(404, b'{"error":"not found"}')
+                return
+            if mock.api_key and self.headers.get("X-API-Key") != mock.api_key:
+                mock.unauthorized()
+                self.send_body(401, b'{"error":"invalid API key"}')
+                return
+
+            fault, delay, body = mock.plan(endpoint, self.client_address[0])
+            if delay:
+                time.sleep(delay)
+            if fault == "drop":
+                self.close_connection = True
+                self.connection.shutdown(socket.SHUT_RDWR)
+                return
+            if fault == "error":
+                self.send_body(500, b'{"error":"internal error"}')
+                return
+            if fault == "truncate":
+                # Headers promise the whole body, half of it arrives
+                self.send_response(200)
+                self.send_header("Content-Type", "application/json")
+                self.send_header("Content-Length", str(len(body)))
+                self.end_headers()
+                self.wfile.write(body[:len(body) // 2])
+                self.close_connection = True
+                return
+            try:
+                self.send_body(200, body)
+            except (BrokenPipeError, ConnectionResetError):
+                pass    # The monitor gave up waiting (stall)
+
+    return Handler
+
+
+def run_scenario(mock, scenario):
+    """Step through the phases; returns the number of failed checks."""
+    failures = 0
+    rounds = scenario.get("repeat", 1)
+    for n in range(rounds):
+        for phase in scenario["phases"]:
+            name = phase.get("name", "phase")
+            settings = {k: v for k, v in phase.items() if k in DEFAULTS}
+            mock.apply(name, settings)
+            print("[%s] %s for %d s" % (scenario.get("name", "scenario"), name, phase["duration_s"]),
+                  flush=True)
+            time.sleep(phase["duration_s"])
+
+            stats = mock.stats
+            print("  " + stats.summary(), flush=True)
+            if mock.settings["expect_requests"] and sum(stats.requests.values()) == 0:
+                print("  FAIL: no requests during %s" % name, flush=True)
+                failures += 1
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0].strip())
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--api-key", default="", help="require this X-API-Key (default: any)")
+    parser.add_argument("--scenario", help="JSON file of phases, see tools/scenarios/")
+    parser.add_argument("--seed", type=int, default=1, help="random seed, for repeatable runs")
+    parser.add_argument("--verbose", action="store_true", help="log every request")
+    for key, value in DEFAULTS.items():
+        if isinstance(value, bool):
+            continue
+        parser.add_argument("--" + key.replace("_", "-"), type=type(value), default=value)
+    args = parser.parse_args()
+
+    settings = {k: getattr(args, k) for k in DEFAULTS if not isinstance(DEFAULTS[k], bool)}
+    mock = MockServer(settings, args.api_key, args.seed)
+    server = ThreadingHTTPServer((args.host, args.port), make_handler(mock, args.verbose))
+    server.daemon_threads = True
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    print("Mock TapeBackarr on http://%s:%d" % (args.host, args.port), flush=True)
+
+    try:
+        if args.scenario:
+            with open(args.scenario) as f:
+                scenario = json.load(f)
+            failures = run_scenario(mock, scenario)
+            print("%s: %s" % (scenario.get("name", "scenario"),
+                              "%d check(s) failed" % failures if failures else "passed"))
+            return 1 if failures else 0
+        while True:
+            time.sleep(3600)
+    except KeyboardInterrupt:
+        return 0
+    finally:
+        server.shutdown()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
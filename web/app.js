@@ -0,0 +1,175 @@
+// TapeBackarr CYD setup page. The page itself is static (and cached); the
+// current settings and status come from /config and /status.
+
+function $(id) { return document.getElementById(id); }
+
+function dot(ok, text) {
+  var s = document.createElement('span');
+  s.className = 'dot ' + (ok ? 'green' : 'red');
+  var f = document.createDocumentFragment();
+  f.appendChild(s);
+  f.appendChild(document.createTextNode(text));
+  return f;
+}
+
+function setVal(id, node) {
+  var el = $(id);
+  el.textContent = '';
+  el.appendChild(typeof node === 'string' ? document.createTextNode(node) : node);
+}
+
+function loadConfig() {
+  fetch('/config').then(function (r) { return r.json(); }).then(function (cfg) {
+    var form = $('config');
+    Object.keys(cfg).forEach(function (name) {
+      var input = form.elements[name];
+      if (!input) return;
+      if (input.type === 'checkbox') input.checked = !!cfg[name];
+      else input.value = cfg[name];
+    });
+  });
+}
+
+function loadStatus() {
+  fetch('/status').then(function (r) { return r.json(); }).then(function (st) {
+    var connected = st.wifi_state === 2;  // WIFI_STATE_CONNECTED
+    setVal('st_wifi', dot(connected, connected ? 'Connected' : 'Disconnected'));
+    setVal('st_ip', st.wifi_ip);
+    setVal('st_api', dot(st.api_connected, st.api_connected ? 'OK' : 'N/A'));
+    setVal('st_heap', String(Math.floor(st.heap / 1024)));
+    setVal('st_block', String(Math.floor(st.heap_largest / 1024)));
+    setVal('st_current', String(Math.round(st.avg_current_ma)));
+
+    var c = st.capture;
+    setVal('cap_state', c.replaying ? (c.replay_done ? 'Replay finished' : 'Replaying a capture')
+      : (c.active ? 'Recording' : c.full ? 'Stopped: full' : 'Idle') +
+        ' \u2013 ' + c.records + ' answers, ' + kb(c.bytes));
+  });
+}
+
+function kb(bytes) {
+  return bytes >= 10485760 ? Math.round(bytes / 1048576) + ' MB'
+                           : Math.round(bytes / 1024) + ' KB';
+}
+
+function tableRows(body, rows) {
+  body.textContent = '';
+  rows.forEach(function (cells) {
+    var tr = document.createElement('tr');
+    cells.forEach(function (c) {
+      var td = document.createElement('td');
+      td.textContent = c;
+      tr.appendChild(td);
+    });
+    body.appendChild(tr);
+  });
+}
+
+// /heap: one sample per interval_s; a free heap that keeps falling is a
+// leak, a largest block falling away from it is fragmentation
+function loadHeap() {
+  fetch('/heap').then(function (r) { return r.json(); }).then(function (h) {
+    var pts = h.history.concat([{ t: null, free: h.free, largest: h.largest,
+                                  min_free: h.min_free }]);
+    var top = Math.max.apply(null, pts.map(function (p) { return p.free; })) || 1;
+    var svg = $('heap_chart');
+    svg.textContent = '';
+    ['free', 'largest', 'min_free'].forEach(function (field) {
+      var line = document.createElementNS('http://www.w3.org/2000/svg', 'polyline');
+      line.setAttribute('class', field);
+      line.setAttribute('points', pts.map(function (p, i) {
+        var x = pts.length > 1 ? i * 300 / (pts.length - 1) : 300;
+        return x.toFixed(1) + ',' + (80 - p[field] * 76 / top).toFixed(1);
+      }).join(' '));
+      svg.appendChild(line);
+    });
+    $('heap_span').textContent = h.history.length
+      ? '(last ' + Math.round(h.history.length * h.interval_s / 3600 * 10) / 10 + ' h)' : '';
+
+    tableRows($('heap_subsystems'), h.subsystems.map(function (s) {
+      return [s.name, String(s.allocs), kb(s.bytes), String(s.failures)];
+    }));
+    tableRows($('heap_stacks'), h.stacks.map(function (s) {
+      return [s.task, s.free + ' B'];
+    }));
+  });
+}
+
+// /scan answers at once from the device's cache and starts a background
+// scan if the cache is stale; poll until that scan is done
+function scanWiFi(tries) {
+  tries = tries || 0;
+  var list = $('networks');
+  if (!tries) list.innerHTML = '<p style="color:#888">Scanning...</p>';
+  fetch('/scan').then(function (r) { return r.json(); }).then(function (res) {
+    list.textContent = '';
+    res.networks.forEach(function (n) {
+      var item = document.createElement('div');
+      item.className = 'net-item';
+      var name = document.createElement('span');
+      name.textContent = n.ssid + (n.secure ? ' 🔒' : '');
+      var sig = document.createElement('span');
+      sig.style.color = '#888';
+      sig.textContent = (n.rssi > -50 ? 'Strong' : n.rssi > -70 ? 'Good' : 'Weak') +
+                        ' (' + n.rssi + ')';
+      item.appendChild(name);
+      item.appendChild(sig);
+      item.onclick = function () { $('wifi_ssid').value = n.ssid; };
+      list.appendChild(item);
+    });
+    if (res.scanning && tries < 15) {
+      list.insertAdjacentHTML('afterbegin', '<p style="color:#888">Scanning...</p>');
+      setTimeout(function () { scanWiFi(tries + 1); }, 1000);
+    } else if (!res.networks.length) {
+      list.innerHTML = '<p style="color:#888">No networks found</p>';
+    }
+  }).catch(function () {
+    list.innerHTML = '<p style="color:#f44">Scan failed</p>';
+  });
+}
+
+// Same for /servers, which browses mDNS for TapeBackarr servers
+function findServers(tries) {
+  tries = tries || 0;
+  var list = $('servers');
+  if (!tries) list.innerHTML = '<p style="color:#888">Searching...</p>';
+  fetch('/servers').then(function (r) { return r.json(); }).then(function (res) {
+    list.textContent = '';
+    res.servers.forEach(function (s) {
+      var host = s.host || s.ip;
+      var item = document.createElement('div');
+      item.className = 'net-item';
+      var name = document.createElement('span');
+      name.textContent = s.name || host;
+      var addr = document.createElement('span');
+      addr.style.color = '#888';
+      addr.textContent = host + ':' + s.port;
+      item.appendChild(name);
+      item.appendChild(addr);
+      item.onclick = function () {
+        $('srv_host').value = host;
+        $('srv_port').value = s.port;
+      };
+      list.appendChild(item);
+    });
+    if (res.browsing && tries < 15) {
+      list.insertAdjacentHTML('afterbegin', '<p style="color:#888">Searching...</p>');
+      setTimeout(function () { findServers(tries + 1); }, 1000);
+    } else if (!res.servers.length) {
+      list.innerHTML = '<p style="color:#888">No servers found</p>';
+    }
+  }).catch(function () {
+    list.innerHTML = '<p style="color:#f44">Search failed</p>';
+  });
+}
+
+$('scan').onclick = function () { scanWiFi(0); };
+$('find').onclick = function () { findServers(0); };
+$('reset').onsubmit = function () { return confirm('Reset all settings?'); };
+if (location.search.indexOf('saved') >= 0) $('saved').classList.remove('hidden');
+
+loadConfig();
+loadStatus();
+loadHeap();
+setInterval(loadStatus, 5000);
+setInterval(loadHeap, 60000);
@@ -0,0 +1,150 @@
+// Live view. The monitor pushes its poll results over /ws: the full
+// snapshot when we connect, then only the sections that changed. Falls
+// back to polling /snapshot if the WebSocket cannot be opened.
+
+var state = {};
+var seq = 0;
+
+function $(id) { return document.getElementById(id); }
+
+function el(tag, cls, text) {
+  var e = document.createElement(tag);
+  if (cls) e.className = cls;
+  if (text !== undefined) e.textContent = text;
+  return e;
+}
+
+function bytes(n) {
+  var units = ['B', 'KB', 'MB', 'GB', 'TB', 'PB'];
+  var i = 0;
+  while (n >= 1024 && i < units.length - 1) { n /= 1024; i++; }
+  return (i ? n.toFixed(1) : n) + ' ' + units[i];
+}
+
+function duration(s) {
+  if (!s || s < 0) return '';
+  var h = Math.floor(s / 3600), m = Math.floor(s % 3600 / 60);
+  return h ? h + 'h ' + m + 'm' : m + 'm';
+}
+
+function bar(pct) {
+  var b = el('div', 'bar'), f = el('div');
+  f.style.width = Math.max(0, Math.min(100, pct)) + '%';
+  b.appendChild(f);
+  return b;
+}
+
+function renderDashboard(d) {
+  if (!d) return;
+  $('d_tapes').textContent = d.tapes;
+  $('d_active_jobs').textContent = d.active_jobs;
+  $('d_drives').textContent = d.drives;
+  $('d_used').textContent = d.capacity ? Math.round(100 * d.used / d.capacity) + '%' : '–';
+}
+
+function renderJobs(jobs) {
+  var box = $('jobs');
+  box.textContent = '';
+  if (!jobs || !jobs.length) { box.appendChild(el('p', 'muted', 'No active jobs')); return; }
+  jobs.forEach(function (j) {
+    var row = el('div', 'job');
+    row.appendChild(el('div', null, j.name + ' — ' + j.phase));
+    if (j.phase === 'scanning') {
+      row.appendChild(el('div', 'meta', j.scan_files + ' files in ' + j.scan_dirs +
+                         ' dirs, ' + bytes(j.scan_bytes)));
+    } else {
+      row.appendChild(bar(j.total_bytes ? 100 * j.bytes / j.total_bytes : 0));
+      row.appendChild(el('div', 'meta', bytes(j.bytes) + ' of ' + bytes(j.total_bytes) +
+                         ' · ' + bytes(j.speed) + '/s · ' + j.files + '/' + j.total_files +
+                         ' files' + (j.eta ? ' · ' + duration(j.eta) + ' left' : '')));
+    }
+    if (j.tape) {
+      row.appendChild(el('div', 'meta', 'Tape ' + j.tape + ': ' + bytes(j.tape_used) +
+                         ' of ' + bytes(j.tape_capacity)));
+    }
+    box.appendChild(row);
+  });
+}
+
+function renderDrives(drives) {
+  var box = $('drives');
+  box.textContent = '';
+  if (!drives || !drives.length) { box.appendChild(el('p', 'muted', 'No drives')); return; }
+  drives.forEach(function (d) {
+    var row = el('div', 'drive');
+    var ok = d.status === 'ready' || d.status === 'busy';
+    var head = el('div');
+    head.appendChild(el('span', 'dot ' + (ok ? 'green' : d.status === 'offline' ? 'orange' : 'red')));
+    head.appendChild(document.createTextNode(d.name + ' — ' + d.status));
+    row.appendChild(head);
+    row.appendChild(el('div', 'meta', d.vendor + ' ' + d.model + ' · ' + d.path +
+                       ' · Tape: ' + (d.tape || 'none') + (d.format ? ' (' + d.format + ')' : '')));
+    box.appendChild(row);
+  });
+}
+
+function renderAlerts(changes) {
+  var a = $('alert');
+  if (changes && changes.length) {
+    a.textContent = 'Tape change needed: ' + changes[0].reason.replace('_', ' ');
+    a.classList.remove('hidden');
+  } else {
+    a.classList.add('hidden');
+  }
+}
+
+function renderLtfs(l) {
+  var card = $('ltfs_card');
+  if (!l || !l.active) { card.classList.add('hidden'); return; }
+  card.classList.remove('hidden');
+  var box = $('ltfs');
+  box.textContent = '';
+  box.appendChild(el('div', null, l.phase + ' on ' + l.path));
+  box.appendChild(bar(l.pct));
+  box.appendChild(el('div', 'meta', l.pct + '% · ' + duration(l.elapsed) + ' elapsed'));
+}
+
+var RENDER = {
+  dashboard: renderDashboard,
+  jobs: renderJobs,
+  drives: renderDrives,
+  tape_changes: renderAlerts,
+  ltfs: renderLtfs
+};
+
+function apply(msg) {
+  if (!msg.full && msg.seq <= seq) return;  // Stale or duplicate
+  seq = msg.seq;
+  Object.keys(RENDER).forEach(function (k) {
+    if (k in msg) {
+      state[k] = msg[k];
+      RENDER[k](state[k]);
+    }
+  });
+}
+
+function poll() {
+  fetch('/snapshot').then(function (r) { return r.json(); }).then(apply)
+    .catch(function () {});
+}
+
+var retry = 1000;
+var pollTimer = null;
+
+function connect() {
+  var ws = new WebSocket('ws://' + location.host + '/ws');
+  ws.onopen = function () {
+    retry = 1000;
+    $('conn').textContent = 'live';
+    if (pollTimer) { clearInterval(pollTimer); pollTimer = null; }
+  };
+  ws.onmessage = function (e) { apply(JSON.parse(e.data)); };
+  ws.onclose = function () {
+    $('conn').textContent = 'reconnecting…';
+    if (!pollTimer) { poll(); pollTimer = setInterval(poll, 5000); }
+    setTimeout(connect, retry);
+    retry = Math.min(retry * 2, 30000);
+  };
+}
+
+connect();